@@ -0,0 +1,105 @@
+#pragma once
+
+#include "rig.h"
+#include "core/json.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace bench {
+
+    // keeps the compiler from discarding work whose result nothing else reads.
+
+    inline volatile double sink = 0.0;
+
+    inline void keep(double value) {
+        sink = sink + value;
+    }
+
+    // the mean time of a run of the body, in milliseconds, over the given number of runs
+    // after one run to warm up.
+
+    template <typename F>
+    double time_ms(int runs, F&& body) {
+        body();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i) {
+            body();
+        }
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return elapsed.count() / runs;
+    }
+
+    // the time of a single run of the body, for work that cannot be repeated.
+
+    template <typename F>
+    double time_once(F&& body) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    inline void report(std::string_view what, double ms) {
+        std::printf("%-56.*s %12.3f ms\n", static_cast<int>(what.size()), what.data(), ms);
+    }
+
+    inline void report_size(std::string_view what, size_t bytes) {
+        std::printf("%-56.*s %12.1f KB\n", static_cast<int>(what.size()), what.data(),
+            bytes / 1024.0);
+    }
+
+    inline void report_count(std::string_view what, uint64_t count) {
+        std::printf("%-56.*s %12llu\n", static_cast<int>(what.size()), what.data(),
+            static_cast<unsigned long long>(count));
+    }
+
+    // how random_project_json() fills a project: the number of tabs, the skeletons on each,
+    // the bones in each skeleton, and how far apart the skeletons are laid out.
+
+    struct project_layout {
+        int tabs;
+        int skeletons_per_tab;
+        int bones_per_skeleton;
+        double spacing;
+    };
+
+    // a project of random trees, on each tab laid out on a square grid centered on the
+    // origin, as the JSON it would be saved as. The tabs are named "tab-0", "tab-1", etc.
+
+    inline std::string random_project_json(const project_layout& layout, std::mt19937& rng) {
+        sm::world world;
+        auto tabs = nlohmann::json::array();
+        auto columns = static_cast<int>(std::ceil(std::sqrt(layout.skeletons_per_tab)));
+        auto offset = -layout.spacing * (columns - 1) / 2.0;
+        for (int tab = 0; tab < layout.tabs; ++tab) {
+            auto names = nlohmann::json::array();
+            for (int i = 0; i < layout.skeletons_per_tab; ++i) {
+                sm::point origin{
+                    offset + (i % columns) * layout.spacing,
+                    offset + (i / columns) * layout.spacing
+                };
+                auto bones = test::random_tree(world, origin, layout.bones_per_skeleton, rng);
+                names.push_back(bones.front()->owner().name());
+            }
+            tabs.push_back(
+                nlohmann::json{ {"tab", "tab-" + std::to_string(tab)}, {"skeletons", names} }
+            );
+        }
+        nlohmann::json project = {
+            {"version", 0.0},
+            {"tabs", tabs},
+            {"world", world.to_json()}
+        };
+        return project.dump();
+    }
+}
@@ -0,0 +1,100 @@
+#include "bench.h"
+#include "core/sm_animation.h"
+#include <algorithm>
+#include <string>
+#include <variant>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_event_count = 100000;
+    constexpr int k_duration = 36000;
+    constexpr int k_query_count = 2000;
+
+    sm::animation random_animation(std::mt19937& rng) {
+        sm::animation anim("benchmark");
+        for (int i = 0; i < k_event_count; ++i) {
+            auto start = static_cast<int>(rng() % k_duration);
+            auto duration = static_cast<int>(rng() % 120);
+            anim.insert(start, sm::rotation{ "node", "bone", 0.1, duration });
+        }
+        return anim;
+    }
+
+    // what a range query cost before the index: a walk of the timeline up to t1 checking
+    // each event's interval.
+
+    size_t scan_events_in(const sm::animation& anim, int t0, int t1) {
+        size_t found = 0;
+        for (const auto& [start, events] : anim.timeline()) {
+            if (start >= t1) {
+                break;
+            }
+            for (const auto& event : events) {
+                auto duration = std::visit([](const auto& e) { return e.duration; }, event);
+                if (start + std::max(duration, 1) > t0) {
+                    ++found;
+                }
+            }
+        }
+        return found;
+    }
+}
+
+int main() {
+    std::mt19937 rng(47);
+    auto anim = random_animation(rng);
+
+    std::vector<int> times(k_query_count);
+    for (auto& t : times) {
+        t = static_cast<int>(rng() % k_duration);
+    }
+
+    auto build = bench::time_ms(5,
+        [&]() {
+            auto copy = anim;
+            bench::keep(static_cast<double>(copy.events_at(0).size()));
+        }
+    );
+    bench::report("copy and index 100k events", build);
+
+    auto indexed_at = bench::time_ms(5,
+        [&]() {
+            for (auto t : times) {
+                bench::keep(static_cast<double>(anim.events_at(t).size()));
+            }
+        }
+    );
+    auto scanned_at = bench::time_ms(1,
+        [&]() {
+            for (auto t : times) {
+                bench::keep(static_cast<double>(scan_events_in(anim, t, t + 1)));
+            }
+        }
+    );
+    bench::report("events_at x2000, indexed", indexed_at);
+    bench::report("events_at x2000, timeline scan", scanned_at);
+
+    for (int window : { 30, 600 }) {
+        auto indexed_in = bench::time_ms(5,
+            [&]() {
+                for (auto t : times) {
+                    bench::keep(static_cast<double>(anim.events_in(t, t + window).size()));
+                }
+            }
+        );
+        auto scanned_in = bench::time_ms(1,
+            [&]() {
+                for (auto t : times) {
+                    bench::keep(static_cast<double>(scan_events_in(anim, t, t + window)));
+                }
+            }
+        );
+        auto ticks = std::to_string(window);
+        bench::report("events_in " + ticks + " ticks x2000, indexed", indexed_in);
+        bench::report("events_in " + ticks + " ticks x2000, timeline scan", scanned_in);
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "bench.h"
+#include "core/sm_bake.h"
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    // ten minutes at 30 ticks a second.
+    constexpr int k_bone_count = 500;
+    constexpr int k_duration = 18000;
+
+    // rotations of random bones about their parent nodes, some number starting every so
+    // many ticks, with the whole skeleton drifting for the length of the timeline.
+
+    sm::animation random_animation(const test::rig& r, int every, int count,
+            std::mt19937& rng) {
+        sm::animation anim("benchmark");
+        anim.insert(0, sm::translation{ r.skel->root_node().name(), { 200.0, 50.0 },
+            k_duration });
+        for (int t = 0; t < k_duration; t += every) {
+            for (int i = 0; i < count; ++i) {
+                const auto& bone = *r.bones[rng() % r.bones.size()];
+                anim.insert(t, sm::rotation{ bone.parent_node().name(), bone.name(), 0.3,
+                    static_cast<int>(rng() % 90) });
+            }
+        }
+        return anim;
+    }
+
+    double checksum(const std::vector<sm::point>& pose) {
+        return std::accumulate(pose.begin(), pose.end(), 0.0,
+            [](double sum, const sm::point& pt) { return sum + pt.x + pt.y; });
+    }
+
+    // the memory an animation's events take as an sm::animation: a map node per start time
+    // holding a vector of events, plus the heap storage of any names too long to be stored
+    // in their strings.
+
+    size_t events_size(const sm::animation& anim) {
+        constexpr size_t k_map_node_overhead = 4 * sizeof(void*);
+        auto heap_size = [](const std::string& str) -> size_t {
+            return (str.capacity() > std::string().capacity()) ? str.capacity() + 1 : 0;
+        };
+        size_t size = sizeof(anim);
+        for (const auto& [start, events] : anim.timeline()) {
+            size += k_map_node_overhead + sizeof(start) + sizeof(events) +
+                events.capacity() * sizeof(sm::animation_event);
+            for (const auto& event : events) {
+                size += std::visit(
+                    [&](const auto& ev) -> size_t {
+                        using event_type = std::decay_t<decltype(ev)>;
+                        if constexpr (std::is_same_v<event_type, sm::rotation>) {
+                            return heap_size(ev.axis) + heap_size(ev.rotor);
+                        } else {
+                            return heap_size(ev.subject);
+                        }
+                    },
+                    event
+                );
+            }
+        }
+        return size;
+    }
+
+    // the memory a compiled animation plays from: its tracks, checkpoints and rest pose.
+
+    size_t compiled_size(const sm::compiled_animation& anim) {
+        auto poses = anim.checkpoint_count() + 1;
+        return anim.tracks().size() * sizeof(sm::compiled_animation::track) +
+            poses * anim.node_count() * sizeof(sm::point);
+    }
+}
+
+void bench_bake(const std::string& what, const sm::animation& anim, const sm::skeleton& skel,
+        std::mt19937& rng) {
+    auto compiled = sm::compiled_animation::compile(anim, skel);
+
+    auto bake_ms = bench::time_ms(1,
+        [&]() {
+            bench::keep(static_cast<double>(sm::baked_animation::bake(*compiled).key_count()));
+        }
+    );
+    bench::report(what + ": bake", bake_ms);
+
+    auto baked = sm::baked_animation::bake(*compiled);
+    auto unquantized = sm::baked_animation::bake(*compiled, { .quantize = false });
+    bench::report_size(what + ": events, as an sm::animation", events_size(anim));
+    bench::report_size(what + ": events, compiled to tracks and checkpoints",
+        compiled_size(*compiled));
+    bench::report_size(what + ": baked, quantized", baked.size_in_bytes());
+    bench::report_size(what + ": baked, floats", unquantized.size_in_bytes());
+
+    std::vector<int> seeks(k_duration);
+    std::iota(seeks.begin(), seeks.end(), 0);
+    std::shuffle(seeks.begin(), seeks.end(), rng);
+
+    // times between ticks, so that neither side lands on its keys or checkpoints.
+    std::vector<sm::point> pose;
+    auto events_play = bench::time_ms(1,
+        [&]() {
+            for (int t = 0; t < k_duration; ++t) {
+                compiled->evaluate(t + 0.5, pose);
+                bench::keep(checksum(pose));
+            }
+        }
+    );
+    auto events_seek = bench::time_ms(1,
+        [&]() {
+            for (auto t : seeks) {
+                compiled->evaluate(t + 0.5, pose);
+                bench::keep(checksum(pose));
+            }
+        }
+    );
+
+    sm::baked_animation::decoder decoder(baked);
+    auto baked_play = bench::time_ms(1,
+        [&]() {
+            for (int t = 0; t < k_duration; ++t) {
+                decoder.evaluate(t + 0.5, pose);
+                bench::keep(checksum(pose));
+            }
+        }
+    );
+    auto baked_seek = bench::time_ms(1,
+        [&]() {
+            for (auto t : seeks) {
+                decoder.evaluate(t + 0.5, pose);
+                bench::keep(checksum(pose));
+            }
+        }
+    );
+
+    auto frames = std::to_string(k_duration);
+    bench::report(what + ": events, play " + frames + " frames", events_play);
+    bench::report(what + ": events, seek " + frames + " frames", events_seek);
+    bench::report(what + ": baked, play " + frames + " frames", baked_play);
+    bench::report(what + ": baked, seek " + frames + " frames", baked_seek);
+}
+
+int main() {
+    std::mt19937 rng(50);
+    test::rig r(k_bone_count, rng);
+
+    // a sparse, hand-keyed timeline and a dense one like a recorded performance.
+    bench_bake("sparse", random_animation(r, 2, 1, rng), *r.skel, rng);
+    bench_bake("dense", random_animation(r, 1, 6, rng), *r.skel, rng);
+    bench::report_size("every sample as floats",
+        (k_duration + 1) * 2 * (k_bone_count + 1) * sizeof(float));
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "bench.h"
+#include <numbers>
+#include <string>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    // a single chain of bones ten units long, in order from the root.
+
+    std::vector<sm::bone*> chain(sm::world& world, int bone_count) {
+        auto* tail = &world.create_skeleton(0, 0).root_node();
+        std::vector<sm::bone*> bones;
+        for (int i = 0; i < bone_count; ++i) {
+            auto& tip = world.create_skeleton(tail->world_x() + 10.0, tail->world_y());
+            auto bone = world.create_bone({}, *tail, tip.root_node());
+            bones.push_back(&bone->get());
+            tail = &bone->get().child_node();
+        }
+        return bones;
+    }
+
+    // sets the length and then the world rotation of every stride-th bone of the chain, one
+    // bone at a time parents first as the properties pane used to, and in one bulk call.
+
+    void bench_edit(int bone_count, int stride) {
+        sm::world world;
+        auto bones = chain(world, bone_count);
+        std::vector<sm::bone*> selection;
+        for (size_t i = 0; i < bones.size(); i += stride) {
+            selection.push_back(bones[i]);
+        }
+        auto what = std::to_string(selection.size()) + " of a " +
+            std::to_string(bone_count) + "-bone chain";
+
+        double len = 10.0;
+        auto one_at_a_time = bench::time_ms(3,
+            [&]() {
+                len = (len == 10.0) ? 12.0 : 10.0;
+                for (auto* b : selection) {
+                    b->set_length(len);
+                }
+            }
+        );
+        auto bulk = bench::time_ms(3,
+            [&]() {
+                len = (len == 10.0) ? 12.0 : 10.0;
+                sm::set_length(selection, len);
+            }
+        );
+        bench::report("set length, one at a time, " + what, one_at_a_time);
+        bench::report("set length, bulk, " + what, bulk);
+
+        double theta = 0.0;
+        one_at_a_time = bench::time_ms(3,
+            [&]() {
+                theta = (theta == 0.0) ? std::numbers::pi / 4.0 : 0.0;
+                for (auto* b : selection) {
+                    b->set_world_rotation(theta);
+                }
+            }
+        );
+        bulk = bench::time_ms(3,
+            [&]() {
+                theta = (theta == 0.0) ? std::numbers::pi / 4.0 : 0.0;
+                sm::set_world_rotation(selection, theta);
+            }
+        );
+        bench::report("set rotation, one at a time, " + what, one_at_a_time);
+        bench::report("set rotation, bulk, " + what, bulk);
+
+        bench::keep(bones.back()->child_node().world_x());
+    }
+}
+
+int main() {
+    for (int bone_count : { 500, 2000 }) {
+        bench_edit(bone_count, 1);
+        bench_edit(bone_count, 10);
+    }
+    return 0;
+}
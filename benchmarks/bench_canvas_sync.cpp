@@ -0,0 +1,94 @@
+#include "canvas_bench.h"
+#include "model/handle.h"
+#include <functional>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace r = std::ranges;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_drag_steps = 100;
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+
+    // a thousand skeletons of nine bones: 20k node, bone and skeleton items.
+    std::mt19937 rng(31);
+    bench::canvases canvases(bench::random_project_json({ 1, 1000, 9, 90.0 }, rng));
+    auto& proj = canvases.project();
+    auto& canv = canvases.canvas("tab-0");
+    auto item_count = std::to_string(canv.canvas_items().size());
+
+    // drags one skeleton a unit at a time, as the selection tool does, syncing either the
+    // items of the dragged nodes or every item on the canvas after each step.
+    auto& skel = proj.world().skeleton(proj.skel_names_on_tab("tab-0").front())->get();
+    std::vector<sm::node*> nodes;
+    for (auto node : skel.nodes()) {
+        nodes.push_back(node.ptr());
+    }
+    auto drag = [&]() {
+        for (auto* node : nodes) {
+            auto pt = node->world_pos();
+            node->set_world_pos({ pt.x + 1.0, pt.y });
+        }
+    };
+
+    auto dirty = bench::time_ms(k_drag_steps,
+        [&]() {
+            drag();
+            canv.sync_to_model(nodes, {});
+        }
+    );
+    auto full = bench::time_ms(k_drag_steps / 10,
+        [&]() {
+            drag();
+            canv.sync_to_model();
+        }
+    );
+    bench::report("drag step on " + item_count + " items, sync dragged", dirty);
+    bench::report("drag step on " + item_count + " items, sync all", full);
+
+    // a transform command marks the nodes it moves dirty, and the canvas syncs just those.
+    auto handles = mdl::to_handles(nodes) | r::to<std::vector<mdl::handle>>();
+    std::function<void(sm::node&)> nudge = [](sm::node& node) {
+        auto pt = node.world_pos();
+        node.set_world_pos({ pt.x + 1.0, pt.y });
+    };
+    auto command = bench::time_ms(k_drag_steps,
+        [&]() {
+            proj.transform(handles, nudge);
+        }
+    );
+    bench::report("transform command on " + item_count + " items", command);
+
+    // deleting a bone splits its skeleton; undoing and redoing the deletion restructures just
+    // that skeleton, so only its items are resynced.
+    auto bone = *skel.bones().begin();
+    proj.remove_pieces("tab-0", {}, { mdl::to_handle(bone) });
+    auto undo_redo = bench::time_ms(k_drag_steps / 10,
+        [&]() {
+            proj.undo();
+            proj.redo();
+        }
+    );
+    bench::report("undo and redo a bone deletion on " + item_count + " items", undo_redo);
+
+    // zooms in and out a level with the view repainting after each step; the grid tiles of
+    // both levels stay cached and only selected skeletons are resized.
+    auto zoom = bench::time_ms(k_drag_steps,
+        [&, level = 0]() mutable {
+            level = (level == 0) ? -1 : 0;
+            canv.set_zoom_level(level);
+            QApplication::processEvents();
+        }
+    );
+    bench::report("zoom step on " + item_count + " items", zoom);
+
+    return 0;
+}
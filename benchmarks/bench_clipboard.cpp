@@ -0,0 +1,126 @@
+#include "canvas_bench.h"
+#include "ui/stick_man.h"
+#include "ui/clipboard.h"
+#include <QClipboard>
+#include <QDir>
+#include <QMimeData>
+#include <QStandardPaths>
+#include <array>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr std::array k_node_counts = { 1000, 10000, 100000 };
+
+    const QString k_binary_mime_type = "application/x-stick_man-binary";
+    const QString k_json_mime_type = "application/x-stick_man";
+
+    int runs_for(int node_count) {
+        return (node_count <= 1000) ? 10 : (node_count <= 10000) ? 3 : 1;
+    }
+
+    // the main window finds its autosave directory through QStandardPaths. In test mode that
+    // is a directory of its own, which is emptied so that no window offers recovery.
+
+    void use_fresh_autosave_directory() {
+        QStandardPaths::setTestModeEnabled(true);
+        QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+            .removeRecursively();
+    }
+
+    // the mean time of pasting what make_mime_data() puts on the clipboard, each paste undone
+    // outside the timing so the canvas stays the same size.
+
+    template<typename F>
+    double paste_ms(ui::stick_man& main_wnd, int runs, F make_mime_data) {
+        double total = 0.0;
+        for (int i = 0; i < runs; ++i) {
+            QApplication::clipboard()->setMimeData(make_mime_data());
+            total += bench::time_once([&]() { ui::clipboard::paste(main_wnd, true); });
+            main_wnd.project().undo();
+            QApplication::processEvents();
+        }
+        return total / runs;
+    }
+
+    QMimeData* mime_data_of(const QString& mime_type, const QByteArray& bytes) {
+        auto* mime_data = new QMimeData;
+        mime_data->setData(mime_type, bytes);
+        return mime_data;
+    }
+
+    // how copy and paste went before the binary payload: the selection copied to a world and
+    // dumped as indented json, then parsed back into a temporary world on paste.
+
+    std::string old_payload(const sm::skeleton& skel) {
+        sm::world selected;
+        skel.copy_to(selected);
+        return selected.to_json().dump(4);
+    }
+
+    void old_decode(const std::string& payload) {
+        sm::world clipboard_world;
+        clipboard_world.from_json_str(payload);
+        bench::keep(static_cast<double>(clipboard_world.skeletons().size()));
+    }
+
+    void run(int node_count, std::mt19937& rng) {
+        use_fresh_autosave_directory();
+        ui::stick_man main_wnd;
+        main_wnd.resize(1600, 900);
+        main_wnd.show();
+        main_wnd.project().from_json(
+            bench::random_project_json({ 1, 1, node_count - 1, 0.0 }, rng)
+        );
+        QApplication::processEvents();
+
+        auto& canv = main_wnd.canvases().active_canvas();
+        auto* skel_item = canv.skeleton_items().front();
+        canv.set_selection(skel_item, true);
+        auto runs = runs_for(node_count);
+        auto nodes = std::to_string(node_count) + " nodes";
+
+        auto copy = bench::time_ms(runs, [&]() { ui::clipboard::copy(main_wnd); });
+        const auto* copied = QApplication::clipboard()->mimeData();
+        auto binary = copied->data(k_binary_mime_type);
+        auto json = copied->data(k_json_mime_type);
+
+        auto binary_paste = paste_ms(main_wnd, runs,
+            [&]() { return mime_data_of(k_binary_mime_type, binary); }
+        );
+        auto json_paste = paste_ms(main_wnd, runs,
+            [&]() { return mime_data_of(k_json_mime_type, json); }
+        );
+
+        std::string old;
+        auto old_encode = bench::time_ms(runs, [&]() { old = old_payload(skel_item->model()); });
+        auto old_paste = bench::time_ms(runs, [&]() { old_decode(old); });
+
+        bench::report_size(nodes + ", binary payload", binary.size());
+        bench::report_size(nodes + ", json payload", json.size());
+        bench::report_size(nodes + ", old indented json payload", old.size());
+        bench::report(nodes + ", copy", copy);
+        bench::report(nodes + ", paste from binary", binary_paste);
+        bench::report(nodes + ", paste from json", json_paste);
+        bench::report(nodes + ", round trip", copy + binary_paste);
+        bench::report(nodes + ", old encode", old_encode);
+        bench::report(nodes + ", old decode to a world", old_paste);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+    app.setApplicationName("stick_man_bench_clipboard");
+
+    // a single skeleton of each size, selected whole, copied and pasted back in place.
+    std::mt19937 rng(43);
+    for (auto node_count : k_node_counts) {
+        run(node_count, rng);
+    }
+    use_fresh_autosave_directory();
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "canvas_bench.h"
+#include <QGraphicsScene>
+#include <QPainter>
+#include <cmath>
+#include <ranges>
+#include <string>
+
+namespace rv = std::ranges::views;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_frames = 20;
+    constexpr double k_grid_line_spacing = 10.0;
+
+    // the canvas's background as it was painted before it was cached in tiles: every grid
+    // line in the dirty rect stroked on every repaint.
+
+    class line_grid_scene : public QGraphicsScene {
+
+        void drawBackground(QPainter* painter, const QRectF& dirty_rect) override {
+            painter->fillRect(dirty_rect, QColor::fromRgb(53, 53, 53));
+            painter->setRenderHint(QPainter::Antialiasing, true);
+            auto r = dirty_rect.intersected(sceneRect());
+
+            painter->fillRect(r, Qt::white);
+            QPen dark_pen(QColor::fromRgb(220, 220, 220), 0);
+            QPen light_pen(QColor::fromRgb(240, 240, 240), 0);
+            qreal x1, y1, x2, y2;
+            r.getCoords(&x1, &y1, &x2, &y2);
+
+            int left_gridline_index = static_cast<int>(std::ceil(x1 / k_grid_line_spacing));
+            int right_gridline_index = static_cast<int>(std::floor(x2 / k_grid_line_spacing));
+            for (auto i : rv::iota(left_gridline_index, right_gridline_index + 1)) {
+                auto x = i * k_grid_line_spacing;
+                painter->setPen((i % 5) ? light_pen : dark_pen);
+                painter->drawLine(QPointF(x, y1), QPointF(x, y2));
+            }
+
+            int top_gridline_index = static_cast<int>(std::ceil(y1 / k_grid_line_spacing));
+            int bottom_gridline_index = static_cast<int>(std::floor(y2 / k_grid_line_spacing));
+            for (auto i : rv::iota(top_gridline_index, bottom_gridline_index + 1)) {
+                auto y = i * k_grid_line_spacing;
+                painter->setPen((i % 5) ? light_pen : dark_pen);
+                painter->drawLine(QPointF(x1, y), QPointF(x2, y));
+            }
+
+            painter->setPen(QPen(QColor::fromRgb(180, 180, 180), 0));
+            painter->drawLine(QPointF(0, y1), QPointF(0, y2));
+            painter->drawLine(QPointF(x1, 0), QPointF(x2, 0));
+        }
+
+    public:
+
+        line_grid_scene() {
+            setSceneRect(QRectF(-1500, -1500, 3000, 3000));
+        }
+    };
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+
+    std::mt19937 rng(34);
+    bench::canvases canvases(bench::random_project_json({ 1, 0, 0, 0.0 }, rng));
+    auto& canv = canvases.canvas("tab-0");
+
+    line_grid_scene lines;
+    QGraphicsView line_view(&lines);
+    line_view.setRenderHint(QPainter::Antialiasing, true);
+    line_view.resize(bench::view_of(canv).size());
+    line_view.show();
+    QApplication::processEvents();
+
+    QImage image;
+    auto paint_lines = [&]() {
+        auto* viewport = line_view.viewport();
+        if (image.size() != viewport->size()) {
+            image = QImage(viewport->size(), QImage::Format_ARGB32_Premultiplied);
+        }
+        viewport->render(&image);
+    };
+
+    for (double scale : { 0.5, 1.0, 3.0 }) {
+        line_view.resetTransform();
+        line_view.scale(scale, -scale);
+        line_view.centerOn(0.0, 0.0);
+        auto per_line = bench::time_ms(k_frames, paint_lines);
+
+        // zooming clears the tile cache, so the first frame at a zoom level renders tiles.
+        auto first_tiled = bench::time_ms(k_frames,
+            [&]() {
+                canv.set_scale(scale, QPointF(0.0, 0.0));
+                bench::paint(canv, image);
+            }
+        );
+        auto tiled = bench::time_ms(k_frames,
+            [&]() {
+                bench::paint(canv, image);
+            }
+        );
+
+        auto zoom = " at scale " + std::to_string(scale).substr(0, 3);
+        bench::report("grid frame" + zoom + ", per line", per_line);
+        bench::report("grid frame" + zoom + ", tiled, after zooming", first_tiled);
+        bench::report("grid frame" + zoom + ", tiled", tiled);
+    }
+
+    return 0;
+}
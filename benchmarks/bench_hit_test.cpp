@@ -0,0 +1,124 @@
+#include "canvas_bench.h"
+#include "ui/canvas/canvas_item.h"
+#include "ui/canvas/node_item.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_skeleton_count = 2400;
+    constexpr int k_bones_per_skeleton = 10;
+    constexpr int k_pick_count = 10000;
+    constexpr int k_rect_count = 1000;
+    constexpr double k_extent = 1400.0;
+
+    // how the canvas picked before it had a spatial index: asking the scene for every item
+    // under the point, topmost first, and casting each to the kind of item wanted.
+
+    template<typename T>
+    T* scene_top_item(const QGraphicsScene& scene, QPointF pt) {
+        for (auto* itm : scene.items(pt)) {
+            if (auto* found = dynamic_cast<T*>(itm); found) {
+                return found;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t scene_items_in_rect(const QGraphicsScene& scene, const QRectF& rect) {
+        size_t count = 0;
+        for (auto* itm : scene.items(rect)) {
+            if (dynamic_cast<ui::canvas::item::base*>(itm)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+
+    // 2400 skeletons of ten bones: about 50k nodes and bones.
+    std::mt19937 rng(33);
+    auto spacing = 2 * k_extent / std::ceil(std::sqrt(k_skeleton_count));
+    bench::canvases canvases(
+        bench::random_project_json({ 1, k_skeleton_count, k_bones_per_skeleton, spacing }, rng)
+    );
+    auto& canv = canvases.canvas("tab-0");
+    auto pieces = std::to_string(canv.node_items().size() + canv.bone_items().size());
+
+    std::uniform_real_distribution<double> coord(-k_extent, k_extent);
+    std::vector<QPointF> points(k_pick_count);
+    for (auto& pt : points) {
+        pt = { coord(rng), coord(rng) };
+    }
+    std::vector<QRectF> rects(k_rect_count);
+    for (auto& rect : rects) {
+        rect = { coord(rng), coord(rng), 200.0, 200.0 };
+    }
+
+    auto indexed_node = bench::time_ms(3,
+        [&]() {
+            for (auto pt : points) {
+                bench::keep(canv.top_node(pt) ? 1.0 : 0.0);
+            }
+        }
+    );
+    auto scene_node = bench::time_ms(3,
+        [&]() {
+            for (auto pt : points) {
+                bench::keep(scene_top_item<ui::canvas::item::node>(canv, pt) ? 1.0 : 0.0);
+            }
+        }
+    );
+    auto indexed_item = bench::time_ms(3,
+        [&]() {
+            for (auto pt : points) {
+                bench::keep(canv.top_item(pt) ? 1.0 : 0.0);
+            }
+        }
+    );
+    auto scene_item = bench::time_ms(3,
+        [&]() {
+            for (auto pt : points) {
+                bench::keep(scene_top_item<ui::canvas::item::base>(canv, pt) ? 1.0 : 0.0);
+            }
+        }
+    );
+    auto nearest = bench::time_ms(3,
+        [&]() {
+            for (auto pt : points) {
+                bench::keep(canv.nearest_node(pt, 20.0) ? 1.0 : 0.0);
+            }
+        }
+    );
+    bench::report("10k node picks in " + pieces + " pieces, R-tree", indexed_node);
+    bench::report("10k node picks in " + pieces + " pieces, scene items", scene_node);
+    bench::report("10k item picks in " + pieces + " pieces, R-tree", indexed_item);
+    bench::report("10k item picks in " + pieces + " pieces, scene items", scene_item);
+    bench::report("10k nearest-node queries within 20 units", nearest);
+
+    auto indexed_rect = bench::time_ms(3,
+        [&]() {
+            for (const auto& rect : rects) {
+                bench::keep(static_cast<double>(canv.items_in_rect(rect).size()));
+            }
+        }
+    );
+    auto scene_rect = bench::time_ms(3,
+        [&]() {
+            for (const auto& rect : rects) {
+                bench::keep(static_cast<double>(scene_items_in_rect(canv, rect)));
+            }
+        }
+    );
+    bench::report("1000 rubber-band rects of 200x200, R-tree", indexed_rect);
+    bench::report("1000 rubber-band rects of 200x200, scene items", scene_rect);
+
+    return 0;
+}
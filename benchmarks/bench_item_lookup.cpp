@@ -0,0 +1,81 @@
+#include "canvas_bench.h"
+#include "core/sm_visit.h"
+#include "ui/canvas/node_item.h"
+#include "ui/canvas/bone_item.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace item = ui::canvas::item;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_bone_count = 20000;
+    constexpr int k_pin_every = 50;
+
+    // the nodes a rotation pivots on, as the selection tool finds them: the pinned nodes
+    // and both ends of the selected bones.
+
+    size_t pinned_from_table(const ui::canvas::scene& canv, sm::node& start) {
+        std::unordered_set<sm::node*> pinned;
+        sm::visit_nodes_and_bones(
+            start,
+            [&](sm::node& n)->sm::visit_result {
+                if (canv.item_of(n)->is_pinned()) {
+                    pinned.insert(&n);
+                }
+                return sm::visit_result::continue_traversal;
+            },
+            [&](sm::bone& b)->sm::visit_result {
+                if (canv.item_of(b)->is_selected()) {
+                    pinned.insert(&b.parent_node());
+                    pinned.insert(&b.child_node());
+                }
+                return sm::visit_result::continue_traversal;
+            }
+        );
+        return pinned.size();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+
+    // one skeleton of 20k bones, every fiftieth node pinned.
+    std::mt19937 rng(39);
+    bench::canvases canvases(bench::random_project_json({ 1, 1, k_bone_count, 0.0 }, rng));
+    auto& proj = canvases.project();
+    auto& canv = canvases.canvas("tab-0");
+    auto& skel = proj.world().skeleton(proj.skel_names_on_tab("tab-0").front())->get();
+
+    std::vector<sm::node*> nodes;
+    for (auto node : skel.nodes()) {
+        auto* node_item = canv.item_of(*node);
+        if (nodes.size() % k_pin_every == 0) {
+            node_item->set_pinned(true);
+        }
+        nodes.push_back(node.ptr());
+    }
+
+    auto table_lookup = bench::time_ms(10,
+        [&]() {
+            for (auto* node : nodes) {
+                bench::keep(canv.item_of(*node)->is_pinned() ? 1.0 : 0.0);
+            }
+        }
+    );
+    auto table_pinned = bench::time_ms(10,
+        [&]() {
+            bench::keep(static_cast<double>(pinned_from_table(canv, skel.root_node())));
+        }
+    );
+
+    auto count = std::to_string(nodes.size());
+    bench::report("look up the items of " + count + " nodes, side table", table_lookup);
+    bench::report("find the pinned nodes of " + count + " nodes, side table", table_pinned);
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "canvas_bench.h"
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_frames = 10;
+
+    std::string level_name(ui::canvas::detail_level level) {
+        switch (level) {
+            case ui::canvas::detail_level::full:
+                return "full";
+            case ui::canvas::detail_level::simplified:
+                return "simplified";
+            case ui::canvas::detail_level::polylines:
+                return "polylines";
+            case ui::canvas::detail_level::bounding_boxes:
+                return "bounding boxes";
+        }
+        return {};
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+
+    // a dense tab: a hundred skeletons of fifty bones each.
+    std::mt19937 rng(37);
+    bench::canvases canvases(bench::random_project_json({ 1, 100, 50, 150.0 }, rng));
+    auto& canv = canvases.canvas("tab-0");
+
+    QImage image;
+    const ui::canvas::lod_thresholds full_detail{ 0.0, 0.0, 0.0 };
+    for (double scale : { 1.0, 0.5, 0.2, 0.08, 0.04, 0.02 }) {
+        auto zoom = "frame at scale " + std::to_string(scale).substr(0, 4);
+
+        canvases.manager().set_lod_thresholds({});
+        canv.set_scale(scale, QPointF(0.0, 0.0));
+        auto lod = bench::time_ms(k_frames,
+            [&]() {
+                bench::paint(canv, image);
+            }
+        );
+        auto level = level_name(canv.level_of_detail());
+
+        canvases.manager().set_lod_thresholds(full_detail);
+        auto full = bench::time_ms(k_frames,
+            [&]() {
+                bench::paint(canv, image);
+            }
+        );
+
+        bench::report(zoom + ", " + level, lod);
+        bench::report(zoom + ", always full detail", full);
+    }
+
+    return 0;
+}
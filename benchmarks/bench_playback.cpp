@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "core/sm_playback.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_bone_count = 500;
+    constexpr int k_frame_count = 10000;
+
+    // an event starting on every tick, mostly short rotations of random bones about their
+    // parent or child nodes, with a few translations of branches.
+
+    sm::animation random_animation(const test::rig& r, std::mt19937& rng) {
+        sm::animation anim("benchmark");
+        for (int t = 0; t < k_frame_count; ++t) {
+            const auto& bone = *r.bones[rng() % r.bones.size()];
+            auto duration = static_cast<int>(rng() % 60);
+            switch (rng() % 8) {
+                case 0:
+                    anim.insert(t, sm::translation{ bone.child_node().name(), { 1.0, -0.5 },
+                        duration });
+                    break;
+                case 1:
+                    anim.insert(t, sm::rotation{ bone.child_node().name(), bone.name(), 0.01,
+                        duration });
+                    break;
+                default:
+                    anim.insert(t, sm::rotation{ bone.parent_node().name(), bone.name(), 0.05,
+                        duration });
+                    break;
+            }
+        }
+        return anim;
+    }
+
+    double checksum(const std::vector<sm::point>& pose) {
+        return std::accumulate(pose.begin(), pose.end(), 0.0,
+            [](double sum, const sm::point& pt) { return sum + pt.x + pt.y; });
+    }
+
+    // plays every frame in order, then seeks to every frame in a shuffled order.
+
+    void bench_evaluate(const char* what, const sm::compiled_animation& anim, int stride,
+            const std::vector<int>& seeks) {
+        std::vector<sm::point> pose;
+        auto frames = k_frame_count / stride;
+        auto play = bench::time_ms(1,
+            [&]() {
+                for (int t = 0; t < k_frame_count; t += stride) {
+                    anim.evaluate(t, pose);
+                    bench::keep(checksum(pose));
+                }
+            }
+        );
+        auto seek = bench::time_ms(1,
+            [&]() {
+                for (size_t i = 0; i < seeks.size(); i += stride) {
+                    anim.evaluate(seeks[i], pose);
+                    bench::keep(checksum(pose));
+                }
+            }
+        );
+        auto count = std::to_string(frames);
+        bench::report(std::string(what) + ": play " + count + " frames", play);
+        bench::report(std::string(what) + ": seek " + count + " frames", seek);
+        bench::report(std::string(what) + ": per frame played", play / frames);
+    }
+}
+
+int main() {
+    std::mt19937 rng(46);
+    test::rig r(k_bone_count, rng);
+    auto anim = random_animation(r, rng);
+
+    std::vector<int> seeks(k_frame_count);
+    std::iota(seeks.begin(), seeks.end(), 0);
+    std::shuffle(seeks.begin(), seeks.end(), rng);
+
+    auto compile_ms = bench::time_ms(3,
+        [&]() {
+            bench::keep(static_cast<double>(
+                sm::compiled_animation::compile(anim, *r.skel)->checkpoint_count()
+            ));
+        }
+    );
+    bench::report("compile 10k events, 500 bones", compile_ms);
+
+    auto checkpointed = sm::compiled_animation::compile(anim, *r.skel);
+    bench_evaluate("checkpointed", *checkpointed, 1, seeks);
+
+    // without checkpoints every frame replays the timeline up to it, so only every tenth
+    // frame is timed.
+    auto replayed = sm::compiled_animation::compile(anim, *r.skel,
+        { std::numeric_limits<int>::max(), std::numeric_limits<size_t>::max() });
+    bench_evaluate("no checkpoints", *replayed, 10, seeks);
+
+    return 0;
+}
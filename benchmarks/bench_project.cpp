@@ -0,0 +1,184 @@
+#include "bench.h"
+#include "model/project.h"
+#include "model/journal.h"
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    using tab_table = std::unordered_map<std::string, std::vector<std::string>>;
+
+    // how the project found a skeleton's tab before it kept a reverse index: a scan of every
+    // skeleton name on every tab.
+
+    std::string scan_canvas_name(const tab_table& tabs, const std::string& skel) {
+        for (const auto& [canv_name, skels] : tabs) {
+            for (const auto& skel_name : skels) {
+                if (skel == skel_name) {
+                    return canv_name;
+                }
+            }
+        }
+        return {};
+    }
+
+    std::vector<mdl::journal::entry> read_journal(const fs::path& dir) {
+        std::vector<mdl::journal::entry> entries;
+        for (const auto& segment : mdl::journal::segment_paths(dir.string())) {
+            auto segment_entries = mdl::journal::read_segment(segment);
+            std::ranges::move(segment_entries, std::back_inserter(entries));
+        }
+        return entries;
+    }
+
+    // what an autosave of the project costs: taking the snapshot holds up the UI thread,
+    // while serializing it happens on the autosaver's worker. Serializing the project
+    // itself is what the UI thread would pay without a snapshot.
+
+    void autosave_snapshot(const mdl::project& proj) {
+        auto snapshot = bench::time_ms(5,
+            [&]() {
+                bench::keep(static_cast<double>(proj.snapshot().revision));
+            }
+        );
+        auto snap = proj.snapshot();
+        auto serialize = bench::time_ms(1,
+            [&]() {
+                bench::keep(static_cast<double>(snap.to_json().size()));
+            }
+        );
+        auto direct = bench::time_ms(1,
+            [&]() {
+                bench::keep(static_cast<double>(proj.to_json().size()));
+            }
+        );
+        bench::report("snapshot a 50k-node project, on the UI thread", snapshot);
+        bench::report("serialize the snapshot, on the worker", serialize);
+        bench::report("serialize the project without a snapshot", direct);
+    }
+
+    // a 50k-node project is autosaved and then edited a thousand times with a journal attached.
+    // Recovering it from the snapshot and the journal is compared with saving the edited
+    // project in full and loading it back, which is what recovery would cost without one.
+
+    void recovery(std::mt19937& rng) {
+        constexpr int k_edits = 1000;
+        mdl::project proj;
+        proj.from_json(bench::random_project_json({ 1, 50, 999, 200.0 }, rng));
+        autosave_snapshot(proj);
+        auto nodes = proj.world().skeletons() |
+            std::views::transform([](auto skel) { return &skel->root_node(); }) |
+            std::ranges::to<std::vector<sm::node*>>();
+
+        auto dir = fs::temp_directory_path() / "stick_man_bench_recovery";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        auto snapshot_json = proj.snapshot().to_json();
+        {
+            mdl::journal::writer journal(dir.string(), proj.revision() + 1);
+            proj.set_journal(&journal);
+            std::uniform_real_distribution<double> offset(-1.0, 1.0);
+            for (int i = 0; i < k_edits; ++i) {
+                auto* node = nodes[rng() % nodes.size()];
+                auto pt = node->world_pos() + sm::point{ offset(rng), offset(rng) };
+                proj.transform({ mdl::to_handle(sm::ref(*node)) },
+                    [pt](sm::node& n) {
+                        n.set_world_pos(pt);
+                    }
+                );
+            }
+            proj.set_journal(nullptr);
+        }
+
+        size_t journal_bytes = 0;
+        for (const auto& segment : mdl::journal::segment_paths(dir.string())) {
+            journal_bytes += fs::file_size(segment);
+        }
+        mdl::project replayed;
+        auto replay = bench::time_once(
+            [&]() {
+                replayed.recover(snapshot_json, read_journal(dir));
+            }
+        );
+        mdl::project loaded;
+        std::string saved;
+        auto save_load = bench::time_once(
+            [&]() {
+                saved = proj.to_json();
+                loaded.from_json(saved);
+            }
+        );
+        fs::remove_all(dir);
+
+        bench::report_size("journal of 1000 edits to a 50k-node project", journal_bytes);
+        bench::report_size("saved 50k-node project", saved.size());
+        bench::report("recover from the snapshot and replay 1000 edits", replay);
+        bench::report("save the edited project and load it back", save_load);
+    }
+}
+
+int main() {
+    std::mt19937 rng(30);
+    mdl::project proj;
+    proj.from_json(bench::random_project_json({ 100, 100, 1, 40.0 }, rng));
+
+    tab_table tabs;
+    for (const auto& tab : proj.tabs()) {
+        auto names = proj.skel_names_on_tab(tab);
+        tabs[tab] = std::vector<std::string>(names.begin(), names.end());
+    }
+    auto skel_names = proj.world().skeleton_names();
+    std::shuffle(skel_names.begin(), skel_names.end(), rng);
+
+    auto indexed = bench::time_ms(5,
+        [&]() {
+            for (const auto& skel : skel_names) {
+                bench::keep(static_cast<double>(proj.canvas_name_from_skeleton(skel).size()));
+            }
+        }
+    );
+    auto scanned = bench::time_ms(1,
+        [&]() {
+            for (const auto& skel : skel_names) {
+                bench::keep(static_cast<double>(scan_canvas_name(tabs, skel).size()));
+            }
+        }
+    );
+    bench::report("find the tab of 10k skeletons on 100 tabs, indexed", indexed);
+    bench::report("find the tab of 10k skeletons on 100 tabs, scan", scanned);
+
+    // deleting a skeleton looks up its tab and takes its name off the tab, and undoing the
+    // deletion puts it back.
+    auto deleted = bench::time_once(
+        [&]() {
+            for (const auto& skel : skel_names) {
+                proj.replace_skeletons(
+                    proj.canvas_name_from_skeleton(skel), { skel },
+                    std::vector<sm::skeleton_snapshot>{}
+                );
+            }
+        }
+    );
+    auto restored = bench::time_once(
+        [&]() {
+            while (proj.can_undo()) {
+                proj.undo();
+            }
+        }
+    );
+    bench::report("delete 10k skeletons one command at a time", deleted);
+    bench::report("undo the deletions", restored);
+
+    recovery(rng);
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "canvas_bench.h"
+#include "ui/canvas/skel_item.h"
+#include "core/sm_playback.h"
+#include "model/handle.h"
+#include <QElapsedTimer>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_bones_per_skeleton = 10;
+    constexpr int k_frames = 10;
+
+    // the skeletons are spread over the scene rect, zoomed out so that all of them are in
+    // view, with the level-of-detail thresholds turned off so that both modes draw every
+    // piece in full.
+
+    void bench_frames(int bone_count, std::mt19937& rng) {
+        auto skeleton_count = bone_count / k_bones_per_skeleton;
+        auto spacing = 2800.0 / std::ceil(std::sqrt(skeleton_count));
+        bench::canvases canvases(
+            bench::random_project_json(
+                { 1, skeleton_count, k_bones_per_skeleton, spacing }, rng
+            )
+        );
+        canvases.manager().set_lod_thresholds({ 0.0, 0.0, 0.0 });
+        auto& canv = canvases.canvas("tab-0");
+        canv.set_scale(0.3, QPointF(0.0, 0.0));
+
+        QImage image;
+        auto bones = std::to_string(bone_count);
+        for (auto mode : { ui::canvas::render_mode::items, ui::canvas::render_mode::batched }) {
+            canvases.manager().set_render_mode(mode);
+            auto frame = bench::time_ms(k_frames,
+                [&]() {
+                    bench::paint(canv, image);
+                }
+            );
+            auto mode_name = (mode == ui::canvas::render_mode::items) ? "items" : "batched";
+            bench::report("frame, " + bones + " bones, " + mode_name, frame);
+        }
+    }
+
+    // drags one node a unit at a time through the project, as the selection tool does, with
+    // the view repainting after each step. The view only repaints what the node and its bones
+    // moved over, so the step takes as long whatever the size of the scene.
+
+    constexpr int k_drag_steps = 50;
+
+    void bench_drag(int bone_count, std::mt19937& rng) {
+        auto skeleton_count = bone_count / k_bones_per_skeleton;
+        auto spacing = 2800.0 / std::ceil(std::sqrt(skeleton_count));
+        bench::canvases canvases(
+            bench::random_project_json(
+                { 1, skeleton_count, k_bones_per_skeleton, spacing }, rng
+            )
+        );
+        auto& canv = canvases.canvas("tab-0");
+        canv.set_scale(0.3, QPointF(0.0, 0.0));
+        QApplication::processEvents();
+
+        auto& skel = canv.skeleton_items().front()->model();
+        auto node = mdl::to_handle(*skel.nodes().begin());
+        std::function<void(sm::node&)> nudge = [](sm::node& n) {
+            auto pt = n.world_pos();
+            n.set_world_pos({ pt.x + 1.0, pt.y });
+        };
+        auto drag = bench::time_ms(k_drag_steps,
+            [&]() {
+                canvases.project().transform({ node }, nudge);
+                QApplication::processEvents();
+            }
+        );
+        bench::report("drag step with repaint, " + std::to_string(bone_count) + " bones", drag);
+    }
+
+    // plays an animation that swings every bone of a skeleton for a couple of seconds, with
+    // the canvas polling for poses at the screen's refresh rate, and reports how many polls
+    // found a pose to show and how many ticks the worker dropped or published late.
+
+    constexpr int k_playback_ticks = 120;
+    constexpr double k_playback_fps = 60.0;
+
+    void bench_playback(int bone_count, std::mt19937& rng) {
+        bench::canvases canvases(bench::random_project_json({ 1, 1, bone_count, 0.0 }, rng));
+        auto& canv = canvases.canvas("tab-0");
+        auto& skel = canv.skeleton_items().front()->model();
+
+        sm::animation anim("playback");
+        for (auto bone : skel.bones()) {
+            anim.insert(0, sm::rotation{ bone->parent_node().name(), bone->name(), 0.5,
+                k_playback_ticks });
+        }
+        auto compiled = sm::compiled_animation::compile(anim, skel);
+        if (!compiled) {
+            return;
+        }
+
+        uint64_t polls = 0, ticks = 0, dropped = 0, late = 0;
+        QObject::connect(&canvases.manager(), &ui::canvas::manager::playback_progress,
+            [&](ui::canvas::scene&, uint64_t t, uint64_t d, uint64_t l) {
+                ++polls;
+                ticks = t;
+                dropped = d;
+                late = l;
+            }
+        );
+
+        QElapsedTimer wall;
+        wall.start();
+        canv.play(std::make_shared<const sm::compiled_animation>(std::move(*compiled)), skel,
+            { k_playback_fps, false });
+        while (canv.playback()->is_playing() && wall.elapsed() < 10000) {
+            QApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+        auto elapsed = static_cast<double>(wall.elapsed());
+
+        // one more refresh so that the canvas takes the final pose and reports the totals.
+        while (wall.elapsed() < elapsed + 50) {
+            QApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+        canv.stop_playback();
+
+        auto bones = "playback, " + std::to_string(bone_count) + " bones, ";
+        bench::report(bones + "wall time", elapsed);
+        bench::report_count(bones + "canvas polls", polls);
+        bench::report_count(bones + "ticks played", ticks);
+        bench::report_count(bones + "ticks dropped", dropped);
+        bench::report_count(bones + "ticks late", late);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bench::use_offscreen_platform();
+    QApplication app(argc, argv);
+
+    std::mt19937 rng(32);
+    for (int bone_count : { 1000, 10000, 50000 }) {
+        bench_frames(bone_count, rng);
+    }
+    for (int bone_count : { 1000, 10000, 50000 }) {
+        bench_drag(bone_count, rng);
+    }
+    for (int bone_count : { 1000, 10000 }) {
+        bench_playback(bone_count, rng);
+    }
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "bench.h"
+#include "model/project.h"
+#include "ui/canvas/canvas_manager.h"
+#include "ui/canvas/scene.h"
+#include "ui/tools/tool_manager.h"
+#include <QApplication>
+#include <QGraphicsView>
+#include <QImage>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace bench {
+
+    // the canvas benchmarks paint through Qt's offscreen platform unless another platform is
+    // asked for, so that they run without a display. Call before making the QApplication.
+
+    inline void use_offscreen_platform() {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+    // a project with a canvas for each of its tabs, wired together as the main window wires
+    // them, in a window the size of a maximized one.
+
+    class canvases {
+        ui::tool::manager tools_;
+        mdl::project project_;
+        ui::canvas::manager manager_;
+
+    public:
+
+        canvases(const std::string& project_json) :
+                manager_(tools_) {
+            manager_.init(project_);
+            manager_.resize(1600, 900);
+            manager_.show();
+            project_.from_json(project_json);
+            QApplication::processEvents();
+        }
+
+        mdl::project& project() {
+            return project_;
+        }
+
+        ui::canvas::manager& manager() {
+            return manager_;
+        }
+
+        // the canvas of the tab, which becomes the current tab so that its view is laid out.
+        ui::canvas::scene& canvas(const std::string& tab) {
+            auto& canv = *manager_.canvas_from_name(tab);
+            manager_.setCurrentWidget(canv.views().front());
+            QApplication::processEvents();
+            return canv;
+        }
+    };
+
+    inline QGraphicsView& view_of(ui::canvas::scene& canv) {
+        return *canv.views().front();
+    }
+
+    // paints the whole viewport of the canvas's view into the image, as a full repaint does.
+
+    inline void paint(ui::canvas::scene& canv, QImage& image) {
+        auto* viewport = view_of(canv).viewport();
+        if (image.size() != viewport->size()) {
+            image = QImage(viewport->size(), QImage::Format_ARGB32_Premultiplied);
+        }
+        viewport->render(&image);
+    }
+}
@@ -1,4 +1,53 @@
 #include "sm_animation.h"
+#include <algorithm>
+#include <limits>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    int event_duration(const sm::animation_event& event) {
+        return std::visit([](const auto& evt) { return evt.duration; }, event);
+    }
+
+    // fills in max_ends for the range [lo, hi) of the index and returns the range's latest end.
+
+    int index_max_ends(sm::detail::interval_index& index, size_t lo, size_t hi) {
+        if (lo >= hi) {
+            return std::numeric_limits<int>::min();
+        }
+        auto mid = lo + (hi - lo) / 2;
+        auto max_end = std::max({
+            index.ends[mid],
+            index_max_ends(index, lo, mid),
+            index_max_ends(index, mid + 1, hi)
+        });
+        index.max_ends[mid] = max_end;
+        return max_end;
+    }
+
+    // an in-order walk of the range [lo, hi) that skips any subtree ending before t0 and stops
+    // at the first event starting at or after t1, so what it finds comes out in start order.
+
+    void query_index(const sm::detail::interval_index& index, size_t lo, size_t hi,
+            int t0, int t1, std::vector<sm::timed_event>& found) {
+        if (lo >= hi) {
+            return;
+        }
+        auto mid = lo + (hi - lo) / 2;
+        if (index.max_ends[mid] <= t0) {
+            return;
+        }
+        query_index(index, lo, mid, t0, t1, found);
+        if (index.starts[mid] >= t1) {
+            return;
+        }
+        if (index.ends[mid] > t0) {
+            found.push_back({ index.starts[mid], index.events[mid] });
+        }
+        query_index(index, mid + 1, hi, t0, t1, found);
+    }
+}
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -6,14 +55,71 @@ sm::animation::animation(const std::string& name) : name_(name) {
 
 }
 
+// the index points into the timeline it was built from, so copies build their own.
+
+sm::animation::animation(const animation& anim) :
+        name_(anim.name_),
+        timeline_(anim.timeline_) {
+}
+
+sm::animation& sm::animation::operator=(const animation& anim) {
+    name_ = anim.name_;
+    timeline_ = anim.timeline_;
+    index_ = {};
+    return *this;
+}
+
+std::string sm::animation::name() const {
+    return name_;
+}
+
+const std::map<int, std::vector<sm::animation_event>>& sm::animation::timeline() const {
+    return timeline_;
+}
+
 void sm::animation::insert(int start_time, const animation_event& event) {
     timeline_[start_time].push_back(event);
+    index_.valid = false;
 }
 
 void sm::animation::set(int start_time, const animation_event& event, int index) {
     timeline_.at(start_time).at(index) = event;
+    index_.valid = false;
+}
+
+std::span<const sm::animation_event> sm::animation::events(int start_time) const {
+    auto iter = timeline_.find(start_time);
+    if (iter == timeline_.end()) {
+        return {};
+    }
+    return iter->second;
+}
+
+const sm::detail::interval_index& sm::animation::index() const {
+    if (index_.valid) {
+        return index_;
+    }
+    index_ = {};
+    for (const auto& [start, events] : timeline_) {
+        for (const auto& event : events) {
+            index_.starts.push_back(start);
+            index_.ends.push_back(start + std::max(event_duration(event), 1));
+            index_.events.push_back(&event);
+        }
+    }
+    index_.max_ends.resize(index_.starts.size());
+    index_max_ends(index_, 0, index_.starts.size());
+    index_.valid = true;
+    return index_;
 }
 
-std::vector<sm::animation_event> sm::animation::events(int start_time) const {
-    return timeline_.at(start_time);
-}
\ No newline at end of file
+std::vector<sm::timed_event> sm::animation::events_at(int t) const {
+    return events_in(t, t + 1);
+}
+
+std::vector<sm::timed_event> sm::animation::events_in(int t0, int t1) const {
+    std::vector<timed_event> found;
+    const auto& idx = index();
+    query_index(idx, 0, idx.starts.size(), t0, t1, found);
+    return found;
+}
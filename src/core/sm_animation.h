@@ -3,6 +3,8 @@
 #include <string>
 #include <variant>
 #include <map>
+#include <vector>
+#include <span>
 
 namespace sm {
 
@@ -24,19 +26,62 @@ namespace sm {
 
     using animation_event = std::variant<rotation, translation>;
 
+    // an event on a timeline, pointing into the animation that holds it; valid until the
+    // animation is next modified.
+
+    struct timed_event {
+        int start;
+        const animation_event* event;
+    };
+
+    namespace detail {
+
+        // a timeline's events as intervals [start, start + duration) in start order, where an
+        // event without a duration occupies its start tick. The arrays are laid out as an
+        // implicit balanced search tree: the middle entry of any range of them is the root of
+        // that range, and its max_ends entry is the latest end in the range.
+
+        struct interval_index {
+            std::vector<int> starts;
+            std::vector<int> ends;
+            std::vector<int> max_ends;
+            std::vector<const animation_event*> events;
+            bool valid = false;
+        };
+    }
+
     class animation {
         friend class skeleton;
 
         std::string name_;
         std::map<int, std::vector<animation_event>> timeline_;
 
+        // rebuilt on the first query after a change, so building a timeline event by event
+        // does not rebuild it every time. That makes the first query a write, so const
+        // queries of one animation from several threads must be synchronized by the caller.
+        mutable detail::interval_index index_;
+
+        const detail::interval_index& index() const;
+
     public:
 
         animation(const std::string& name);
+        animation(const animation& anim);
+        animation(animation&& anim) = default;
+        animation& operator=(const animation& anim);
+        animation& operator=(animation&& anim) = default;
 
+        std::string name() const;
+        const std::map<int, std::vector<animation_event>>& timeline() const;
         void insert(int start_time, const animation_event& event);
         void set(int start_time, const animation_event& event, int index);
-        std::vector<animation_event> events(int start_time) const;
+        std::span<const animation_event> events(int start_time) const;
+
+        // the events in progress at time t, and the events overlapping [t0, t1), in start
+        // order. Both take O(log n + k) time for k events found, after rebuilding the index
+        // if the timeline has changed since the last query; they are not thread-safe.
+        std::vector<timed_event> events_at(int t) const;
+        std::vector<timed_event> events_in(int t0, int t1) const;
     };
 
 }
\ No newline at end of file
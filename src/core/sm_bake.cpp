@@ -0,0 +1,387 @@
+#include "sm_bake.h"
+#include <algorithm>
+#include <numbers>
+#include <limits>
+#include <cmath>
+#include <ranges>
+#include <optional>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr double k_max_quantized = std::numeric_limits<uint16_t>::max();
+
+    // the sines and cosines of the angles, to within a few parts in ten million, by
+    // polynomials that compilers can vectorize where the standard library's functions are
+    // calls per element. Each angle is brought within half a turn, then within a quarter
+    // of a turn by reflecting it about plus or minus half a turn, which keeps its sine and
+    // negates its cosine.
+
+    void sin_cos(std::span<const float> angles, std::span<float> sines,
+            std::span<float> cosines) {
+        constexpr float k_pi = std::numbers::pi_v<float>;
+        constexpr float k_inv_turn = 0.5f / k_pi;
+        constexpr float k_round = 12582912.0f;
+        for (size_t i = 0; i < angles.size(); ++i) {
+            auto turns = (angles[i] * k_inv_turn + k_round) - k_round;
+            auto x = angles[i] - turns * (2.0f * k_pi);
+            auto reflect = static_cast<float>(std::abs(x) > k_pi / 2.0f);
+            x += reflect * (std::copysign(k_pi, x) - 2.0f * x);
+            auto sign = 1.0f - 2.0f * reflect;
+            auto x2 = x * x;
+            sines[i] = x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f +
+                x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f + x2 * (-1.0f / 39916800.0f))))));
+            cosines[i] = sign * (1.0f + x2 * (-1.0f / 2.0f + x2 * (1.0f / 24.0f +
+                x2 * (-1.0f / 720.0f + x2 * (1.0f / 40320.0f + x2 * (-1.0f / 3628800.0f +
+                x2 * (1.0f / 479001600.0f)))))));
+        }
+    }
+
+    // keeps the samples of one channel that linear interpolation between them cannot
+    // reconstruct to within the tolerance, as the samples are taken. From each key the next
+    // is the furthest sample such that the line to it passes within the tolerance of every
+    // sample in between, which holds while its slope is within the narrowing range of slopes
+    // allowed by those samples. Only the samples past the furthest such sample so far are
+    // held, to be looked at again from the next key once the range closes.
+
+    class key_reducer {
+        struct sample {
+            uint32_t index;
+            double value;
+        };
+
+        double tolerance_;
+        bool is_angle_;
+        uint32_t count_ = 0;
+        double previous_ = 0.0;
+        sample anchor_ = {};
+        std::optional<sample> end_;
+        std::vector<sample> pending_;
+        double low_ = 0.0;
+        double high_ = 0.0;
+        std::vector<uint32_t> keys_;
+        std::vector<double> values_;
+
+        void set_anchor(sample s) {
+            keys_.push_back(s.index);
+            values_.push_back(s.value);
+            anchor_ = s;
+            end_ = {};
+            low_ = -std::numeric_limits<double>::infinity();
+            high_ = std::numeric_limits<double>::infinity();
+        }
+
+        // makes the furthest sample reachable from the anchor the next key, then looks
+        // again at the samples after it.
+        void advance() {
+            set_anchor(*end_);
+            auto rest = std::move(pending_);
+            pending_.clear();
+            for (auto s : rest) {
+                reduce(s);
+            }
+        }
+
+        void reduce(sample s) {
+            auto run = static_cast<double>(s.index - anchor_.index);
+            auto slope = (s.value - anchor_.value) / run;
+            if (slope >= low_ && slope <= high_) {
+                end_ = s;
+                pending_.clear();
+            } else {
+                pending_.push_back(s);
+            }
+            low_ = std::max(low_, (s.value - tolerance_ - anchor_.value) / run);
+            high_ = std::min(high_, (s.value + tolerance_ - anchor_.value) / run);
+            if (low_ > high_) {
+                advance();
+            }
+        }
+
+    public:
+
+        key_reducer(double tolerance, bool is_angle) :
+                tolerance_(tolerance),
+                is_angle_(is_angle) {
+        }
+
+        // angles are shifted by whole turns to be within half a turn of the one before,
+        // so that interpolating between keys never goes the long way around.
+        void add(double value) {
+            constexpr double k_turn = 2.0 * std::numbers::pi;
+            if (is_angle_ && count_ > 0) {
+                value += k_turn * std::round((previous_ - value) / k_turn);
+            }
+            previous_ = value;
+            sample s{ count_++, value };
+            if (keys_.empty()) {
+                set_anchor(s);
+            } else {
+                reduce(s);
+            }
+        }
+
+        void finish() {
+            while (end_) {
+                advance();
+            }
+        }
+
+        std::span<const uint32_t> keys() const {
+            return keys_;
+        }
+
+        std::span<const double> values() const {
+            return values_;
+        }
+    };
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+sm::baked_animation::decoder::decoder(const baked_animation& anim) :
+        anim_(&anim),
+        cursors_(anim.channels_.size(), 0),
+        starts_(anim.channels_.size()),
+        ends_(anim.channels_.size()),
+        from_(anim.channels_.size()),
+        slopes_(anim.channels_.size()),
+        values_(anim.channels_.size()),
+        angles_(anim.node_count()),
+        cosines_(anim.node_count()),
+        sines_(anim.node_count()) {
+    for (size_t c = 0; c < cursors_.size(); ++c) {
+        load_segment(c, 0);
+    }
+}
+
+// a channel's segment runs from one of its keys to the next. A channel with one key, and
+// the last segment of any channel, holds until the end of time.
+
+void sm::baked_animation::decoder::load_segment(size_t c, uint32_t k) {
+    const auto& chan = anim_->channels_[c];
+    const auto* keys = anim_->key_times_.data() + chan.first_key;
+    cursors_[c] = k;
+    starts_[c] = static_cast<float>(keys[k]);
+    from_[c] = anim_->value(chan, k);
+    if (chan.key_count == 1) {
+        ends_[c] = std::numeric_limits<float>::infinity();
+        slopes_[c] = 0.0f;
+        return;
+    }
+    auto is_last = (k + 2 == chan.key_count);
+    ends_[c] = (is_last) ?
+        std::numeric_limits<float>::infinity() : static_cast<float>(keys[k + 1]);
+    slopes_[c] = (anim_->value(chan, k + 1) - from_[c]) /
+        static_cast<float>(keys[k + 1] - keys[k]);
+}
+
+// a channel that left its segment scans forward for the one the time is in, from where it
+// was if the time is ahead of that and otherwise from where it was at the last seek interval
+// before the time. Playing forward that is usually a single step.
+
+void sm::baked_animation::decoder::seek_segment(
+        size_t c, float t, std::span<const uint32_t> seek_cursors) {
+    const auto& chan = anim_->channels_[c];
+    const auto* keys = anim_->key_times_.data() + chan.first_key;
+    auto last_segment = std::max(chan.key_count, 2u) - 2;
+    auto k = (t >= starts_[c]) ? std::max(cursors_[c], seek_cursors[c]) : seek_cursors[c];
+    while (k < last_segment && keys[k + 1] <= t) {
+        ++k;
+    }
+    load_segment(c, k);
+}
+
+void sm::baked_animation::decoder::evaluate(double t, std::vector<point>& pose) {
+    auto time = static_cast<float>(std::clamp(t, 0.0, static_cast<double>(anim_->duration_)));
+    auto channel_count = values_.size();
+    auto interval = static_cast<size_t>(time) / anim_->seek_interval_;
+    auto seek_cursors = std::span(anim_->seek_cursors_).subspan(interval * channel_count,
+        channel_count);
+    for (size_t c = 0; c < channel_count; ++c) {
+        if (time < starts_[c] || time >= ends_[c]) {
+            seek_segment(c, time, seek_cursors);
+        }
+    }
+    for (size_t c = 0; c < channel_count; ++c) {
+        values_[c] = from_[c] + slopes_[c] * (time - starts_[c]);
+    }
+
+    // nodes are in depth-first order, so every node's parent is placed before it.
+    const auto& parents = anim_->node_parents_;
+    auto node_count = parents.size();
+    pose.resize(node_count);
+    if (pose.empty()) {
+        return;
+    }
+    angles_[0] = 0.0f;
+    for (size_t i = 1; i < node_count; ++i) {
+        angles_[i] = angles_[parents[i]] + values_[2 * i];
+    }
+    sin_cos(angles_, sines_, cosines_);
+    pose[0] = { values_[0], values_[1] };
+    for (size_t i = 1; i < node_count; ++i) {
+        const auto& parent = pose[parents[i]];
+        double length = values_[2 * i + 1];
+        pose[i] = { parent.x + length * cosines_[i], parent.y + length * sines_[i] };
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+sm::baked_animation::baked_animation() : duration_(0), seek_interval_(1) {
+}
+
+float sm::baked_animation::value(const channel& chan, uint32_t key) const {
+    if (chan.is_quantized) {
+        return chan.base + chan.step * quantized_values_[chan.first_value + key];
+    }
+    return float_values_[chan.first_value + key];
+}
+
+sm::baked_animation sm::baked_animation::bake(
+        const compiled_animation& anim, const bake_options& opts) {
+    baked_animation baked;
+    baked.name_ = anim.name();
+    baked.duration_ = std::max(anim.duration(), 0);
+    baked.node_ids_ = anim.node_ids() | r::to<std::vector<piece_id>>();
+    baked.node_parents_ = anim.node_parents() | r::to<std::vector<uint32_t>>();
+
+    // channels are reduced as the poses are sampled, so baking holds only the samples
+    // since each channel's last key rather than every sample of every channel. Half of
+    // each tolerance goes to dropping keys and half to quantizing what is left.
+    auto node_count = baked.node_ids_.size();
+    auto channel_count = 2 * node_count;
+    auto sample_count = static_cast<size_t>(baked.duration_) + 1;
+    auto is_angle = [](size_t c) {
+        return c >= 2 && c % 2 == 0;
+    };
+    auto tolerance = [&](size_t c) {
+        return (is_angle(c)) ? opts.angle_tolerance : opts.distance_tolerance;
+    };
+    auto reducers = rv::iota(size_t{ 0 }, channel_count) |
+        rv::transform(
+            [&](size_t c) {
+                auto key_tolerance = (opts.quantize) ? tolerance(c) / 2.0 : tolerance(c);
+                return key_reducer(key_tolerance, is_angle(c));
+            }
+        ) | r::to<std::vector<key_reducer>>();
+
+    std::vector<point> pose;
+    std::vector<double> world_angles(node_count);
+    const auto& parents = baked.node_parents_;
+    for (size_t s = 0; s < sample_count; ++s) {
+        anim.evaluate(static_cast<double>(s), pose);
+        if (pose.empty()) {
+            break;
+        }
+        reducers[0].add(pose[0].x);
+        reducers[1].add(pose[0].y);
+        world_angles[0] = 0.0;
+        for (size_t i = 1; i < node_count; ++i) {
+            auto parent = parents[i];
+            auto dx = pose[i].x - pose[parent].x;
+            auto dy = pose[i].y - pose[parent].y;
+            world_angles[i] = std::atan2(dy, dx);
+            reducers[2 * i].add(world_angles[i] - world_angles[parent]);
+            reducers[2 * i + 1].add(std::hypot(dx, dy));
+        }
+    }
+
+    for (size_t c = 0; c < channel_count; ++c) {
+        auto& reducer = reducers[c];
+        reducer.finish();
+        auto keys = reducer.keys();
+        auto key_values = reducer.values();
+
+        channel chan{
+            static_cast<uint32_t>(baked.key_times_.size()),
+            static_cast<uint32_t>(keys.size()),
+            0, false, 0.0f, 0.0f
+        };
+        auto [min, max] = r::minmax(key_values);
+        auto base = static_cast<float>(min);
+        auto step = static_cast<float>((max - base) / k_max_quantized);
+        if (opts.quantize && step / 2.0 <= tolerance(c) / 2.0) {
+            chan.first_value = static_cast<uint32_t>(baked.quantized_values_.size());
+            chan.is_quantized = true;
+            chan.base = base;
+            chan.step = step;
+            for (auto val : key_values) {
+                auto q = (step > 0.0f) ? std::round((val - base) / step) : 0.0;
+                baked.quantized_values_.push_back(
+                    static_cast<uint16_t>(std::clamp(q, 0.0, k_max_quantized))
+                );
+            }
+        } else {
+            chan.first_value = static_cast<uint32_t>(baked.float_values_.size());
+            for (auto val : key_values) {
+                baked.float_values_.push_back(static_cast<float>(val));
+            }
+        }
+        baked.key_times_.insert(baked.key_times_.end(), keys.begin(), keys.end());
+        baked.channels_.push_back(chan);
+    }
+
+    // the seek cursors are laid out interval by interval, so that a seek reads those of
+    // every channel from one run of memory.
+    baked.seek_interval_ = std::max(opts.seek_interval, 1);
+    auto interval_count = static_cast<size_t>(baked.duration_ / baked.seek_interval_) + 1;
+    baked.seek_cursors_.resize(interval_count * channel_count);
+    for (size_t c = 0; c < channel_count; ++c) {
+        const auto& chan = baked.channels_[c];
+        const auto* keys = baked.key_times_.data() + chan.first_key;
+        uint32_t k = 0;
+        for (size_t i = 0; i < interval_count; ++i) {
+            auto start = i * baked.seek_interval_;
+            while (k + 1 < chan.key_count && keys[k + 1] <= start) {
+                ++k;
+            }
+            baked.seek_cursors_[i * channel_count + c] = k;
+        }
+    }
+
+    return baked;
+}
+
+std::string sm::baked_animation::name() const {
+    return name_;
+}
+
+int sm::baked_animation::duration() const {
+    return duration_;
+}
+
+size_t sm::baked_animation::node_count() const {
+    return node_ids_.size();
+}
+
+std::span<const sm::piece_id> sm::baked_animation::node_ids() const {
+    return node_ids_;
+}
+
+std::span<const sm::baked_animation::channel> sm::baked_animation::channels() const {
+    return channels_;
+}
+
+size_t sm::baked_animation::key_count() const {
+    return key_times_.size();
+}
+
+size_t sm::baked_animation::size_in_bytes() const {
+    return channels_.size() * sizeof(channel) +
+        key_times_.size() * sizeof(uint32_t) +
+        quantized_values_.size() * sizeof(uint16_t) +
+        float_values_.size() * sizeof(float) +
+        seek_cursors_.size() * sizeof(uint32_t);
+}
+
+std::vector<sm::point> sm::baked_animation::evaluate(double t) const {
+    std::vector<point> pose;
+    decoder(*this).evaluate(t, pose);
+    return pose;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "sm_types.h"
+#include "sm_playback.h"
+#include <vector>
+#include <span>
+#include <string>
+#include <cstdint>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace sm {
+
+    // how far a baked animation may stray from the animation it was baked from: angles in
+    // radians, bone lengths and the root's position in world units. Each bound covers both
+    // keyframe reduction and quantization, per channel; errors in angles compound down
+    // chains of bones when poses are rebuilt.
+
+    // every seek_interval ticks the baked animation records where each channel is among
+    // its keys, so that seeking costs a short scan per channel rather than a search.
+
+    struct bake_options {
+        double angle_tolerance = 1.0e-3;
+        double distance_tolerance = 1.0e-2;
+        bool quantize = true;
+        int seek_interval = 512;
+    };
+
+    // an animation baked into per-bone tracks. The compiled animation is sampled at every
+    // tick and each pose is stored as the root's position plus, for each bone, its angle
+    // relative to its parent bone and its length. Each of those is a channel; the root has
+    // channels 0 and 1 for x and y, and the bone above node i has channels 2i and 2i + 1 for
+    // its angle and length.
+    //
+    // A channel keeps only the samples that linear interpolation between them cannot
+    // reconstruct to within half its tolerance, and its values are quantized to 16 bits
+    // over their range when the step that gives is within the other half; otherwise they
+    // are stored as floats. Keys of all channels are packed in shared arrays, struct of
+    // arrays style, so an animation that holds still costs one key per channel.
+
+    class baked_animation {
+    public:
+
+        struct channel {
+            uint32_t first_key;
+            uint32_t key_count;
+            uint32_t first_value;
+            bool is_quantized;
+            float base;
+            float step;
+        };
+
+        // decodes poses from a baked animation, which it must not outlive. A decoder holds
+        // the segment each channel is in as struct of arrays: where the segment starts and
+        // ends, its first value, and its slope. Decoding a time checks every channel's
+        // segment in one pass and reloads only the ones the time has left, which when
+        // playing in order is the few channels that crossed a key. The rest of decoding is
+        // passes over contiguous arrays that compilers can vectorize: interpolating every
+        // channel, summing angles down the skeleton, taking their sines and cosines, and
+        // placing each node from its parent.
+
+        class decoder {
+            const baked_animation* anim_;
+            std::vector<uint32_t> cursors_;
+            std::vector<float> starts_;
+            std::vector<float> ends_;
+            std::vector<float> from_;
+            std::vector<float> slopes_;
+            std::vector<float> values_;
+            std::vector<float> angles_;
+            std::vector<float> cosines_;
+            std::vector<float> sines_;
+
+            void load_segment(size_t c, uint32_t k);
+            void seek_segment(size_t c, float t, std::span<const uint32_t> seek_cursors);
+
+        public:
+            decoder(const baked_animation& anim);
+            void evaluate(double t, std::vector<point>& pose);
+        };
+
+    private:
+
+        std::string name_;
+        int duration_;
+        std::vector<piece_id> node_ids_;
+        std::vector<uint32_t> node_parents_;
+        std::vector<channel> channels_;
+        std::vector<uint32_t> key_times_;
+        std::vector<uint16_t> quantized_values_;
+        std::vector<float> float_values_;
+        int seek_interval_;
+        std::vector<uint32_t> seek_cursors_;
+
+        baked_animation();
+        float value(const channel& chan, uint32_t key) const;
+
+    public:
+
+        static baked_animation bake(const compiled_animation& anim, const bake_options& opts = {});
+
+        std::string name() const;
+        int duration() const;
+        size_t node_count() const;
+        std::span<const piece_id> node_ids() const;
+        std::span<const channel> channels() const;
+        size_t key_count() const;
+
+        // the memory taken by the channels, their keys, and the seek cursors.
+        size_t size_in_bytes() const;
+
+        // the pose at time t, as node positions in the compiled animation's node order.
+        // Decoding many poses is faster through a decoder.
+        std::vector<point> evaluate(double t) const;
+    };
+}
@@ -3,8 +3,8 @@
 #include "sm_skeleton.h"
 #include "sm_fabrik.h"
 #include "sm_visit.h"
-#include "qdebug.h"
 #include <unordered_map>
+#include <unordered_set>
 
 using namespace std::placeholders;
 namespace r = std::ranges;
@@ -75,6 +75,10 @@ void sm::node::add_child(bone& b) {
 	children_.push_back(sm::ref(b));
 }
 
+sm::piece_id sm::node::id() const {
+	return id_;
+}
+
 std::string sm::node::name() const {
 	return name_;
 }
@@ -184,18 +188,6 @@ sm::point sm::node::world_pos() const {
 	return { x_, y_ };
 }
 
-std::any sm::node::get_user_data() const {
-	return user_data_;
-}
-
-void sm::node::set_user_data(std::any data) {
-	user_data_ = data;
-}
-
-void  sm::node::clear_user_data() {
-	user_data_.reset();
-}
-
 bool sm::node::is_root() const {
 	return std::holds_alternative<skel_ref>(parent_);
 }
@@ -209,6 +201,10 @@ sm::bone::bone(std::string name, sm::node& u, sm::node& v) :
 	length_ = scaled_length();
 }
 
+sm::piece_id sm::bone::id() const {
+	return id_;
+}
+
 void sm::bone::set_name(const std::string& new_name) {
 	name_ = new_name;
 }
@@ -388,18 +384,6 @@ sm::maybe_bone_ref  sm::bone::parent_bone() {
 	return u_.parent_bone();
 }
 
-std::any sm::bone::get_user_data() const {
-	return user_data_;
-}
-
-void sm::bone::set_user_data(std::any data) {
-	user_data_ = data;
-}
-
-void sm::bone::clear_user_data() {
-	user_data_.reset();
-}
-
 void sm::bone::set_world_rotation(double theta) {
 	rotate_by(theta - world_rotation());
 }
@@ -455,3 +439,109 @@ void sm::bone::set_length(double len) {
         bone->child_node().set_world_pos(new_child_node_pos);
     }
 }
+
+/*------------------------------------------------------------------------------------------------*/
+
+// a bone is below the set if it or one of its ancestors is in it. That is memoized along
+// every chain walked, so finding the topmost bones of the set visits each bone once.
+
+std::vector<sm::bone*> sm::downstream_bones(std::span<bone* const> bones) {
+    std::unordered_set<const bone*> in_set(bones.begin(), bones.end());
+    std::unordered_map<const bone*, bool> below_set;
+    auto is_below_set = [&](const bone& b)->bool {
+        std::vector<const bone*> chain;
+        bool below = false;
+        for (const bone* curr = &b; curr; ) {
+            if (in_set.contains(curr)) {
+                below = true;
+                break;
+            }
+            if (auto iter = below_set.find(curr); iter != below_set.end()) {
+                below = iter->second;
+                break;
+            }
+            chain.push_back(curr);
+            auto parent = curr->parent_bone();
+            curr = (parent) ? &parent->get() : nullptr;
+        }
+        for (auto* link : chain) {
+            below_set[link] = below;
+        }
+        return below;
+    };
+
+    std::vector<bone*> downstream;
+    std::unordered_set<const bone*> visited;
+    for (auto* top : bones) {
+        auto parent = top->parent_bone();
+        if ((parent && is_below_set(parent->get())) || visited.contains(top)) {
+            continue;
+        }
+        visit_bones(*top,
+            [&](bone& b)->visit_result {
+                visited.insert(&b);
+                downstream.push_back(&b);
+                return visit_result::continue_traversal;
+            }
+        );
+    }
+    return downstream;
+}
+
+void sm::set_length(std::span<bone* const> bones, double len) {
+    std::unordered_set<const bone*> in_set(bones.begin(), bones.end());
+    auto downstream = downstream_bones(bones);
+
+    // rotations are read before anything moves; each bone's parent node is final by the
+    // time the bone is reached.
+    auto rotations = downstream |
+        rv::transform([](bone* b) { return b->world_rotation(); }) |
+        r::to<std::vector<double>>();
+    for (size_t i = 0; i < downstream.size(); ++i) {
+        auto* b = downstream[i];
+        auto new_len = in_set.contains(b) ? len : b->length();
+        sm::point offset = {
+            new_len * std::cos(rotations[i]),
+            new_len * std::sin(rotations[i])
+        };
+        b->child_node().set_world_pos(b->parent_node().world_pos() + offset);
+    }
+}
+
+// the bones in the set are turned to the given rotation as bone::rotate_by() turns the bone
+// it rotates, and the bones below them keep their rotations relative to their parents.
+
+void sm::set_world_rotation(std::span<bone* const> bones, double theta) {
+    std::unordered_set<const bone*> in_set(bones.begin(), bones.end());
+    auto downstream = downstream_bones(bones);
+
+    struct bone_state {
+        double length;
+        double rel_rotation;
+        double new_world_rotation;
+    };
+    std::unordered_map<const bone*, bone_state> states;
+    states.reserve(downstream.size());
+    for (auto* b : downstream) {
+        auto world_rot = b->world_rotation();
+        auto rel_rot = in_set.contains(b) ? 0.0 : world_rot - b->parent_bone()->get().world_rotation();
+        states[b] = { b->scaled_length(), rel_rot, 0.0 };
+    }
+
+    for (auto* b : downstream) {
+        auto& state = states.at(b);
+        bool is_set = in_set.contains(b);
+        auto& u = b->parent_node();
+        auto rot = is_set ?
+            theta :
+            states.at(&b->parent_bone()->get()).new_world_rotation + state.rel_rotation;
+        auto new_v_pos = transform(
+            u.world_pos() + sm::point{ state.length, 0.0 },
+            rotate_about_point_matrix(u.world_pos(), rot)
+        );
+        auto prev = is_set ? maybe_bone_ref{} : b->parent_bone();
+        new_v_pos = sm::apply_rotation_constraints(new_v_pos, u, prev, *b);
+        b->child_node().set_world_pos(new_v_pos);
+        state.new_world_rotation = angle_from_u_to_v(u.world_pos(), new_v_pos);
+    }
+}
@@ -1,12 +1,13 @@
 #pragma once
 
 #include "sm_types.h"
+#include "sm_slots.h"
 #include <variant>
 #include <optional>
 #include <ranges>
 #include <vector>
+#include <span>
 #include <string>
-#include <any>
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -17,12 +18,12 @@ namespace sm {
 		friend class bone;
 		friend class skeleton;
 	private:
+		piece_id id_;
 		std::string name_;
 		double x_;
 		double y_;
 		std::variant<skel_ref, bone_ref> parent_;
 		std::vector<bone_ref> children_;
-		std::any user_data_;
 
 	protected:
 
@@ -32,6 +33,7 @@ namespace sm {
 		void set_name(const std::string& new_name);
 
 	public:
+		piece_id id() const;
 		std::string name() const;
         expected_node copy_to(skeleton& skel) const;
 
@@ -53,10 +55,6 @@ namespace sm {
 		point world_pos() const;
         void apply(matrix& mat);
 
-		std::any get_user_data() const;
-		void set_user_data(std::any data);
-		void clear_user_data();
-
 		bool is_root() const;
 	};
 
@@ -65,11 +63,11 @@ namespace sm {
 		friend class skeleton;
 	private:
 
+		piece_id id_;
 		std::string name_;
 		node& u_;
 		node& v_;
 		double length_;
-		std::any user_data_;
 		std::optional<rot_constraint> rot_constraint_;
 
 	protected:
@@ -78,6 +76,7 @@ namespace sm {
 		void set_name(const std::string& new_name);
 
 	public:
+		piece_id id() const;
 		std::string name() const;
         expected_bone copy_to(skeleton& skel) const;
 
@@ -117,13 +116,18 @@ namespace sm {
 		double scale() const;
 		double absolute_scale() const;
 
-		std::any get_user_data() const;
-		void set_user_data(std::any data);
-		void clear_user_data();
-
 		void set_world_rotation(double theta);
 		void rotate_by(double theta, sm::maybe_node_ref axis = {}, bool just_this_bone = false);
 		void set_length(double len);
 	};
 
+	// the given bones and every bone below them, each once and always after its parent.
+	std::vector<bone*> downstream_bones(std::span<bone* const> bones);
+
+	// bulk versions of bone::set_length() and bone::set_world_rotation(). Every bone in the
+	// set is handled in one pass over its downstream bones, so each node below the set moves
+	// exactly once however the bones nest, with the same result as setting them one at a
+	// time parents first.
+	void set_length(std::span<bone* const> bones, double len);
+	void set_world_rotation(std::span<bone* const> bones, double theta);
 }
\ No newline at end of file
@@ -0,0 +1,491 @@
+#include "sm_playback.h"
+#include "sm_skeleton.h"
+#include "sm_bone.h"
+#include <algorithm>
+#include <optional>
+#include <iterator>
+#include <unordered_map>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <ranges>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    using track = sm::compiled_animation::track;
+    using track_kind = sm::compiled_animation::track_kind;
+
+    // the skeleton's nodes in depth-first order, with the index of each node's parent node
+    // and the end of the run of indices below it. Iterative, since a long chain of bones is
+    // a deep tree.
+
+    struct node_order {
+        std::vector<const sm::node*> nodes;
+        std::vector<uint32_t> parents;
+        std::vector<uint32_t> subtree_end;
+        std::unordered_map<std::string, uint32_t> index;
+    };
+
+    node_order depth_first_order(const sm::skeleton& skel) {
+        node_order order;
+        auto& parents = order.parents;
+        std::vector<std::tuple<const sm::node*, uint32_t>> stack{
+            { &skel.root_node(), std::numeric_limits<uint32_t>::max() }
+        };
+        while (!stack.empty()) {
+            auto [node, parent] = stack.back();
+            stack.pop_back();
+            auto index = static_cast<uint32_t>(order.nodes.size());
+            order.nodes.push_back(node);
+            order.index[node->name()] = index;
+            parents.push_back(parent);
+            for (auto child : node->child_bones() | rv::reverse) {
+                stack.push_back({ &child->child_node(), index });
+            }
+        }
+
+        std::vector<uint32_t> sizes(order.nodes.size(), 1);
+        for (auto i = static_cast<uint32_t>(order.nodes.size()); i-- > 1; ) {
+            sizes[parents[i]] += sizes[i];
+        }
+        order.subtree_end = rv::iota(size_t{ 0 }, sizes.size()) |
+            rv::transform(
+                [&sizes](size_t i) { return static_cast<uint32_t>(i + sizes[i]); }
+            ) | r::to<std::vector<uint32_t>>();
+        return order;
+    }
+
+    std::expected<track, sm::result> compile_event(int start, const sm::rotation& rot,
+            const sm::skeleton& skel, const node_order& order) {
+        auto rotor = skel.get_by_name<sm::bone>(rot.rotor);
+        if (!rotor) {
+            return std::unexpected(sm::result::not_found);
+        }
+        auto u = order.index.at(rotor->get().parent_node().name());
+        auto v = order.index.at(rotor->get().child_node().name());
+        track trk{ start, rot.duration, track_kind::rotation, false, 0, v, order.subtree_end[v],
+            rot.theta, {0.0, 0.0} };
+        if (rot.axis == order.nodes[u]->name()) {
+            // turning about the parent node swings the rotor and everything below it.
+            trk.pivot = u;
+        } else if (rot.axis == order.nodes[v]->name()) {
+            // turning about the child node swings the rest of the skeleton instead.
+            trk.pivot = v;
+            trk.complement = true;
+        } else {
+            return std::unexpected(sm::result::not_found);
+        }
+        return trk;
+    }
+
+    std::expected<track, sm::result> compile_event(int start, const sm::translation& trans,
+            const sm::skeleton&, const node_order& order) {
+        auto iter = order.index.find(trans.subject);
+        if (iter == order.index.end()) {
+            return std::unexpected(sm::result::not_found);
+        }
+        auto subject = iter->second;
+        return track{ start, trans.duration, track_kind::translation, false, subject, subject,
+            order.subtree_end[subject], 0.0, trans.offset };
+    }
+
+    void move_nodes(const track& trk, std::span<sm::point> pose, auto move) {
+        if (!trk.complement) {
+            for (auto& pt : pose.subspan(trk.first, trk.last - trk.first)) {
+                move(pt);
+            }
+            return;
+        }
+        for (auto& pt : pose.first(trk.first)) {
+            move(pt);
+        }
+        for (auto& pt : pose.subspan(trk.last)) {
+            move(pt);
+        }
+    }
+
+    // the nodes a track moves: a node's subtree, which is a run of the depth-first order,
+    // or everything outside one. A run starting at the root holds every node, and any
+    // two complements hold the root.
+
+    struct moved_nodes {
+        uint32_t first;
+        uint32_t last;
+        bool complement;
+
+        moved_nodes(const track& trk) :
+            first(trk.first), last(trk.last), complement(trk.complement) {
+        }
+
+        bool contains(uint32_t node) const {
+            return (first <= node && node < last) != complement;
+        }
+
+        bool is_disjoint(const moved_nodes& other) const {
+            if (complement && other.complement) {
+                return false;
+            }
+            if (!complement && !other.complement) {
+                return last <= other.first || other.last <= first;
+            }
+            const auto& run = (complement) ? other : *this;
+            const auto& outside = (complement) ? *this : other;
+            return outside.first <= run.first && run.last <= outside.last;
+        }
+
+        bool includes(const moved_nodes& other) const {
+            if (!complement && !other.complement) {
+                return first <= other.first && other.last <= last;
+            }
+            if (complement && !other.complement) {
+                return other.is_disjoint({ first, last, false });
+            }
+            if (!complement) {
+                return first == 0;
+            }
+            return other.first <= first && last <= other.last;
+        }
+
+    private:
+        moved_nodes(uint32_t first, uint32_t last, bool complement) :
+            first(first), last(last), complement(complement) {
+        }
+    };
+
+    // whether applying two tracks in either order gives the same pose. Translations always
+    // commute, as do rotations of the same nodes about the same node. Otherwise either
+    // track must leave alone the nodes the other moves and the node it turns about, or one
+    // of them must move all of a rotation's nodes and its pivot: it then carries the
+    // rotation along rigidly, and rotations in the plane commute. A carried translation
+    // does not commute with a rotation, whose offset it would need turned.
+
+    bool commute(const track& a, const track& b) {
+        if (a.kind == track_kind::translation && b.kind == track_kind::translation) {
+            return true;
+        }
+        if (a.kind == b.kind && a.pivot == b.pivot && a.first == b.first &&
+                a.last == b.last && a.complement == b.complement) {
+            return true;
+        }
+        moved_nodes a_moved(a);
+        moved_nodes b_moved(b);
+        auto turns_about = [](const moved_nodes& moved, const track& trk) {
+            return trk.kind == track_kind::rotation && moved.contains(trk.pivot);
+        };
+        if (a_moved.is_disjoint(b_moved) && !turns_about(a_moved, b) &&
+                !turns_about(b_moved, a)) {
+            return true;
+        }
+        auto carries = [](const moved_nodes& outer, const track& inner,
+                const moved_nodes& inner_moved) {
+            return inner.kind == track_kind::rotation && outer.includes(inner_moved) &&
+                outer.contains(inner.pivot);
+        };
+        return carries(a_moved, b, b_moved) || carries(b_moved, a, a_moved);
+    }
+
+    void apply_track(const track& trk, double fraction, std::span<sm::point> pose) {
+        if (trk.kind == track_kind::translation) {
+            sm::point offset = { fraction * trk.offset.x, fraction * trk.offset.y };
+            move_nodes(trk, pose,
+                [offset](sm::point& pt) {
+                    pt.x += offset.x;
+                    pt.y += offset.y;
+                }
+            );
+            return;
+        }
+        auto pivot = pose[trk.pivot];
+        auto cos_theta = std::cos(fraction * trk.theta);
+        auto sin_theta = std::sin(fraction * trk.theta);
+        move_nodes(trk, pose,
+            [=](sm::point& pt) {
+                auto x = pt.x - pivot.x;
+                auto y = pt.y - pivot.y;
+                pt = { pivot.x + cos_theta * x - sin_theta * y, pivot.y + sin_theta * x + cos_theta * y };
+            }
+        );
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+double sm::compiled_animation::track::fraction(double t) const {
+    if (t < start) {
+        return 0.0;
+    }
+    if (duration <= 0) {
+        return 1.0;
+    }
+    return std::min(1.0, (t - start) / duration);
+}
+
+int sm::compiled_animation::track::end() const {
+    return start + std::max(duration, 0);
+}
+
+sm::compiled_animation::compiled_animation() :
+        duration_(0),
+        checkpoint_interval_(0) {
+}
+
+// the first compile takes the skeleton's node order and pose; later ones only check that the
+// skeleton still has the same nodes in the same order.
+
+sm::result sm::compiled_animation::compile_tracks(const animation& anim, const skeleton& skel) {
+    auto order = depth_first_order(skel);
+    if (node_ids_.empty()) {
+        node_ids_.reserve(order.nodes.size());
+        node_names_.reserve(order.nodes.size());
+        node_parents_ = order.parents;
+        rest_pose_.reserve(order.nodes.size());
+        for (const auto* node : order.nodes) {
+            node_ids_.push_back(node->id());
+            node_names_.push_back(node->name());
+            rest_pose_.push_back(node->world_pos());
+        }
+    } else if (!r::equal(node_ids_, order.nodes | rv::transform(&sm::node::id))) {
+        return result::not_found;
+    }
+
+    // the timeline is keyed by start time, so the tracks come out sorted.
+    std::vector<track> tracks;
+    int duration = 0;
+    for (const auto& [start, events] : anim.timeline()) {
+        for (const auto& event : events) {
+            auto trk = std::visit(
+                [&](const auto& evt) {
+                    return compile_event(start, evt, skel, order);
+                },
+                event
+            );
+            if (!trk) {
+                return trk.error();
+            }
+            duration = std::max(duration, trk->end());
+            tracks.push_back(*trk);
+        }
+    }
+    tracks_ = std::move(tracks);
+    duration_ = duration;
+    return result::success;
+}
+
+// checkpoint k is at time k * interval. Each one continues from the one before it, taking
+// that checkpoint's pending tracks followed by the tracks started since, in order. Each is
+// baked in if it has finished and commutes with every track left pending ahead of it, which
+// moves it ahead of them; otherwise it stays pending.
+
+void sm::compiled_animation::build_checkpoints(size_t first) {
+    auto node_count = rest_pose_.size();
+    if (node_count == 0) {
+        return;
+    }
+    auto interval = std::max(options_.interval, 1);
+    auto bytes_per_checkpoint = node_count * sizeof(point);
+    auto count_at = [&](int interval) {
+        return static_cast<size_t>(duration_ / interval) + 1;
+    };
+    while (count_at(interval) * bytes_per_checkpoint > options_.memory_budget &&
+            interval < duration_) {
+        interval *= 2;
+    }
+    if (interval != checkpoint_interval_) {
+        checkpoint_interval_ = interval;
+        first = 0;
+    }
+
+    auto count = count_at(interval);
+    first = std::min(first, checkpoint_covers_.size());
+    checkpoint_covers_.resize(first);
+    pending_offsets_.resize(first + 1);
+    pending_tracks_.resize(pending_offsets_[first]);
+    checkpoints_.resize(count * node_count);
+
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> pending;
+    for (auto k = first; k < count; ++k) {
+        std::span<point> pose(checkpoints_.data() + k * node_count, node_count);
+        uint32_t covered = 0;
+        candidates.clear();
+        if (k == 0) {
+            r::copy(rest_pose_, pose.begin());
+        } else {
+            r::copy(checkpoint(k - 1), pose.begin());
+            r::copy(pending_tracks(k - 1), std::back_inserter(candidates));
+            covered = checkpoint_covers_[k - 1];
+        }
+        auto time = static_cast<int>(k) * interval;
+        for (; covered < tracks_.size() && tracks_[covered].start <= time; ++covered) {
+            candidates.push_back(covered);
+        }
+
+        pending.clear();
+        for (auto index : candidates) {
+            const auto& trk = tracks_[index];
+            auto can_bake = trk.end() <= time && r::all_of(pending,
+                [&](uint32_t ahead) { return commute(tracks_[ahead], trk); }
+            );
+            if (can_bake) {
+                apply_track(trk, 1.0, pose);
+            } else {
+                pending.push_back(index);
+            }
+        }
+        checkpoint_covers_.push_back(covered);
+        pending_tracks_.insert(pending_tracks_.end(), pending.begin(), pending.end());
+        pending_offsets_.push_back(static_cast<uint32_t>(pending_tracks_.size()));
+    }
+}
+
+std::span<const sm::point> sm::compiled_animation::checkpoint(size_t index) const {
+    auto node_count = rest_pose_.size();
+    return { checkpoints_.data() + index * node_count, node_count };
+}
+
+std::span<const uint32_t> sm::compiled_animation::pending_tracks(size_t index) const {
+    return {
+        pending_tracks_.data() + pending_offsets_[index],
+        pending_offsets_[index + 1] - pending_offsets_[index]
+    };
+}
+
+std::expected<sm::compiled_animation, sm::result> sm::compiled_animation::compile(
+        const animation& anim, const skeleton& skel, const checkpoint_options& opts) {
+    compiled_animation compiled;
+    compiled.name_ = anim.name();
+    compiled.options_ = opts;
+    auto res = compiled.compile_tracks(anim, skel);
+    if (res != result::success) {
+        return std::unexpected(res);
+    }
+    compiled.build_checkpoints(0);
+    return compiled;
+}
+
+// a checkpoint before the edited time only covers tracks that started before it, all of
+// which start before the edit and keep their places in the track order.
+
+sm::result sm::compiled_animation::update(
+        const animation& anim, const skeleton& skel, int edited_time) {
+    auto res = compile_tracks(anim, skel);
+    if (res != result::success) {
+        return res;
+    }
+    size_t still_valid = 0;
+    if (checkpoint_interval_ > 0 && edited_time > 0) {
+        still_valid = static_cast<size_t>((edited_time - 1) / checkpoint_interval_) + 1;
+    }
+    build_checkpoints(still_valid);
+    return result::success;
+}
+
+std::string sm::compiled_animation::name() const {
+    return name_;
+}
+
+size_t sm::compiled_animation::node_count() const {
+    return node_ids_.size();
+}
+
+int sm::compiled_animation::duration() const {
+    return duration_;
+}
+
+std::span<const sm::compiled_animation::track> sm::compiled_animation::tracks() const {
+    return tracks_;
+}
+
+std::span<const sm::point> sm::compiled_animation::rest_pose() const {
+    return rest_pose_;
+}
+
+std::span<const sm::piece_id> sm::compiled_animation::node_ids() const {
+    return node_ids_;
+}
+
+std::span<const uint32_t> sm::compiled_animation::node_parents() const {
+    return node_parents_;
+}
+
+const std::string& sm::compiled_animation::node_name(size_t index) const {
+    return node_names_.at(index);
+}
+
+int sm::compiled_animation::checkpoint_interval() const {
+    return checkpoint_interval_;
+}
+
+size_t sm::compiled_animation::checkpoint_count() const {
+    return checkpoint_covers_.size();
+}
+
+// the latest checkpoint at or before t, or none before the first one or without any.
+
+std::optional<size_t> sm::compiled_animation::checkpoint_before(double t) const {
+    if (checkpoint_covers_.empty() || t < 0) {
+        return {};
+    }
+    return std::min(
+        static_cast<size_t>(t / checkpoint_interval_), checkpoint_covers_.size() - 1
+    );
+}
+
+size_t sm::compiled_animation::tracks_started(double t) const {
+    auto started = r::upper_bound(tracks_, t, {},
+        [](const track& trk) { return static_cast<double>(trk.start); }
+    );
+    return static_cast<size_t>(started - tracks_.begin());
+}
+
+void sm::compiled_animation::evaluate(double t, std::vector<point>& pose) const {
+    size_t first = 0;
+    auto k = checkpoint_before(t);
+    if (!k) {
+        pose.assign(rest_pose_.begin(), rest_pose_.end());
+    } else {
+        auto from = checkpoint(*k);
+        pose.assign(from.begin(), from.end());
+        for (auto index : pending_tracks(*k)) {
+            apply_track(tracks_[index], tracks_[index].fraction(t), pose);
+        }
+        first = checkpoint_covers_[*k];
+    }
+    for (const auto& trk : std::span(tracks_).subspan(first, tracks_started(t) - first)) {
+        apply_track(trk, trk.fraction(t), pose);
+    }
+}
+
+size_t sm::compiled_animation::tracks_replayed(double t) const {
+    auto k = checkpoint_before(t);
+    if (!k) {
+        return tracks_started(t);
+    }
+    return pending_tracks(*k).size() + tracks_started(t) - checkpoint_covers_[*k];
+}
+
+std::vector<sm::point> sm::compiled_animation::evaluate(double t) const {
+    std::vector<point> pose;
+    evaluate(t, pose);
+    return pose;
+}
+
+sm::result sm::compiled_animation::apply(std::span<const point> pose, skeleton& skel) const {
+    if (pose.size() != node_ids_.size()) {
+        return result::out_of_bounds;
+    }
+    auto& world = skel.owner();
+    for (size_t i = 0; i < pose.size(); ++i) {
+        auto* node = world.from_id<sm::node>(node_ids_[i]);
+        if (!node) {
+            return result::not_found;
+        }
+        node->set_world_pos(pose[i]);
+    }
+    return result::success;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "sm_types.h"
+#include "sm_slots.h"
+#include "sm_animation.h"
+#include <vector>
+#include <span>
+#include <string>
+#include <expected>
+#include <optional>
+#include <cstdint>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace sm {
+
+    class skeleton;
+
+    // how densely a compiled animation checkpoints its poses. The interval is widened as
+    // needed to keep the checkpoints within the memory budget.
+
+    struct checkpoint_options {
+        int interval = 100;
+        size_t memory_budget = 64 * 1024 * 1024;
+    };
+
+    // an animation compiled against its skeleton for playback. The axis, rotor, and subject
+    // names of the events are resolved to node indices once, and the events become a flat
+    // array of tracks sorted by start time. Nodes are indexed in depth-first order from the
+    // root, so the nodes below any node form a contiguous run of indices and every track
+    // moves either one run of the pose or everything outside one.
+    //
+    // The pose at time t starts from the skeleton's pose when it was compiled and applies,
+    // in order, every track that has started by t, scaled by how much of its duration has
+    // elapsed. A rotation turns the side of the rotor bone away from the axis node about
+    // the axis node's current position; a translation moves the subject node and the nodes
+    // below it. Rotation constraints are not applied: events play back as authored.
+    //
+    // Since tracks accumulate, poses are checkpointed every so often as packed arrays of node
+    // positions. A checkpoint covers the tracks that have started by its time. Those that
+    // have finished are baked into its pose, except a finished track that cannot be moved
+    // ahead of a track still running at that time; it stays pending with the running ones.
+    // Every track moves its nodes rigidly, and rotations in the plane commute, so a
+    // finished track can be moved ahead of a running one when each leaves alone whatever
+    // the other moves or turns about, or when one of them carries all of a rotation's nodes
+    // and the node it turns about. Evaluating t starts from the latest checkpoint at or
+    // before t, replays its pending tracks, then applies the tracks started since. A seek
+    // therefore replays the tracks started within one interval plus those pending at the
+    // checkpoint. The pending ones are usually just the tracks still running, however far t
+    // is into the timeline; only finished tracks that move nodes another running track
+    // turns about, without being carried by it, add to them.
+
+    class compiled_animation {
+    public:
+
+        enum class track_kind : uint8_t {
+            rotation,
+            translation
+        };
+
+        struct track {
+            int start;
+            int duration;
+            track_kind kind;
+            bool complement;
+            uint32_t pivot;
+            uint32_t first;
+            uint32_t last;
+            double theta;
+            point offset;
+
+            // how much of the track applies at time t, from 0 before it starts to 1 once
+            // its duration has elapsed.
+            double fraction(double t) const;
+            int end() const;
+        };
+
+    private:
+
+        std::string name_;
+        std::vector<piece_id> node_ids_;
+        std::vector<std::string> node_names_;
+        std::vector<uint32_t> node_parents_;
+        std::vector<point> rest_pose_;
+        std::vector<track> tracks_;
+        int duration_;
+        checkpoint_options options_;
+        int checkpoint_interval_;
+        std::vector<uint32_t> checkpoint_covers_;
+        std::vector<uint32_t> pending_offsets_;
+        std::vector<uint32_t> pending_tracks_;
+        std::vector<point> checkpoints_;
+
+        compiled_animation();
+        result compile_tracks(const animation& anim, const skeleton& skel);
+        void build_checkpoints(size_t first);
+        std::span<const point> checkpoint(size_t index) const;
+        std::span<const uint32_t> pending_tracks(size_t index) const;
+        std::optional<size_t> checkpoint_before(double t) const;
+        size_t tracks_started(double t) const;
+
+    public:
+
+        static std::expected<compiled_animation, result> compile(
+            const animation& anim, const skeleton& skel, const checkpoint_options& opts = {});
+
+        // recompiles the animation's tracks after an edit to the events starting at or after
+        // the given time. Only the checkpoints from that time on are rebuilt. The skeleton
+        // must still have the nodes the animation was compiled against.
+        result update(const animation& anim, const skeleton& skel, int edited_time);
+
+        std::string name() const;
+        size_t node_count() const;
+        int duration() const;
+        std::span<const track> tracks() const;
+        std::span<const point> rest_pose() const;
+        std::span<const piece_id> node_ids() const;
+
+        // the index of each node's parent node, or the largest uint32_t for the root.
+        std::span<const uint32_t> node_parents() const;
+        const std::string& node_name(size_t index) const;
+        int checkpoint_interval() const;
+        size_t checkpoint_count() const;
+
+        // the pose at time t, as node positions in the compiled node order. The overload
+        // taking a vector reuses its storage.
+        void evaluate(double t, std::vector<point>& pose) const;
+        std::vector<point> evaluate(double t) const;
+
+        // how many tracks evaluating t applies on top of the checkpoint it starts from.
+        size_t tracks_replayed(double t) const;
+
+        // moves the skeleton's nodes to the given pose.
+        result apply(std::span<const point> pose, skeleton& skel) const;
+    };
+}
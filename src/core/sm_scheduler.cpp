@@ -0,0 +1,156 @@
+#include "sm_scheduler.h"
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cmath>
+
+namespace chr = std::chrono;
+
+/*------------------------------------------------------------------------------------------------*/
+
+sm::playback_clock sm::playback_clock::steady() {
+    using seconds = chr::duration<double>;
+    return {
+        []() {
+            return chr::duration_cast<seconds>(
+                chr::steady_clock::now().time_since_epoch()
+            ).count();
+        },
+        [](double t, std::stop_token token) {
+            chr::steady_clock::time_point deadline(
+                chr::duration_cast<chr::steady_clock::duration>(seconds(t))
+            );
+            std::mutex mutex;
+            std::condition_variable_any stopped;
+            std::unique_lock lock(mutex);
+            stopped.wait_until(lock, token, deadline, []() { return false; });
+        }
+    };
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+sm::playback_scheduler::playback_scheduler(std::shared_ptr<const compiled_animation> anim,
+            const playback_options& opts, playback_clock clock) :
+        anim_(std::move(anim)),
+        options_(opts),
+        clock_(std::move(clock)),
+        back_(0),
+        middle_(1),
+        front_(2),
+        is_playing_(false),
+        ticks_played_(0),
+        dropped_frames_(0),
+        late_frames_(0) {
+    // poses are evaluated into storage reserved up front, so the worker never allocates.
+    for (auto& frame : frames_) {
+        frame.positions.reserve(anim_->node_count());
+    }
+}
+
+sm::playback_scheduler::~playback_scheduler() {
+    stop();
+}
+
+// ticks are scheduled from a fixed origin rather than from one another, so time spent
+// evaluating a pose does not accumulate as drift.
+
+void sm::playback_scheduler::run(std::stop_token token, double from) {
+    auto period = 1.0 / options_.frames_per_second;
+    auto duration = static_cast<double>(anim_->duration());
+    auto origin = clock_.now();
+    uint64_t tick = 0;
+    while (!token.stop_requested()) {
+        clock_.sleep_until(origin + tick * period, token);
+        if (token.stop_requested()) {
+            break;
+        }
+        auto elapsed = std::max(clock_.now() - origin, 0.0);
+        auto due = static_cast<uint64_t>(std::floor(elapsed / period));
+        if (due > tick) {
+            dropped_frames_ += due - tick;
+            tick = due;
+        }
+
+        auto time = from + static_cast<double>(tick);
+        bool is_last = false;
+        if (options_.loop) {
+            time = (duration > 0.0) ? std::fmod(time, duration) : 0.0;
+        } else if (time >= duration) {
+            time = duration;
+            is_last = true;
+        }
+
+        auto& frame = frames_[back_];
+        frame.tick = tick;
+        frame.time = time;
+        anim_->evaluate(time, frame.positions);
+        publish();
+        ++ticks_played_;
+        if (clock_.now() > origin + (tick + 1) * period) {
+            ++late_frames_;
+        }
+
+        if (is_last) {
+            break;
+        }
+        ++tick;
+    }
+    is_playing_ = false;
+}
+
+void sm::playback_scheduler::publish() {
+    back_ = middle_.exchange(back_ | k_fresh, std::memory_order_acq_rel) & ~k_fresh;
+}
+
+void sm::playback_scheduler::start(double from) {
+    stop();
+    back_ = 0;
+    middle_ = 1;
+    front_ = 2;
+    ticks_played_ = 0;
+    dropped_frames_ = 0;
+    late_frames_ = 0;
+    is_playing_ = true;
+    worker_ = std::jthread(
+        [this, from](std::stop_token token) {
+            run(token, from);
+        }
+    );
+}
+
+// reassigning the worker requests it to stop and joins it.
+
+void sm::playback_scheduler::stop() {
+    worker_ = {};
+    is_playing_ = false;
+}
+
+bool sm::playback_scheduler::is_playing() const {
+    return is_playing_;
+}
+
+const sm::pose_frame* sm::playback_scheduler::take_latest() {
+    if (!(middle_.load(std::memory_order_acquire) & k_fresh)) {
+        return nullptr;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~k_fresh;
+    return &frames_[front_];
+}
+
+const sm::compiled_animation& sm::playback_scheduler::animation() const {
+    return *anim_;
+}
+
+uint64_t sm::playback_scheduler::ticks_played() const {
+    return ticks_played_;
+}
+
+uint64_t sm::playback_scheduler::dropped_frames() const {
+    return dropped_frames_;
+}
+
+uint64_t sm::playback_scheduler::late_frames() const {
+    return late_frames_;
+}
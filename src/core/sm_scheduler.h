@@ -0,0 +1,95 @@
+#pragma once
+
+#include "sm_types.h"
+#include "sm_playback.h"
+#include <vector>
+#include <array>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <stop_token>
+#include <atomic>
+#include <cstdint>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace sm {
+
+    // where a playback scheduler gets the time, in seconds, and how it waits for a tick.
+    // Waiting must return early once stop is requested on the token. The steady clock is the
+    // real one; anything else, e.g. a clock whose waits just advance its time, can be
+    // substituted to drive a scheduler without real time passing.
+
+    struct playback_clock {
+        std::function<double()> now;
+        std::function<void(double, std::stop_token)> sleep_until;
+
+        static playback_clock steady();
+    };
+
+    // animation time advances one unit per tick.
+
+    struct playback_options {
+        double frames_per_second = 30.0;
+        bool loop = false;
+    };
+
+    struct pose_frame {
+        uint64_t tick = 0;
+        double time = 0.0;
+        std::vector<point> positions;
+    };
+
+    // plays a compiled animation on a worker thread. Each tick of a fixed timestep the
+    // worker evaluates the pose at the tick's time and publishes it through a triple
+    // buffer: it writes into a back frame and swaps it with the middle one, while the
+    // consumer swaps the middle frame into its front one whenever it wants the latest pose.
+    // Neither side ever waits on the other, and the consumer always gets a complete pose.
+    //
+    // A worker that falls behind skips to the tick that is due rather than playing the ones
+    // it missed, counting them as dropped. A tick whose pose is published after the next
+    // tick was due is counted as late.
+
+    class playback_scheduler {
+
+        constexpr static uint8_t k_fresh = 4;
+
+        std::shared_ptr<const compiled_animation> anim_;
+        playback_options options_;
+        playback_clock clock_;
+        std::array<pose_frame, 3> frames_;
+        uint8_t back_;
+        std::atomic<uint8_t> middle_;
+        uint8_t front_;
+        std::atomic<bool> is_playing_;
+        std::atomic<uint64_t> ticks_played_;
+        std::atomic<uint64_t> dropped_frames_;
+        std::atomic<uint64_t> late_frames_;
+        std::jthread worker_;
+
+        void run(std::stop_token token, double from);
+        void publish();
+
+    public:
+        playback_scheduler(std::shared_ptr<const compiled_animation> anim,
+            const playback_options& opts = {}, playback_clock clock = playback_clock::steady());
+        playback_scheduler(const playback_scheduler&) = delete;
+        playback_scheduler& operator=(const playback_scheduler&) = delete;
+        ~playback_scheduler();
+
+        // restarts playback from the given animation time, resetting the frame counts.
+        void start(double from = 0.0);
+        void stop();
+        bool is_playing() const;
+
+        // the most recently published pose if there is one the caller has not taken yet,
+        // otherwise null. The frame stays valid until the next call. Only one thread may
+        // consume poses.
+        const pose_frame* take_latest();
+
+        const compiled_animation& animation() const;
+        uint64_t ticks_played() const;
+        uint64_t dropped_frames() const;
+        uint64_t late_frames() const;
+    };
+}
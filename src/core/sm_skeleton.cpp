@@ -179,6 +179,31 @@ namespace {
 		);
 		return bones;
 	}
+
+	// a batch of renames is applied as a whole so that it may permute names, e.g. swap
+	// "node-1" and "node-2", as long as the final set of names is unique.
+
+	template<typename T>
+	bool can_rename_all(const std::unordered_map<std::string, T*>& tbl,
+			const sm::skeleton::renames& renames) {
+		std::unordered_set<std::string> vacated;
+		std::unordered_set<std::string> claimed;
+		for (const auto& [old_name, new_name] : renames) {
+			if (!tbl.contains(old_name)) {
+				return false;
+			}
+			vacated.insert(old_name);
+		}
+		for (const auto& [old_name, new_name] : renames) {
+			if (tbl.contains(new_name) && !vacated.contains(new_name)) {
+				return false;
+			}
+			if (!claimed.insert(new_name).second) {
+				return false;
+			}
+		}
+		return true;
+	}
 	
 }
 
@@ -226,6 +251,10 @@ void sm::skeleton::on_new_bone(sm::bone& b) {
 	}
 }
 
+sm::piece_id sm::skeleton::id() const {
+	return id_;
+}
+
 std::string sm::skeleton::name() const {
 	return name_;
 }
@@ -242,18 +271,6 @@ const sm::node& sm::skeleton::root_node() const {
 	return root_.value();
 }
 
-std::any sm::skeleton::get_user_data() const {
-	return user_data_;
-}
-
-void sm::skeleton::set_user_data(std::any data) {
-	user_data_ = data;
-}
-
-void sm::skeleton::clear_user_data() {
-	user_data_.reset();
-}
-
 sm::expected_skel sm::skeleton::copy_to(world& other_world, const std::string& new_name) const {
     auto name = (new_name.empty()) ? name_ : new_name;
     auto new_skel = other_world.create_skeleton(name);
@@ -272,6 +289,46 @@ sm::expected_skel sm::skeleton::copy_to(world& other_world, const std::string& n
     return new_skel;
 }
 
+sm::skeleton_snapshot sm::skeleton::snapshot() const {
+    skeleton_snapshot snap;
+    snap.name = name_;
+    snap.id = id_;
+    snap.root = 0;
+
+    auto n = nodes_.size();
+    std::unordered_map<const node*, int> node_to_index;
+    node_to_index.reserve(n);
+    snap.node_names.reserve(n);
+    snap.node_ids.reserve(n);
+    snap.node_positions.reserve(n);
+    for (const auto& [name, node_ptr] : nodes_) {
+        if (node_ptr == &root_node()) {
+            snap.root = static_cast<int>(snap.node_names.size());
+        }
+        node_to_index[node_ptr] = static_cast<int>(snap.node_names.size());
+        snap.node_names.push_back(name);
+        snap.node_ids.push_back(node_ptr->id());
+        snap.node_positions.push_back(node_ptr->world_pos());
+    }
+
+    auto m = bones_.size();
+    snap.bone_names.reserve(m);
+    snap.bone_ids.reserve(m);
+    snap.bone_nodes.reserve(m);
+    snap.bone_constraints.reserve(m);
+    for (const auto& [name, bone_ptr] : bones_) {
+        snap.bone_names.push_back(name);
+        snap.bone_ids.push_back(bone_ptr->id());
+        snap.bone_nodes.emplace_back(
+            node_to_index.at(&bone_ptr->parent_node()),
+            node_to_index.at(&bone_ptr->child_node())
+        );
+        snap.bone_constraints.push_back(bone_ptr->rotation_constraint());
+    }
+
+    return snap;
+}
+
 sm::result sm::skeleton::set_name(bone& bone, const std::string& new_name) {
 	if (bones_.contains(new_name)) {
 		return result::non_unique_name;
@@ -296,6 +353,32 @@ sm::result sm::skeleton::set_name(node& node, const std::string& new_name) {
 	return result::success;
 }
 
+sm::result sm::skeleton::set_names(const renames& node_renames, const renames& bone_renames) {
+    if (!can_rename_all(nodes_, node_renames) || !can_rename_all(bones_, bone_renames)) {
+        return result::non_unique_name;
+    }
+
+    auto rename_all = [](auto& tbl, const renames& renames) {
+        auto pieces = renames | rv::transform(
+                [&tbl](const auto& rename) {
+                    return tbl.at(std::get<0>(rename));
+                }
+            ) | r::to<std::vector>();
+        for (const auto& [old_name, new_name] : renames) {
+            tbl.erase(old_name);
+        }
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            const auto& new_name = std::get<1>(renames[i]);
+            pieces[i]->set_name(new_name);
+            tbl[new_name] = pieces[i];
+        }
+    };
+    rename_all(nodes_, node_renames);
+    rename_all(bones_, bone_renames);
+
+    return result::success;
+}
+
 sm::result sm::skeleton::from_json(sm::world& w, const json& jobj) {
     name_ = jobj["name"];
     nodes_ = jobj["nodes"] |
@@ -378,8 +461,8 @@ void sm::skeleton::register_node(sm::node& new_node) {
 }
 
 void sm::skeleton::register_bone(sm::bone& new_bone) {
-    if (contains<node>(new_bone.name()) || &new_bone.owner() != this) {
-        throw std::runtime_error("sm::skeleton::register_node failed");
+    if (contains<bone>(new_bone.name()) || &new_bone.owner() != this) {
+        throw std::runtime_error("sm::skeleton::register_bone failed");
     }
     bones_[new_bone.name()] = &new_bone;
 }
@@ -422,6 +505,9 @@ sm::world& sm::world::operator=(world&& other) {
     skeletons_ = std::move(other.skeletons_);
     bones_ = std::move(other.bones_);
     nodes_ = std::move(other.nodes_);
+    skeleton_ids_ = std::move(other.skeleton_ids_);
+    node_ids_ = std::move(other.node_ids_);
+    bone_ids_ = std::move(other.bone_ids_);
 
     for (auto& pair : skeletons_) {
         pair.second->set_owner(*this);
@@ -433,6 +519,9 @@ void sm::world::clear() {
     skeletons_.clear();
     bones_.clear();
     nodes_.clear();
+    skeleton_ids_.clear();
+    node_ids_.clear();
+    bone_ids_.clear();
 }
 
 bool sm::world::empty() const {
@@ -442,7 +531,9 @@ bool sm::world::empty() const {
 sm::skeleton& sm::world::create_skeleton(double x, double y) {
 	auto new_name = unique_name("skeleton", skeleton_names());
 	skeletons_.emplace( new_name, skeleton::make_unique( *this, new_name, x, y ) );
-	return *skeletons_[new_name];
+	auto& skel = *skeletons_[new_name];
+	assign_id(skel);
+	return skel;
 }
 
 sm::skeleton& sm::world::create_skeleton(const point& pt) {
@@ -456,6 +547,7 @@ sm::expected_skel sm::world::create_skeleton(const std::string& name) {
     skeletons_.emplace(name, skeleton::make_unique(*this));
     auto& skel = *skeletons_[name];
     skel.set_name(name);
+    assign_id(skel);
 
     return sm::ref(skel);
 }
@@ -519,6 +611,14 @@ sm::result sm::world::delete_skeleton(const std::string& skel_name) {
             }
         ) | r::to<std::unordered_set<const node*>>();
 
+    for (auto* bone : bone_set) {
+        bone_ids_.erase(bone->id());
+    }
+    for (auto* node : node_set) {
+        node_ids_.erase(node->id());
+    }
+    skeleton_ids_.erase(skel.id());
+
     delete_ptrs_if<sm::bone>(bones_,
         [&bone_set](const sm::bone& e)->bool {
             return bone_set.contains(&e);
@@ -561,6 +661,7 @@ sm::result sm::world::set_name(sm::skeleton& skel, const std::string& new_name)
 sm::node_ref sm::world::create_node(sm::skeleton& parent, const std::string& name, 
         double x, double y) {
     nodes_.push_back(node::make_unique(parent, name, x, y));
+    assign_id(*nodes_.back());
     return *nodes_.back();
 }
 
@@ -579,11 +680,12 @@ sm::expected_bone sm::world::create_bone_in_skeleton(
         return std::unexpected(sm::result::cross_skeleton_bone);
     }
     bones_.push_back(bone::make_unique(bone_name, u, v));
+    assign_id(*bones_.back());
     return *bones_.back();
 }
 
 std::expected<sm::bone_ref, sm::result> sm::world::create_bone(
-        const std::string& bone_name, node& u, node& v) {
+        const std::string& bone_name, node& u, node& v, piece_id id) {
 
     if (!v.is_root()) {
         return std::unexpected(sm::result::multi_parent_node);
@@ -595,15 +697,426 @@ std::expected<sm::bone_ref, sm::result> sm::world::create_bone(
         return std::unexpected(sm::result::cyclic_bones);
     }
 
+	skeleton_ids_.erase(skel_v.id());
 	skeletons_.erase(skel_v.name());
 
     std::string name = (bone_name.empty()) ? "bone-1" : bone_name;
 	bones_.push_back(bone::make_unique("bone-1", u, v));
+	assign_id(*bones_.back(), id);
 	skel_u.on_new_bone( *bones_.back() );
 
     return *bones_.back();
 }
 
+// removes the given bone from its skeleton and moves the subtree below the bone's child
+// node into a new skeleton, in place; this is the inverse of create_bone. If an id is given
+// and is available the new skeleton reclaims it, e.g. the id the skeleton had before it was
+// merged away by create_bone.
+
+sm::expected_skel sm::world::split_skeleton(sm::bone& bone, const std::string& new_skel_name,
+        piece_id id) {
+    if (contains_skeleton(new_skel_name)) {
+        return std::unexpected(result::non_unique_name);
+    }
+
+    auto& old_skel = bone.owner();
+    auto& u = bone.parent_node();
+    auto& v = bone.child_node();
+
+    std::vector<sm::node_ref> moved_nodes;
+    std::vector<sm::bone_ref> moved_bones;
+    visit_nodes_and_bones(v,
+        [&](sm::node& n)->visit_result {
+            moved_nodes.push_back(n);
+            return visit_result::continue_traversal;
+        },
+        [&](sm::bone& b)->visit_result {
+            moved_bones.push_back(b);
+            return visit_result::continue_traversal;
+        },
+        true
+    );
+
+    skeletons_.emplace(new_skel_name, skeleton::make_unique(*this));
+    auto& new_skel = *skeletons_[new_skel_name];
+    new_skel.set_name(new_skel_name);
+    assign_id(new_skel, id);
+
+    std::erase_if(u.children_, [&bone](auto b) { return b.ptr() == &bone; });
+    v.parent_ = sm::ref(new_skel);
+    new_skel.set_root(v);
+
+    old_skel.bones_.erase(bone.name());
+    for (auto node : moved_nodes) {
+        old_skel.nodes_.erase(node->name());
+        new_skel.nodes_[node->name()] = node.ptr();
+    }
+    for (auto b : moved_bones) {
+        old_skel.bones_.erase(b->name());
+        new_skel.bones_[b->name()] = b.ptr();
+    }
+
+    bone_ids_.erase(bone.id());
+    delete_ptrs_if<sm::bone>(bones_,
+        [&bone](const sm::bone& b)->bool {
+            return &b == &bone;
+        }
+    );
+
+    return sm::ref(new_skel);
+}
+
+// recreates a bone under a different parent node, keeping its id, name, length, and rotation
+// constraint. A bone's nodes cannot be reseated, so the old bone is cut out of its parent
+// node's children and left for the caller to delete.
+
+sm::bone& sm::world::reparent_bone(sm::bone& b, sm::node& new_parent) {
+    auto id = b.id();
+    std::erase_if(b.u_.children_, [&b](auto child) { return child.ptr() == &b; });
+    bone_ids_.erase(id);
+    b.id_ = {};
+
+    bones_.push_back(bone::make_unique(b.name(), new_parent, b.v_));
+    auto& moved = *bones_.back();
+    assign_id(moved, id);
+    moved.length_ = b.length_;
+    moved.rot_constraint_ = b.rot_constraint_;
+    return moved;
+}
+
+// removes the given nodes and bones from a skeleton in place. What survives falls apart into
+// connected components: the one holding the old root, or failing that the first one, stays
+// in the skeleton, and the others are moved, not copied, into new skeletons. A removed node
+// whose parent bone survives stays on as that bone's endpoint, and any surviving bones below
+// a removed node are moved onto copies of it, so each side of the cut keeps its own copy.
+// Components are ordered and the new skeletons named by piece names alone, so removing the
+// same pieces from the same skeleton always gives the same result. Passing the record of an
+// earlier removal of the same pieces has the new skeletons and copies reclaim its ids.
+
+std::expected<sm::piece_removal, sm::result> sm::world::remove_pieces(sm::skeleton& skel,
+        const std::vector<node_ref>& nodes, const std::vector<bone_ref>& bones,
+        const piece_removal* previous) {
+
+    std::unordered_set<const sm::node*> removed_nodes;
+    for (auto node : nodes) {
+        auto iter = skel.nodes_.find(node->name());
+        if (iter == skel.nodes_.end() || iter->second != node.ptr()) {
+            return std::unexpected(result::not_found);
+        }
+        removed_nodes.insert(node.ptr());
+    }
+    std::unordered_set<const sm::bone*> removed_bones;
+    for (auto bone : bones) {
+        auto iter = skel.bones_.find(bone->name());
+        if (iter == skel.bones_.end() || iter->second != bone.ptr()) {
+            return std::unexpected(result::not_found);
+        }
+        removed_bones.insert(bone.ptr());
+    }
+
+    piece_removal removal;
+    removal.skeleton = skel.id();
+    removal.skeleton_name = skel.name();
+    removal.root = skel.root_node().id();
+
+    // find the head of each surviving component before changing anything. A head is either
+    // a node whose parent bone is gone or, if a bone is given, a copy of a removed node that
+    // the bone will hang from.
+
+    struct component_head {
+        sm::node* node;
+        sm::bone* bone;
+        bool is_copy;
+    };
+
+    std::vector<component_head> heads;
+    std::unordered_set<const sm::node*> dead_nodes;
+    for (auto [name, node] : skel.nodes_) {
+        auto parent = node->parent_bone();
+        bool parent_survives = parent && !removed_bones.contains(parent->ptr());
+        if (!removed_nodes.contains(node)) {
+            if (!parent_survives) {
+                heads.push_back({ node, nullptr, false });
+            }
+            continue;
+        }
+        auto children = node->children_ |
+            rv::transform([](auto b) { return b.ptr(); }) |
+            rv::filter([&](auto* b) { return !removed_bones.contains(b); }) |
+            r::to<std::vector<sm::bone*>>();
+        r::sort(children, [](auto* lhs, auto* rhs) { return lhs->name() < rhs->name(); });
+        auto first_copied = children.begin();
+        if (!parent_survives) {
+            if (children.empty()) {
+                dead_nodes.insert(node);
+                continue;
+            }
+            heads.push_back({ node, children.front(), false });
+            ++first_copied;
+        }
+        for (auto* child : r::subrange(first_copied, children.end())) {
+            heads.push_back({ node, child, true });
+        }
+    }
+    auto key = [](const component_head& head) {
+        return std::tuple(head.node->name(), head.bone ? head.bone->name() : std::string{});
+    };
+    r::sort(heads, [&](const auto& lhs, const auto& rhs) { return key(lhs) < key(rhs); });
+
+    // the component that stays in the skeleton goes last, after everything moving out of
+    // the skeleton has been taken out of its name tables.
+    if (!heads.empty()) {
+        auto kept = r::find_if(heads,
+            [&skel](const auto& head) {
+                return !head.is_copy && head.node == &skel.root_node();
+            }
+        );
+        kept = (kept != heads.end()) ? kept : heads.begin();
+        std::rotate(kept, kept + 1, heads.end());
+    }
+
+    for (auto* bone : removed_bones) {
+        removal.bones.push_back({
+            bone->id(), bone->name(), bone->u_.id(), bone->v_.id(),
+            bone->length_, bone->rot_constraint_
+        });
+        std::erase_if(bone->u_.children_, [bone](auto b) { return b.ptr() == bone; });
+        skel.bones_.erase(bone->name());
+        bone_ids_.erase(bone->id());
+    }
+    // bones going onto copies are cut loose up front so that moving the component above
+    // them does not take them along.
+    for (const auto& head : heads) {
+        if (head.is_copy) {
+            std::erase_if(head.node->children_,
+                [&head](auto b) { return b.ptr() == head.bone; }
+            );
+        }
+    }
+    for (auto* node : dead_nodes) {
+        removal.nodes.push_back({ node->id(), node->name(), node->world_pos() });
+        skel.nodes_.erase(node->name());
+        node_ids_.erase(node->id());
+    }
+
+    std::unordered_set<const sm::bone*> replaced_bones;
+    size_t num_splits = 0;
+    for (const auto& head : heads) {
+        auto* target = &skel;
+        if (&head != &heads.back()) {
+            auto name = unique_name(normalize_name(skel.name()), skeleton_names());
+            skeletons_.emplace(name, skeleton::make_unique(*this));
+            target = skeletons_[name].get();
+            target->set_name(name);
+            assign_id(*target, 
+                (previous && num_splits < previous->splits.size()) ? 
+                    previous->splits[num_splits] : piece_id{}
+            );
+            removal.splits.push_back(target->id());
+            ++num_splits;
+        }
+
+        auto* root = head.node;
+        if (head.is_copy) {
+            auto num_copies = removal.copies.size();
+            root = create_node(*target, root->name(), root->world_x(), root->world_y()).ptr();
+            if (previous && num_copies < previous->copies.size()) {
+                assign_id(*root, previous->copies[num_copies].copy);
+            }
+            removal.copies.push_back({ root->id(), head.node->id() });
+            auto& moved = reparent_bone(*head.bone, *root);
+            skel.bones_[moved.name()] = &moved;
+            replaced_bones.insert(head.bone);
+        } else {
+            root->parent_ = sm::ref(*target);
+        }
+        target->set_root(*root);
+
+        if (target == &skel) {
+            skel.nodes_[root->name()] = root;
+            continue;
+        }
+        visit_nodes_and_bones(*root,
+            [&](sm::node& n)->visit_result {
+                auto iter = skel.nodes_.find(n.name());
+                if (iter != skel.nodes_.end() && iter->second == &n) {
+                    skel.nodes_.erase(iter);
+                }
+                target->nodes_[n.name()] = &n;
+                return visit_result::continue_traversal;
+            },
+            [&](sm::bone& b)->visit_result {
+                skel.bones_.erase(b.name());
+                target->bones_[b.name()] = &b;
+                return visit_result::continue_traversal;
+            },
+            true
+        );
+    }
+
+    if (heads.empty()) {
+        removal.skeleton_removed = true;
+        skeleton_ids_.erase(skel.id());
+        skeletons_.erase(removal.skeleton_name);
+    }
+
+    delete_ptrs_if<sm::bone>(bones_,
+        [&](const sm::bone& b)->bool {
+            return removed_bones.contains(&b) || replaced_bones.contains(&b);
+        }
+    );
+    delete_ptrs_if<sm::node>(nodes_,
+        [&dead_nodes](const sm::node& n)->bool {
+            return dead_nodes.contains(&n);
+        }
+    );
+
+    return removal;
+}
+
+// undoes a remove_pieces, which must be the last thing to have happened to the skeletons it
+// split off: they are folded back into the original skeleton, the bones moved onto copies are
+// moved back onto the nodes they were copied from, and the removed pieces are recreated under
+// their old ids.
+
+sm::result sm::world::restore(const piece_removal& removal) {
+    sm::skeleton* skel = nullptr;
+    if (removal.skeleton_removed) {
+        auto new_skel = create_skeleton(removal.skeleton_name);
+        if (!new_skel) {
+            return new_skel.error();
+        }
+        skel = new_skel.value().ptr();
+        assign_id(*skel, removal.skeleton);
+    } else {
+        skel = from_id<sm::skeleton>(removal.skeleton);
+        if (!skel) {
+            return result::not_found;
+        }
+    }
+
+    std::unordered_set<const sm::node*> copies;
+    std::unordered_set<const sm::bone*> replaced_bones;
+    for (const auto& [copy_id, original_id] : removal.copies) {
+        auto* copy = from_id<sm::node>(copy_id);
+        auto* original = from_id<sm::node>(original_id);
+        if (!copy || !original) {
+            return result::not_found;
+        }
+        auto& copy_skel = copy->owner();
+        for (auto child : copy->child_bones()) {
+            auto& moved = reparent_bone(child.get(), *original);
+            copy_skel.bones_[moved.name()] = &moved;
+            replaced_bones.insert(child.ptr());
+        }
+        copy_skel.nodes_.erase(copy->name());
+        node_ids_.erase(copy_id);
+        copies.insert(copy);
+    }
+
+    for (auto split_id : removal.splits) {
+        auto* split = from_id<sm::skeleton>(split_id);
+        if (!split) {
+            return result::not_found;
+        }
+        skel->nodes_.insert(split->nodes_.begin(), split->nodes_.end());
+        skel->bones_.insert(split->bones_.begin(), split->bones_.end());
+        if (!copies.contains(split->root_->ptr())) {
+            split->root_node().parent_ = sm::ref(*skel);
+        }
+        skeleton_ids_.erase(split_id);
+        skeletons_.erase(split->name());
+    }
+
+    for (const auto& node : removal.nodes) {
+        auto new_node = create_node(*skel, node.name, node.position.x, node.position.y);
+        assign_id(new_node.get(), node.id);
+        skel->nodes_[node.name] = new_node.ptr();
+    }
+    for (const auto& bone : removal.bones) {
+        auto* u = from_id<sm::node>(bone.u);
+        auto* v = from_id<sm::node>(bone.v);
+        if (!u || !v) {
+            return result::not_found;
+        }
+        bones_.push_back(bone::make_unique(bone.name, *u, *v));
+        auto& new_bone = *bones_.back();
+        assign_id(new_bone, bone.id);
+        new_bone.length_ = bone.length;
+        new_bone.rot_constraint_ = bone.constraint;
+        skel->bones_[bone.name] = &new_bone;
+    }
+
+    auto* root = from_id<sm::node>(removal.root);
+    if (!root) {
+        return result::not_found;
+    }
+    root->parent_ = sm::ref(*skel);
+    skel->set_root(*root);
+
+    delete_ptrs_if<sm::bone>(bones_,
+        [&replaced_bones](const sm::bone& b)->bool {
+            return replaced_bones.contains(&b);
+        }
+    );
+    delete_ptrs_if<sm::node>(nodes_,
+        [&copies](const sm::node& n)->bool {
+            return copies.contains(&n);
+        }
+    );
+
+    return result::success;
+}
+
+sm::expected_skel sm::world::restore(const skeleton_snapshot& snap, const std::string& new_name) {
+    auto new_skel = create_skeleton(new_name.empty() ? snap.name : new_name);
+    if (!new_skel) {
+        return new_skel;
+    }
+    auto& skel = new_skel->get();
+
+    // a snapshot taken from this world carries the ids its pieces had, which are reclaimed
+    // where possible so that anything still referring to those ids sees the restored pieces.
+    bool has_ids = snap.has_ids();
+    if (has_ids) {
+        assign_id(skel, snap.id);
+    }
+
+    std::vector<sm::node*> nodes;
+    nodes.reserve(snap.num_nodes());
+    for (auto i = 0; i < static_cast<int>(snap.num_nodes()); ++i) {
+        const auto& name = snap.node_names[i];
+        const auto& pos = snap.node_positions[i];
+        auto node = create_node(skel, name, pos.x, pos.y);
+        if (has_ids) {
+            assign_id(node.get(), snap.node_ids[i]);
+        }
+        skel.nodes_[name] = node.ptr();
+        nodes.push_back(node.ptr());
+    }
+    skel.set_root(*nodes.at(snap.root));
+
+    for (auto i = 0; i < static_cast<int>(snap.num_bones()); ++i) {
+        auto [u, v] = snap.bone_nodes[i];
+        auto bone = create_bone_in_skeleton(snap.bone_names[i], *nodes.at(u), *nodes.at(v));
+        if (!bone) {
+            return std::unexpected(bone.error());
+        }
+        if (has_ids) {
+            assign_id(bone->get(), snap.bone_ids[i]);
+        }
+        const auto& constraint = snap.bone_constraints[i];
+        if (constraint) {
+            bone->get().set_rotation_constraint(
+                constraint->start_angle, constraint->span_angle, constraint->relative_to_parent
+            );
+        }
+        skel.bones_[snap.bone_names[i]] = bone->ptr();
+    }
+
+    return new_skel;
+}
+
 sm::result sm::world::from_json_str(const std::string& str) {
     try {
         auto js = json::parse(str);
@@ -622,6 +1135,7 @@ sm::result sm::world::from_json(const json& stick_man)
 				[this](const json& jobj)->skeleton_tbl::value_type {
                     std::unique_ptr<sm::skeleton> skel = skeleton::make_unique(*this);
                     skel->from_json(*this, jobj);
+                    assign_id(*skel);
                     return { skel->name(), std::move(skel) };
 				}
 		) | r::to<skeleton_tbl>();
@@ -9,12 +9,12 @@
 #include <unordered_map>
 #include <expected>
 #include <tuple>
-#include <any>
 #include <ranges>
 #include <variant>
 #include "sm_types.h"
 #include "sm_bone.h"
 #include "sm_animation.h"
+#include "sm_snapshot.h"
 #include "json_fwd.hpp"
 
 /*------------------------------------------------------------------------------------------------*/
@@ -33,9 +33,9 @@ namespace sm {
         using bones_tbl = std::unordered_map<std::string, bone*>;
 
 		world_ref owner_;
+		piece_id id_;
 		std::string name_;
 		maybe_node_ref root_;
-		std::any user_data_;
         nodes_tbl nodes_;
 		bones_tbl bones_;
         std::vector<animation> animations_;
@@ -53,18 +53,20 @@ namespace sm {
         void set_owner(world& owner);
 
 	public:
+		piece_id id() const;
 		std::string name() const;
         bool empty() const;
 		sm::node& root_node();
 		const sm::node& root_node() const;
 
-		std::any get_user_data() const;
-		void set_user_data(std::any data);
-		void clear_user_data();
         expected_skel copy_to(world& w, const std::string& new_name = "") const;
+        skeleton_snapshot snapshot() const;
 
 		result set_name(bone& bone, const std::string& new_name);
 		result set_name(node& node, const std::string& new_name);
+
+        using renames = std::vector<std::tuple<std::string, std::string>>;
+        result set_names(const renames& node_renames, const renames& bone_renames);
 		
 		auto nodes() { return detail::to_range_view<node_ref>(nodes_); }
 		auto bones() { return detail::to_range_view<bone_ref>(bones_); }
@@ -109,10 +111,40 @@ namespace sm {
 		std::vector<std::unique_ptr<node>> nodes_;
 		std::vector<std::unique_ptr<bone>> bones_;
         skeleton_tbl skeletons_;
+        detail::slot_table<sm::skeleton> skeleton_ids_;
+        detail::slot_table<node> node_ids_;
+        detail::slot_table<bone> bone_ids_;
+
+        template<is_skel_piece T, typename W>
+        static auto& id_table(W& w) {
+            if constexpr (std::is_same<T, sm::skeleton>::value) {
+                return w.skeleton_ids_;
+            } else if constexpr (std::is_same<T, node>::value) {
+                return w.node_ids_;
+            } else {
+                return w.bone_ids_;
+            }
+        }
+
+        template<is_skel_piece T>
+        void assign_id(T& piece, piece_id requested = {}) {
+            auto& tbl = id_table<T>(*this);
+            if (!piece.id_.is_null()) {
+                tbl.erase(piece.id_);
+            }
+            piece.id_ = tbl.insert_at(requested, &piece) ? requested : tbl.insert(&piece);
+        }
+
+        template<is_skel_piece T>
+        void release_id(T& piece) {
+            id_table<T>(*this).erase(piece.id_);
+            piece.id_ = {};
+        }
 
         node_ref create_node(skeleton& parent, const std::string& name, double x, double y);
 		node_ref create_node(skeleton& parent, double x, double y);
         expected_bone create_bone_in_skeleton(const std::string& bone_name, node& u, node& v);
+        bone& reparent_bone(bone& b, node& new_parent);
 
     public:
 		world();
@@ -136,7 +168,23 @@ namespace sm {
 		bool contains_skeleton(const std::string& name) const;
         result set_name(sm::skeleton& skel, const std::string& new_name);
 
-        expected_bone create_bone(const std::string& name, node& u, node& v);
+        expected_bone create_bone(const std::string& name, node& u, node& v, piece_id id = {});
+        expected_skel split_skeleton(bone& bone, const std::string& new_skel_name, piece_id id = {});
+        expected_skel restore(const skeleton_snapshot& snapshot, const std::string& new_name = "");
+        std::expected<piece_removal, result> remove_pieces(sm::skeleton& skel,
+            const std::vector<node_ref>& nodes, const std::vector<bone_ref>& bones,
+            const piece_removal* previous = nullptr);
+        result restore(const piece_removal& removal);
+
+        template<is_skel_piece T>
+        T* from_id(piece_id id) {
+            return id_table<T>(*this).get(id);
+        }
+
+        template<is_skel_piece T>
+        const T* from_id(piece_id id) const {
+            return id_table<T>(*this).get(id);
+        }
         result from_json_str(const std::string& js);
 		result from_json(const nlohmann::json& js);
 		std::string to_json_str() const;
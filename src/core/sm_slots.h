@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace sm {
+
+    // skeletons, nodes, and bones are identified within a world by an index into a dense
+    // table plus the generation of the slot at that index. A slot's generation changes every
+    // time it is reused, so an id that outlives its piece fails to resolve instead of silently
+    // resolving to whatever occupies the slot now. Generation zero is never issued, which makes
+    // a default constructed piece_id a null id.
+
+    struct piece_id {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        bool operator==(const piece_id& id) const = default;
+        bool is_null() const {
+            return generation == 0;
+        }
+    };
+
+    namespace detail {
+
+        template<typename T>
+        class slot_table {
+
+            struct slot {
+                T* ptr;
+                uint32_t generation;
+                uint32_t next_generation;
+            };
+
+            std::vector<slot> slots_;
+            std::vector<uint32_t> free_;
+
+        public:
+
+            piece_id insert(T* ptr) {
+                // the free list may hold slots that were since reclaimed by insert_at.
+                while (!free_.empty()) {
+                    auto index = free_.back();
+                    free_.pop_back();
+                    auto& s = slots_[index];
+                    if (!s.ptr) {
+                        s.ptr = ptr;
+                        s.generation = s.next_generation++;
+                        return { index, s.generation };
+                    }
+                }
+                auto index = static_cast<uint32_t>(slots_.size());
+                slots_.push_back({ ptr, 1, 2 });
+                return { index, 1 };
+            }
+
+            // reclaims a specific id, e.g. when undo restores a deleted piece, so that ids
+            // held by older undo records resolve again. Only ids this table issued itself
+            // whose slot is currently vacant can be reclaimed.
+
+            bool insert_at(piece_id id, T* ptr) {
+                if (id.is_null() || id.index >= slots_.size()) {
+                    return false;
+                }
+                auto& s = slots_[id.index];
+                if (s.ptr || id.generation >= s.next_generation) {
+                    return false;
+                }
+                s.ptr = ptr;
+                s.generation = id.generation;
+                return true;
+            }
+
+            void erase(piece_id id) {
+                if (get(id)) {
+                    slots_[id.index].ptr = nullptr;
+                    free_.push_back(id.index);
+                }
+            }
+
+            T* get(piece_id id) const {
+                if (id.index >= slots_.size()) {
+                    return nullptr;
+                }
+                const auto& s = slots_[id.index];
+                return (s.ptr && s.generation == id.generation) ? s.ptr : nullptr;
+            }
+
+            size_t size() const {
+                return slots_.size();
+            }
+
+            // slots keep their generations across a clear so ids from before it stay stale.
+
+            void clear() {
+                free_.clear();
+                for (uint32_t i = 0; i < slots_.size(); ++i) {
+                    slots_[i].ptr = nullptr;
+                    free_.push_back(i);
+                }
+            }
+        };
+    }
+}
@@ -0,0 +1,104 @@
+#include "sm_snapshot.h"
+#include "json.hpp"
+#include <ranges>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+using json = nlohmann::json;
+
+/*------------------------------------------------------------------------------------------------*/
+
+size_t sm::skeleton_snapshot::num_nodes() const {
+    return node_names.size();
+}
+
+size_t sm::skeleton_snapshot::num_bones() const {
+    return bone_names.size();
+}
+
+size_t sm::skeleton_snapshot::size_in_bytes() const {
+    auto string_bytes = [](const std::vector<std::string>& strings) {
+        size_t bytes = strings.capacity() * sizeof(std::string);
+        for (const auto& str : strings) {
+            bytes += str.capacity();
+        }
+        return bytes;
+    };
+    return sizeof(skeleton_snapshot) + name.capacity() +
+        string_bytes(node_names) + string_bytes(bone_names) +
+        node_positions.capacity() * sizeof(point) +
+        (node_ids.capacity() + bone_ids.capacity()) * sizeof(piece_id) +
+        bone_nodes.capacity() * sizeof(std::tuple<int, int>) +
+        bone_constraints.capacity() * sizeof(std::optional<rot_constraint>);
+}
+
+bool sm::skeleton_snapshot::has_ids() const {
+    return !id.is_null() && node_ids.size() == num_nodes() && bone_ids.size() == num_bones();
+}
+
+void sm::skeleton_snapshot::clear_ids() {
+    id = {};
+    node_ids.clear();
+    bone_ids.clear();
+}
+
+// produces the same json as sm::skeleton::to_json so that a snapshot can be written
+// anywhere a live skeleton would be.
+
+json sm::skeleton_snapshot::to_json() const {
+    auto nodes = rv::iota(0, static_cast<int>(num_nodes())) |
+        rv::transform(
+            [this](int i)->json {
+                const auto& pos = node_positions[i];
+                return {
+                    {"name", node_names[i]},
+                    {"pos",
+                        {{"x", pos.x}, {"y", pos.y}}
+                    }
+                };
+            }
+        ) | r::to<json>();
+
+    auto bones = rv::iota(0, static_cast<int>(num_bones())) |
+        rv::transform(
+            [this](int i)->json {
+                auto [u, v] = bone_nodes[i];
+                json bone_json = {
+                    {"name", bone_names[i]},
+                    {"u", node_names[u]},
+                    {"v", node_names[v]}
+                };
+                const auto& constraint = bone_constraints[i];
+                if (constraint) {
+                    bone_json["rot_constraint"] = {
+                        {"relative_to_parent", constraint->relative_to_parent},
+                        {"start_angle",  constraint->start_angle},
+                        {"span_angle",  constraint->span_angle}
+                    };
+                }
+                return bone_json;
+            }
+        ) | r::to<json>();
+
+    return {
+        {"name", name},
+        {"nodes", nodes},
+        {"bones", bones},
+        {"root", node_names[root]}
+    };
+}
+
+size_t sm::piece_removal::size_in_bytes() const {
+    size_t bytes = sizeof(piece_removal) + skeleton_name.capacity() +
+        nodes.capacity() * sizeof(removed_node) +
+        bones.capacity() * sizeof(removed_bone) +
+        copies.capacity() * sizeof(node_copy) +
+        splits.capacity() * sizeof(piece_id);
+    for (const auto& node : nodes) {
+        bytes += node.name.capacity();
+    }
+    for (const auto& bone : bones) {
+        bytes += bone.name.capacity();
+    }
+    return bytes;
+}
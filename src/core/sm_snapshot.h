@@ -0,0 +1,87 @@
+#pragma once
+
+#include "sm_types.h"
+#include "sm_slots.h"
+#include "json_fwd.hpp"
+#include <string>
+#include <vector>
+#include <tuple>
+#include <optional>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace sm {
+
+    // A skeleton_snapshot is a flat, immutable copy of a skeleton's names and geometry. Nodes
+    // and bones are stored in parallel arrays and bones refer to their nodes by index, so a
+    // snapshot can be taken with a few vector copies and then handed to another thread without
+    // touching the live world again.
+    //
+    // A snapshot taken from a live skeleton also records the ids of the skeleton and its
+    // pieces so that restoring it into the same world can reclaim them. Snapshots built any
+    // other way, or whose ids have been cleared, restore with fresh ids.
+
+    struct skeleton_snapshot {
+        std::string name;
+        piece_id id;
+        int root;
+        std::vector<std::string> node_names;
+        std::vector<piece_id> node_ids;
+        std::vector<point> node_positions;
+        std::vector<std::string> bone_names;
+        std::vector<piece_id> bone_ids;
+        std::vector<std::tuple<int, int>> bone_nodes;
+        std::vector<std::optional<rot_constraint>> bone_constraints;
+
+        size_t num_nodes() const;
+        size_t num_bones() const;
+        size_t size_in_bytes() const;
+        bool has_ids() const;
+        void clear_ids();
+        nlohmann::json to_json() const;
+    };
+
+    // A piece_removal records what world::remove_pieces() took out of a skeleton and how it
+    // split up what was left, which is what world::restore() needs to put the skeleton back.
+    // The surviving pieces were moved rather than copied into whatever skeletons the removal
+    // split off, so they are not recorded here; they are found again by id. The record is
+    // proportional to what was removed, not to the size of the skeleton.
+    //
+    // A removed node that surviving bones below it still hung from is replaced, for each such
+    // bone, by a copy that roots the bone's side of the cut; copies are recorded with the id
+    // of the node they stand in for.
+
+    struct piece_removal {
+        struct removed_node {
+            piece_id id;
+            std::string name;
+            point position;
+        };
+
+        struct removed_bone {
+            piece_id id;
+            std::string name;
+            piece_id u;
+            piece_id v;
+            double length;
+            std::optional<rot_constraint> constraint;
+        };
+
+        struct node_copy {
+            piece_id copy;
+            piece_id original;
+        };
+
+        piece_id skeleton;
+        std::string skeleton_name;
+        piece_id root;
+        bool skeleton_removed = false;
+        std::vector<removed_node> nodes;
+        std::vector<removed_bone> bones;
+        std::vector<node_copy> copies;
+        std::vector<piece_id> splits;
+
+        size_t size_in_bytes() const;
+    };
+
+}
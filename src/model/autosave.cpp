@@ -0,0 +1,215 @@
+#include "autosave.h"
+#include "project.h"
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QtGlobal>
+#include <fstream>
+#include <filesystem>
+#include <system_error>
+#include <iterator>
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// how long each snapshot holds up the UI thread is logged at debug level, which is off
+// unless enabled with e.g. QT_LOGGING_RULES="stick_man.autosave.debug=true".
+
+Q_LOGGING_CATEGORY(autosave_log, "stick_man.autosave", QtInfoMsg)
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    bool sync_file(std::FILE* file) {
+        if (std::fflush(file) != 0) {
+            return false;
+        }
+#ifdef Q_OS_WIN
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+    // on POSIX a rename is only durable once the directory holding it is synced.
+
+    void sync_directory(const fs::path& directory) {
+#ifndef Q_OS_WIN
+        auto fd = open(directory.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+#endif
+    }
+
+    // the contents are on disk before the rename, and the rename before returning, since
+    // a successful write is what lets the journal segments it supersedes be deleted.
+
+    bool write_file_atomically(const std::string& path, const std::string& contents) {
+        auto temp_path = path + ".tmp";
+        auto* file = std::fopen(temp_path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        auto written = std::fwrite(contents.data(), 1, contents.size(), file);
+        auto is_synced = written == contents.size() && sync_file(file);
+        if (std::fclose(file) != 0 || !is_synced) {
+            return false;
+        }
+
+        std::error_code ec;
+        fs::rename(temp_path, path, ec);
+        if (ec) {
+            return false;
+        }
+        sync_directory(fs::path(path).parent_path());
+        return true;
+    }
+
+    std::string read_file(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return {};
+        }
+        return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+mdl::autosaver::autosaver(project& proj, const std::string& directory, int interval_msecs) :
+        project_(proj),
+        directory_(directory),
+        path_((fs::path(directory) / "autosave.smj").string()),
+        is_writing_(false),
+        saved_revision_(0),
+        last_snapshot_msecs_(0.0) {
+    timer_.setInterval(interval_msecs);
+    connect(&timer_, &QTimer::timeout, this, &autosaver::autosave);
+}
+
+mdl::autosaver::~autosaver() {
+    project_.set_journal(nullptr);
+}
+
+void mdl::autosaver::autosave() {
+    // skip this tick if the previous write is still in flight or nothing has changed;
+    // the next tick will pick up whatever the latest revision is.
+    if (is_writing_ || project_.revision() == saved_revision_) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    auto snapshot = project_.snapshot();
+    last_snapshot_msecs_ = timer.nsecsElapsed() / 1.0e6;
+    qCDebug(autosave_log) << "snapshot of revision" << snapshot.revision << "took" <<
+        last_snapshot_msecs_ << "ms";
+
+    auto next_revision = snapshot.revision + 1;
+    auto* journal = journal_.get();
+    if (journal) {
+        journal->rotate(next_revision);
+    }
+
+    // the previous worker, if any, has already finished so reassigning joins immediately.
+    is_writing_ = true;
+    worker_ = std::jthread(
+        [this, journal, next_revision, path = path_, snapshot = std::move(snapshot)]() {
+            if (write_file_atomically(path, snapshot.to_json())) {
+                saved_revision_ = snapshot.revision;
+                if (journal) {
+                    journal->discard_before(next_revision);
+                }
+            }
+            is_writing_ = false;
+        }
+    );
+}
+
+void mdl::autosaver::start() {
+    if (!journal_) {
+        // whatever a previous session left behind has been recovered or declined by now.
+        journal::delete_segments(directory_);
+        journal_ = std::make_unique<journal::writer>(directory_, project_.revision() + 1);
+        project_.set_journal(journal_.get());
+    }
+    timer_.start();
+}
+
+void mdl::autosaver::stop() {
+    timer_.stop();
+}
+
+// autosave data only outlives a session that did not shut down cleanly.
+
+bool mdl::autosaver::has_recovery_data() const {
+    std::error_code ec;
+    return fs::exists(path_, ec) || !journal::segment_paths(directory_).empty();
+}
+
+// if the project cannot be recovered it is left as it was and the autosave data is moved
+// aside rather than discarded when autosaving starts, since it is all there is of the work.
+
+bool mdl::autosaver::recover() {
+    auto segments = journal::segment_paths(directory_);
+    std::vector<journal::entry> entries;
+    for (const auto& segment : segments) {
+        auto segment_entries = journal::read_segment(segment);
+        std::move(segment_entries.begin(), segment_entries.end(), std::back_inserter(entries));
+    }
+
+    if (!project_.recover(read_file(path_), entries)) {
+        std::error_code ec;
+        fs::path kept = unrecovered_path();
+        fs::remove_all(kept, ec);
+        fs::create_directories(kept, ec);
+        segments.push_back(path_);
+        for (const auto& file : segments) {
+            fs::rename(file, kept / fs::path(file).filename(), ec);
+        }
+        return false;
+    }
+
+    // the recovered state becomes the new baseline before the old journal is discarded.
+    auto snapshot = project_.snapshot();
+    if (write_file_atomically(path_, snapshot.to_json())) {
+        saved_revision_ = snapshot.revision;
+    }
+    return true;
+}
+
+void mdl::autosaver::discard() {
+    stop();
+    worker_ = {};
+    project_.set_journal(nullptr);
+    journal_.reset();
+
+    std::error_code ec;
+    fs::remove(path_, ec);
+    journal::delete_segments(directory_);
+}
+
+const std::string& mdl::autosaver::path() const {
+    return path_;
+}
+
+std::string mdl::autosaver::unrecovered_path() const {
+    return (fs::path(directory_) / "unrecovered").string();
+}
+
+uint64_t mdl::autosaver::saved_revision() const {
+    return saved_revision_;
+}
+
+double mdl::autosaver::last_snapshot_msecs() const {
+    return last_snapshot_msecs_;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include "journal.h"
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace mdl {
+
+    class project;
+
+    // The autosaver periodically snapshots the project on the UI thread, which only copies
+    // names and positions, and then serializes and writes the snapshot on a worker thread.
+    // The file is written next to its destination and renamed into place so that a crash
+    // during the write never leaves behind a truncated autosave.
+    //
+    // Between snapshots every change to the project is appended to a journal. Taking a
+    // snapshot starts a new journal segment and once the snapshot is on disk the segments
+    // it supersedes are deleted, so recovery is loading the last snapshot and replaying
+    // whatever is left of the journal.
+
+    class autosaver : public QObject {
+
+        Q_OBJECT
+
+        project& project_;
+        std::string directory_;
+        std::string path_;
+        QTimer timer_;
+        std::unique_ptr<journal::writer> journal_;
+        std::atomic<bool> is_writing_;
+        std::atomic<uint64_t> saved_revision_;
+        double last_snapshot_msecs_;
+        std::jthread worker_;
+
+        void autosave();
+
+    public:
+        autosaver(project& proj, const std::string& directory, int interval_msecs);
+        ~autosaver();
+
+        void start();
+        void stop();
+        bool has_recovery_data() const;
+        bool recover();
+        void discard();
+
+        const std::string& path() const;
+
+        // where recover() moves the autosave data it could not recover.
+        std::string unrecovered_path() const;
+        uint64_t saved_revision() const;
+        double last_snapshot_msecs() const;
+    };
+
+}
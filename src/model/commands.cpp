@@ -1,6 +1,7 @@
 #include "commands.h"
 #include <ranges>
 #include <unordered_set>
+#include <map>
 #include <cassert>
 #include "qdebug.h"
 
@@ -39,24 +40,180 @@ namespace {
         }
         return envelope;
     }
+
+    size_t memory_usage(const std::string& str) {
+        return sizeof(std::string) + str.capacity();
+    }
+
+    size_t memory_usage(const mdl::handle& hnd) {
+        return hnd.size_in_bytes();
+    }
+
+    size_t memory_usage(const sm::skeleton_snapshot& snapshot) {
+        return snapshot.size_in_bytes();
+    }
+
+    size_t memory_usage(const sm::piece_removal& removal) {
+        return removal.size_in_bytes();
+    }
+
+    size_t memory_usage(const sm::skeleton::renames& renames) {
+        size_t bytes = renames.capacity() * sizeof(sm::skeleton::renames::value_type);
+        for (const auto& [merged_name, original_name] : renames) {
+            bytes += merged_name.capacity() + original_name.capacity();
+        }
+        return bytes;
+    }
+
+    template<typename T>
+    size_t memory_usage(const std::vector<T>& vec) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            return vec.capacity() * sizeof(T);
+        } else {
+            size_t bytes = (vec.capacity() - vec.size()) * sizeof(T);
+            for (const auto& item : vec) {
+                bytes += memory_usage(item);
+            }
+            return bytes;
+        }
+    }
+
+    template<sm::is_skel_piece T>
+    std::vector<mdl::journal::piece_key> piece_keys(sm::world& world,
+            const std::vector<mdl::handle>& hnds) {
+        return hnds |
+            rv::transform(
+                [&world](const auto& hnd) {
+                    return mdl::journal::to_key(sm::ref(hnd.template to<T>(world)));
+                }
+            ) | r::to<std::vector<mdl::journal::piece_key>>();
+    }
+
+    struct skeleton_pieces {
+        sm::skeleton* skeleton;
+        std::vector<sm::node_ref> nodes;
+        std::vector<sm::bone_ref> bones;
+    };
+
+    // groups nodes and bones by skeleton, with the skeletons in name order so that removing
+    // them, or replaying the removal from the journal, always splits them the same way.
+
+    std::map<std::string, skeleton_pieces> pieces_by_skeleton(sm::world& world,
+            const std::vector<mdl::handle>& nodes, const std::vector<mdl::handle>& bones) {
+        std::map<std::string, skeleton_pieces> pieces;
+        auto pieces_of = [&pieces](sm::skeleton& skel)->skeleton_pieces& {
+            auto& skel_pieces = pieces[skel.name()];
+            skel_pieces.skeleton = &skel;
+            return skel_pieces;
+        };
+        for (const auto& hnd : nodes) {
+            auto& node = hnd.to<sm::node>(world);
+            pieces_of(node.owner()).nodes.push_back(node);
+        }
+        for (const auto& hnd : bones) {
+            auto& bone = hnd.to<sm::bone>(world);
+            pieces_of(bone.owner()).bones.push_back(bone);
+        }
+        return pieces;
+    }
+
+    mdl::journal::set_positions current_positions(sm::world& world,
+            const std::vector<mdl::handle>& nodes) {
+        return {
+            piece_keys<sm::node>(world, nodes),
+            nodes | rv::transform(
+                    [&world](const auto& hnd) {
+                        return hnd.template to<sm::node>(world).world_pos();
+                    }
+                ) | r::to<std::vector<sm::point>>()
+        };
+    }
+
+    mdl::journal::set_rot_constraints current_rot_constraints(sm::world& world,
+            const std::vector<mdl::handle>& bones) {
+        return {
+            piece_keys<sm::bone>(world, bones),
+            bones | rv::transform(
+                    [&world](const auto& hnd) {
+                        return hnd.template to<sm::bone>(world).rotation_constraint();
+                    }
+                ) | r::to<std::vector<std::optional<sm::rot_constraint>>>()
+        };
+    }
+
+    template<typename T>
+    std::vector<std::tuple<T*, std::string>> pieces_with_names(auto pieces) {
+        return pieces |
+            rv::transform(
+                [](auto piece)->std::tuple<T*, std::string> {
+                    return { piece.ptr(), piece->name() };
+                }
+            ) | r::to<std::vector<std::tuple<T*, std::string>>>();
+    }
+
+    template<typename T>
+    sm::skeleton::renames renames_to_original(
+            const std::vector<std::tuple<T*, std::string>>& original_names) {
+        return original_names |
+            rv::filter(
+                [](const auto& tup) {
+                    const auto& [piece, original_name] = tup;
+                    return piece->name() != original_name;
+                }
+            ) | rv::transform(
+                [](const auto& tup)->sm::skeleton::renames::value_type {
+                    const auto& [piece, original_name] = tup;
+                    return { piece->name(), original_name };
+                }
+            ) | r::to<sm::skeleton::renames>();
+    }
+
+    sm::skeleton::renames inverted(const sm::skeleton::renames& renames) {
+        return renames |
+            rv::transform(
+                [](const auto& tup)->sm::skeleton::renames::value_type {
+                    const auto& [from, to] = tup;
+                    return { to, from };
+                }
+            ) | r::to<sm::skeleton::renames>();
+    }
 }
 
 mdl::command mdl::commands::make_create_node_command(const std::string& canvas, const sm::point& pt) {
-    auto state = std::make_shared<create_node_state>(canvas, "", pt);
+    auto state = std::make_shared<create_node_state>(canvas, pt);
 
     return {
         [state](mdl::project& proj) {
-            auto& skel = proj.world_.create_skeleton(state->loc);
-            state->skeleton = skel.name();
-            proj.tabs_[state->canvas_name].push_back(skel.name());
-            emit proj.new_skeleton_added(state->canvas_name, skel);
+            sm::skeleton* skel = nullptr;
+            if (state->created) {
+                auto restored = proj.world_.restore(*state->created);
+                if (!restored) {
+                    throw std::runtime_error("restoring created skeleton failed");
+                }
+                skel = restored->ptr();
+                state->created = {};
+            } else {
+                skel = &proj.world_.create_skeleton(state->loc);
+            }
+            state->skeleton = to_handle(sm::ref(*skel));
+            proj.add_skeleton_name_to_canvas_table(state->canvas_name, skel->name());
+            proj.log(journal::replace_skeletons{ state->canvas_name, {}, {skel->snapshot()} });
+            emit proj.new_skeleton_added(state->canvas_name, *skel);
         },
         [state](mdl::project& proj) {
-            proj.delete_skeleton_name_from_canvas_table(
-                state->canvas_name, state->skeleton
-            );
-            proj.world_.delete_skeleton(state->skeleton);
+            auto& skel = state->skeleton.to<sm::skeleton>(proj.world_);
+            auto skel_name = skel.name();
+            skeleton_changes changes{ .removed = { skel.id() } };
+            state->created = skel.snapshot();
+            proj.delete_skeleton_name_from_canvas_table(state->canvas_name, skel_name);
+            proj.world_.delete_skeleton(skel_name);
+            proj.log(journal::replace_skeletons{ state->canvas_name, {skel_name}, {} });
+            emit proj.skeletons_changed(state->canvas_name, changes);
             emit proj.refresh_canvas(proj, state->canvas_name, true);
+        },
+        [state]() {
+            return sizeof(create_node_state) + memory_usage(state->canvas_name) +
+                (state->created ? memory_usage(*state->created) : 0);
         }
     };
 }
@@ -66,6 +223,15 @@ mdl::commands::add_bone_state::add_bone_state(const std::string& str,
     canvas_name(str), u_hnd(u_hnd), v_hnd(v_hnd) {
 }
 
+size_t mdl::commands::add_bone_state::memory_usage() const {
+    return sizeof(add_bone_state) + ::memory_usage(canvas_name) +
+        ::memory_usage(u_hnd) + ::memory_usage(v_hnd) +
+        ::memory_usage(merged) + ::memory_usage(bone) + ::memory_usage(v_skeleton) +
+        ::memory_usage(v_skeleton_name) +
+        ::memory_usage(u_node_renames) + ::memory_usage(u_bone_renames) +
+        ::memory_usage(v_node_renames) + ::memory_usage(v_bone_renames);
+}
+
 mdl::command mdl::commands::make_add_bone_command(const std::string& tab, 
         const handle& u_hnd, const handle& v_hnd) {
     auto state = std::make_shared<add_bone_state>(tab, u_hnd, v_hnd);
@@ -80,71 +246,270 @@ mdl::command mdl::commands::make_add_bone_command(const std::string& tab,
 
             auto& skel_u = u.owner();
             auto& skel_v = v.owner();
-            auto new_u = skel_u.copy_to(state->original);
-            auto new_v = skel_v.copy_to(state->original);
-            if (!new_u || !new_v) {
-                throw std::runtime_error("skeleton copy failed");
-            }
+            auto v_skeleton_name = skel_v.name();
+            auto u_key = journal::to_key(sm::ref(u));
+            auto v_key = journal::to_key(sm::ref(v));
+            state->v_skeleton = to_handle(sm::ref(skel_v));
+            state->v_skeleton_name = v_skeleton_name;
+
+            // merging renames pieces so remember the names they had beforehand.
+            auto u_nodes = pieces_with_names<sm::node>(skel_u.nodes());
+            auto u_bones = pieces_with_names<sm::bone>(skel_u.bones());
+            auto v_nodes = pieces_with_names<sm::node>(skel_v.nodes());
+            auto v_bones = pieces_with_names<sm::bone>(skel_v.bones());
+
             emit proj.pre_new_bone_added(u, v);
             proj.delete_skeleton_name_from_canvas_table(
                 state->canvas_name, v.owner().name()
             );
 
-            auto bone = proj.world_.create_bone({}, u, v);
+            // on a redo the bone reclaims the id it had the first time around.
+            auto bone = proj.world_.create_bone({}, u, v, state->bone.id);
             if (!bone) {
                 throw std::runtime_error("create_bone failed");
             }
 
-            state->merged = bone->get().owner().name();
+            auto& merged = bone->get().owner();
+            state->merged = to_handle(sm::ref(merged));
+            state->bone = to_handle(bone.value());
+            state->u_node_renames = renames_to_original(u_nodes);
+            state->u_bone_renames = renames_to_original(u_bones);
+            state->v_node_renames = renames_to_original(v_nodes);
+            state->v_bone_renames = renames_to_original(v_bones);
+            proj.log(
+                journal::add_bone{
+                    state->canvas_name, std::move(u_key), std::move(v_key), bone->get().name(),
+                    inverted(state->u_node_renames), inverted(state->u_bone_renames),
+                    inverted(state->v_node_renames), inverted(state->v_bone_renames)
+                }
+            );
+
             emit proj.new_bone_added(bone->get());
         },
         [state](mdl::project& proj) {
-            proj.replace_skeletons_aux(state->canvas_name,
-                {state->merged},
-                state->original.skeletons() | r::to<std::vector<sm::skel_ref>>(),
-                nullptr
+            auto& merged = state->merged.to<sm::skeleton>(proj.world_);
+            auto& bone = state->bone.to<sm::bone>(proj.world_);
+            auto bone_key = journal::to_key(sm::ref(bone));
+            auto split = proj.world_.split_skeleton(
+                bone, state->v_skeleton_name, state->v_skeleton.id
             );
-            state->original.clear();
+            if (!split) {
+                throw std::runtime_error("split_skeleton failed");
+            }
+
+            auto u_result = merged.set_names(state->u_node_renames, state->u_bone_renames);
+            auto v_result = split->get().set_names(state->v_node_renames, state->v_bone_renames);
+            if (u_result != sm::result::success || v_result != sm::result::success) {
+                throw std::runtime_error("restoring names after split failed");
+            }
+            proj.add_skeleton_name_to_canvas_table(state->canvas_name, state->v_skeleton_name);
+
+            // redo records the renames again, so there is no need to keep them around.
+            proj.log(
+                journal::remove_bone{
+                    state->canvas_name, std::move(bone_key), state->v_skeleton_name,
+                    std::move(state->u_node_renames), std::move(state->u_bone_renames),
+                    std::move(state->v_node_renames), std::move(state->v_bone_renames)
+                }
+            );
+            state->u_node_renames = {};
+            state->u_bone_renames = {};
+            state->v_node_renames = {};
+            state->v_bone_renames = {};
+
+            emit proj.skeletons_changed(state->canvas_name,
+                { .changed = { merged.id() }, .added = { split->get().id() } });
+            emit proj.refresh_canvas(proj, state->canvas_name, true);
+        },
+        [state]() {
+            return state->memory_usage();
         }
     };
 }
 
+size_t mdl::commands::rename_state::memory_usage() const {
+    return sizeof(rename_state) + ::memory_usage(piece) +
+        ::memory_usage(old_name) + ::memory_usage(new_name);
+}
+
 mdl::commands::replace_skeleton_state::replace_skeleton_state(const std::string& canv, 
-        const std::vector<std::string>& replacees, const std::vector<sm::skel_ref>& replacers):
+        const std::vector<std::string>& replacees,
+        const std::vector<sm::skeleton_snapshot>& replacers):
         canvas_name(canv),
-        replacee_names(replacees) {
-    for (auto skel : replacers) {
-        skel->copy_to(replacements);
+        replacee_names(replacees),
+        replacements(replacers) {
+    // replacements generally come from some other world so the ids they have there mean
+    // nothing here.
+    for (auto& snapshot : replacements) {
+        snapshot.clear_ids();
     }
 }
 
+size_t mdl::commands::replace_skeleton_state::memory_usage() const {
+    return sizeof(replace_skeleton_state) + ::memory_usage(canvas_name) +
+        ::memory_usage(replacee_names) + ::memory_usage(replacement_names) +
+        ::memory_usage(replacements) + ::memory_usage(removals);
+}
+
 mdl::command mdl::commands::make_replace_skeletons_command(
         const std::string& canvas_name,
         const std::vector<std::string>& replacees,
         const std::vector<sm::skel_ref>& replacements) {
+    return make_replace_skeletons_command(
+        canvas_name,
+        replacees,
+        replacements | rv::transform(
+            [](auto skel) {
+                return skel->snapshot();
+            }
+        ) | r::to<std::vector<sm::skeleton_snapshot>>()
+    );
+}
+
+mdl::command mdl::commands::make_replace_skeletons_command(
+        const std::string& canvas_name,
+        const std::vector<std::string>& replacees,
+        const std::vector<sm::skeleton_snapshot>& replacements) {
     auto state = std::make_shared<replace_skeleton_state>(canvas_name, replacees, replacements);
     return {
         [state](mdl::project& proj) {
-            if (state->replacees.empty()) {
-                for (const auto& skel_name : state->replacee_names) {
-                    proj.world_.skeleton(skel_name)->get().copy_to(state->replacees);
+            skeleton_changes changes;
+            auto removals = proj.remove_skeletons_aux(state->canvas_name, state->replacee_names);
+            for (const auto& removal : removals) {
+                changes.add_removal(removal);
+            }
+            if (!state->replacements.empty()) {
+                proj.add_skeletons_aux(state->canvas_name, state->replacements,
+                    state->replacement_names);
+                state->replacements = {};
+                for (const auto& skel_name : state->replacement_names) {
+                    changes.added.push_back(proj.world_.skeleton(skel_name)->get().id());
+                }
+            } else {
+                for (const auto& removal : state->removals | rv::reverse) {
+                    proj.restore_pieces_aux(state->canvas_name, removal);
+                    changes.add_restore(removal);
                 }
             }
-            state->replacement_names.clear();
-            proj.replace_skeletons_aux(
-                state->canvas_name,
-                state->replacee_names,
-                state->replacements.skeletons() | r::to<std::vector<sm::skel_ref>>(),
-                &state->replacement_names
-            );
+            state->removals = std::move(removals);
+
+            if (proj.journal_) {
+                proj.log(journal::replace_skeletons{ state->canvas_name,
+                    state->replacee_names, proj.snapshots_of(state->replacement_names) });
+            }
+            emit proj.skeletons_changed(state->canvas_name, changes);
+            emit proj.refresh_canvas(proj, state->canvas_name, true);
         },
         [state](mdl::project& proj) {
-            proj.replace_skeletons_aux(
-                state->canvas_name,
-                state->replacement_names,
-                state->replacees.skeletons() | r::to<std::vector<sm::skel_ref>>(),
-                nullptr
-            );
+            skeleton_changes changes;
+            auto removals = proj.remove_skeletons_aux(state->canvas_name,
+                state->replacement_names);
+            for (const auto& removal : removals) {
+                changes.add_removal(removal);
+            }
+            for (const auto& removal : state->removals | rv::reverse) {
+                proj.restore_pieces_aux(state->canvas_name, removal);
+                changes.add_restore(removal);
+            }
+            state->removals = std::move(removals);
+
+            if (proj.journal_) {
+                proj.log(journal::replace_skeletons{ state->canvas_name,
+                    state->replacement_names, proj.snapshots_of(state->replacee_names) });
+            }
+            emit proj.skeletons_changed(state->canvas_name, changes);
+            emit proj.refresh_canvas(proj, state->canvas_name, true);
+        },
+        [state]() {
+            return state->memory_usage();
+        }
+    };
+}
+
+size_t mdl::commands::remove_pieces_state::memory_usage() const {
+    return sizeof(remove_pieces_state) + ::memory_usage(canvas_name) +
+        ::memory_usage(nodes) + ::memory_usage(bones) + ::memory_usage(removals);
+}
+
+mdl::command mdl::commands::make_remove_pieces_command(
+        const std::string& canvas_name,
+        const std::vector<handle>& nodes,
+        const std::vector<handle>& bones) {
+    auto state = std::make_shared<remove_pieces_state>(canvas_name, nodes, bones);
+    return {
+        [state](mdl::project& proj) {
+            std::optional<journal::remove_pieces> rec;
+            if (proj.journal_) {
+                rec = journal::remove_pieces{
+                    state->canvas_name,
+                    piece_keys<sm::node>(proj.world_, state->nodes),
+                    piece_keys<sm::bone>(proj.world_, state->bones)
+                };
+            }
+
+            std::vector<sm::piece_removal> removals;
+            auto pieces = pieces_by_skeleton(proj.world_, state->nodes, state->bones);
+            for (const auto& [skel_name, skel_pieces] : pieces) {
+                auto skel_id = skel_pieces.skeleton->id();
+                auto previous = r::find_if(state->removals,
+                    [skel_id](const auto& removal) {
+                        return removal.skeleton == skel_id;
+                    }
+                );
+                removals.push_back(
+                    proj.remove_pieces_aux(
+                        state->canvas_name, *skel_pieces.skeleton,
+                        skel_pieces.nodes, skel_pieces.bones,
+                        (previous != state->removals.end()) ? &*previous : nullptr
+                    )
+                );
+            }
+            state->removals = std::move(removals);
+
+            skeleton_changes changes;
+            for (const auto& removal : state->removals) {
+                changes.add_removal(removal);
+            }
+            if (rec) {
+                proj.log(*rec);
+            }
+            emit proj.skeletons_changed(state->canvas_name, changes);
+            emit proj.refresh_canvas(proj, state->canvas_name, true);
+        },
+        [state](mdl::project& proj) {
+            // the journal has no ids to replay a restore with, so it gets the restored
+            // skeletons in place of what the removal left of them.
+            journal::replace_skeletons rec{ state->canvas_name };
+            if (proj.journal_) {
+                for (const auto& removal : state->removals) {
+                    if (!removal.skeleton_removed) {
+                        rec.removed.push_back(removal.skeleton_name);
+                    }
+                    for (auto split : removal.splits) {
+                        rec.removed.push_back(proj.world_.from_id<sm::skeleton>(split)->name());
+                    }
+                }
+            }
+
+            skeleton_changes changes;
+            for (const auto& removal : state->removals | rv::reverse) {
+                proj.restore_pieces_aux(state->canvas_name, removal);
+                changes.add_restore(removal);
+            }
+
+            if (proj.journal_) {
+                for (const auto& removal : state->removals) {
+                    rec.added.push_back(
+                        proj.world_.from_id<sm::skeleton>(removal.skeleton)->snapshot()
+                    );
+                }
+                proj.log(rec);
+            }
+            emit proj.skeletons_changed(state->canvas_name, changes);
+            emit proj.refresh_canvas(proj, state->canvas_name, true);
+        },
+        [state]() {
+            return state->memory_usage();
         }
     };
 }
@@ -152,13 +517,15 @@ mdl::command mdl::commands::make_replace_skeletons_command(
 mdl::commands::transform_nodes_and_bones_state::transform_nodes_and_bones_state(
         project& proj,  const std::vector<handle>& node_hnds, const std::function<void(sm::node&)>& fn):
             transform_nodes{ fn } {
+    nodes.reserve(node_hnds.size());
+    old_positions.reserve(node_hnds.size());
     for (auto handle : node_hnds) {
         auto& node = handle.to<sm::node>(proj.world_);
         if (canvas.empty()) {
             canvas = proj.canvas_name_from_skeleton(node.owner().name());
         }
         nodes.push_back(handle);
-        old_node_to_position[handle] = node.world_pos();
+        old_positions.push_back(node.world_pos());
     }
 }
 
@@ -169,30 +536,36 @@ mdl::commands::transform_nodes_and_bones_state::transform_nodes_and_bones_state(
             transform_bones{ fn } {
 
     std::unordered_set<sm::node*> node_set;
+    bones.reserve(bone_hnds.size());
+    old_rot_constraints.reserve(bone_hnds.size());
     for (auto handle : bone_hnds) {
         auto& bone = handle.to<sm::bone>(proj.world_);
         if (canvas.empty()) {
             canvas = proj.canvas_name_from_skeleton(bone.owner().name());
         }
         bones.push_back(handle);
-
-        auto rot_con = bone.rotation_constraint();
-        if (rot_con) {
-            old_bone_to_rotcon[handle] = *rot_con;
-        }
+        old_rot_constraints.push_back(bone.rotation_constraint());
 
         node_set.insert(&bone.parent_node());
     }
 
-    for (auto* node_ptr : downstream_envelope(node_set)) {
+    auto envelope = downstream_envelope(node_set);
+    nodes.reserve(envelope.size());
+    old_positions.reserve(envelope.size());
+    for (auto* node_ptr : envelope) {
         auto& node = *node_ptr;
-        auto handle = to_handle( sm::ref(node) );
-        nodes.push_back(handle);
-        old_node_to_position[handle] = node.world_pos();
+        nodes.push_back(to_handle(sm::ref(node)));
+        old_positions.push_back(node.world_pos());
     }
 
 }
 
+size_t mdl::commands::transform_nodes_and_bones_state::memory_usage() const {
+    return sizeof(transform_nodes_and_bones_state) + ::memory_usage(canvas) +
+        ::memory_usage(nodes) + ::memory_usage(old_positions) +
+        ::memory_usage(bones) + ::memory_usage(old_rot_constraints);
+}
+
 mdl::command mdl::commands::make_transform_bones_or_nodes_command(
         project& proj,
         const std::vector<handle>& nodes,
@@ -220,54 +593,205 @@ mdl::command mdl::commands::make_transform_bones_or_nodes_command(
             } else {
                 throw std::runtime_error("bad call to make_transform_bones_or_nodes_command");
             }
+            if (proj.journal_) {
+                proj.log(current_positions(proj.world_, state->nodes));
+                if (!state->bones.empty()) {
+                    proj.log(current_rot_constraints(proj.world_, state->bones));
+                }
+            }
+            proj.mark_dirty(state->canvas, state->nodes, state->bones);
             emit proj.refresh_canvas(proj, state->canvas, false);
         },
         [state](project& proj) {
-            for (auto node_hnd : state->nodes) {
-                auto& node = node_hnd.to<sm::node>(proj.world_);
-                node.set_world_pos(state->old_node_to_position[node_hnd]);
-            }
-            for (auto bone_hnd : state->bones) {
-                auto& bone = bone_hnd.to<sm::bone>(proj.world_);
-                if (state->old_bone_to_rotcon.contains(bone_hnd)) {
-                    auto rot_con = state->old_bone_to_rotcon[bone_hnd];
+            for (size_t i = 0; i < state->nodes.size(); ++i) {
+                auto& node = state->nodes[i].to<sm::node>(proj.world_);
+                node.set_world_pos(state->old_positions[i]);
+            }
+            for (size_t i = 0; i < state->bones.size(); ++i) {
+                auto& bone = state->bones[i].to<sm::bone>(proj.world_);
+                const auto& rot_con = state->old_rot_constraints[i];
+                if (rot_con) {
                     bone.set_rotation_constraint(
-                        rot_con.start_angle, rot_con.span_angle, rot_con.relative_to_parent
+                        rot_con->start_angle, rot_con->span_angle, rot_con->relative_to_parent
                     );
-                } else if (state->old_bone_to_rotcon.empty() && bone.rotation_constraint()) {
+                } else if (bone.rotation_constraint()) {
                     bone.remove_rotation_constraint();
                 }
             }
+            if (proj.journal_) {
+                proj.log(current_positions(proj.world_, state->nodes));
+                if (!state->bones.empty()) {
+                    proj.log(current_rot_constraints(proj.world_, state->bones));
+                }
+            }
+            proj.mark_dirty(state->canvas, state->nodes, state->bones);
             emit proj.refresh_canvas(proj, state->canvas, false);
+        },
+        [state]() {
+            return state->memory_usage();
         }
     };
 }
 
+mdl::commands::edit_bones_state::edit_bones_state(
+        project& proj, const std::vector<handle>& bone_hnds, const bone_edit& e) :
+            edit(e),
+            bones(bone_hnds) {
+    auto bone_ptrs = bones |
+        rv::transform([&proj](const handle& hnd) { return &hnd.to<sm::bone>(proj.world_); }) |
+        r::to<std::vector<sm::bone*>>();
+    canvas = proj.canvas_name_from_skeleton(bone_ptrs.front()->owner().name());
+
+    if (std::holds_alternative<constraint_edit>(edit)) {
+        old_rot_constraints = bone_ptrs |
+            rv::transform([](sm::bone* bone) { return bone->rotation_constraint(); }) |
+            r::to<std::vector<std::optional<sm::rot_constraint>>>();
+        return;
+    }
+
+    auto downstream = sm::downstream_bones(bone_ptrs);
+    old_positions.reserve(downstream.size());
+    for (auto* bone : downstream) {
+        auto& node = bone->child_node();
+        old_positions.push_back({ to_handle(sm::ref(node)), node.world_pos() });
+    }
+}
+
+size_t mdl::commands::edit_bones_state::memory_usage() const {
+    return sizeof(edit_bones_state) + ::memory_usage(canvas) + ::memory_usage(bones) +
+        ::memory_usage(old_positions) + ::memory_usage(old_rot_constraints);
+}
+
+mdl::command mdl::commands::make_edit_bones_command(
+        project& proj, const std::vector<handle>& bones, const bone_edit& edit) {
+    auto state = std::make_shared<edit_bones_state>(proj, bones, edit);
+
+    // both directions log and mark dirty the same pieces: the moved nodes, or the bones
+    // whose constraints changed.
+    auto finish = [state](project& proj) {
+        auto moved = state->old_positions |
+            rv::transform([](const auto& np) { return np.node; }) |
+            r::to<std::vector<handle>>();
+        if (proj.journal_) {
+            if (!moved.empty()) {
+                proj.log(current_positions(proj.world_, moved));
+            }
+            if (!state->old_rot_constraints.empty()) {
+                proj.log(current_rot_constraints(proj.world_, state->bones));
+            }
+        }
+        proj.mark_dirty(state->canvas, moved, state->bones);
+        emit proj.refresh_canvas(proj, state->canvas, false);
+    };
+
+    return {
+        [state, finish](project& proj) {
+            auto bones = state->bones |
+                rv::transform(
+                    [&proj](const handle& hnd) { return &hnd.to<sm::bone>(proj.world_); }
+                ) | r::to<std::vector<sm::bone*>>();
+            std::visit(
+                overload{
+                    [&](const length_edit& e) {
+                        sm::set_length(bones, e.length);
+                    },
+                    [&](const rotation_edit& e) {
+                        sm::set_world_rotation(bones, e.world_rotation);
+                    },
+                    [&](const constraint_edit& e) {
+                        for (auto* bone : bones) {
+                            if (e.constraint) {
+                                bone->set_rotation_constraint(e.constraint->start_angle,
+                                    e.constraint->span_angle, e.constraint->relative_to_parent);
+                            } else {
+                                bone->remove_rotation_constraint();
+                            }
+                        }
+                    }
+                },
+                state->edit
+            );
+            finish(proj);
+        },
+        [state, finish](project& proj) {
+            for (const auto& [node_hnd, pos] : state->old_positions) {
+                node_hnd.to<sm::node>(proj.world_).set_world_pos(pos);
+            }
+            for (size_t i = 0; i < state->old_rot_constraints.size(); ++i) {
+                auto& bone = state->bones[i].to<sm::bone>(proj.world_);
+                const auto& rot_con = state->old_rot_constraints[i];
+                if (rot_con) {
+                    bone.set_rotation_constraint(
+                        rot_con->start_angle, rot_con->span_angle, rot_con->relative_to_parent
+                    );
+                } else if (bone.rotation_constraint()) {
+                    bone.remove_rotation_constraint();
+                }
+            }
+            finish(proj);
+        },
+        [state]() {
+            return state->memory_usage();
+        }
+    };
+}
+
+mdl::commands::node_positions_state::node_positions_state(project& proj,
+        const std::vector<std::tuple<handle, sm::point>>& old_locs,
+        const std::vector<std::tuple<handle, sm::point>>& new_locs) :
+        nodes(old_locs | rv::elements<0> | r::to<std::vector<handle>>()),
+        old_positions(old_locs | rv::elements<1> | r::to<std::vector<sm::point>>()) {
+
+    // the two lists are not guaranteed to be in the same order so pack the new
+    // positions parallel to the old.
+    std::unordered_map<handle, sm::point, handle_hash> new_loc_tbl;
+    for (const auto& [hnd, loc] : new_locs) {
+        new_loc_tbl[hnd] = loc;
+    }
+    new_positions = nodes |
+        rv::transform(
+            [&new_loc_tbl](const auto& hnd) {
+                return new_loc_tbl.at(hnd);
+            }
+        ) | r::to<std::vector<sm::point>>();
+
+    if (!nodes.empty()) {
+        auto& node = nodes.front().to<sm::node>(proj.world_);
+        canvas = proj.canvas_name_from_skeleton(node.owner().name());
+    }
+}
+
+size_t mdl::commands::node_positions_state::memory_usage() const {
+    return sizeof(node_positions_state) + ::memory_usage(canvas) +
+        ::memory_usage(nodes) + ::memory_usage(old_positions) + ::memory_usage(new_positions);
+}
+
 mdl::command mdl::commands::make_transform_node_positions_command(project& proj,
         const std::vector<std::tuple<handle, sm::point>>& old_locs, 
         const std::vector<std::tuple<handle, sm::point>>& new_locs) {
+    auto state = std::make_shared<node_positions_state>(proj, old_locs, new_locs);
+    auto set_positions = [state](project& proj, const std::vector<sm::point>& positions) {
+            for (size_t i = 0; i < state->nodes.size(); ++i) {
+                auto& node = state->nodes[i].to<sm::node>(proj.world_);
+                node.set_world_pos(positions[i]);
+            }
+            if (proj.journal_) {
+                proj.log(
+                    journal::set_positions{ piece_keys<sm::node>(proj.world_, state->nodes), positions }
+                );
+            }
+            proj.mark_dirty(state->canvas, state->nodes, {});
+            emit proj.refresh_canvas(proj, state->canvas, false);
+        };
     return {
-        [new_locs](project& proj) {
-             std::string canvas;
-             for (const auto& [node_hnd,loc] : new_locs) {
-                auto& node = node_hnd.to<sm::node>(proj.world_);
-                if (canvas.empty()) {
-                    canvas = proj.canvas_name_from_skeleton(node.owner().name());
-                }
-                node.set_world_pos(loc);
-             }
-            emit proj.refresh_canvas(proj, canvas, false);
+        [state, set_positions](project& proj) {
+            set_positions(proj, state->new_positions);
         },
-        [old_locs](project& proj) {
-             std::string canvas;
-             for (const auto& [node_hnd,loc] : old_locs) {
-                auto& node = node_hnd.to<sm::node>(proj.world_);
-                if (canvas.empty()) {
-                    canvas = proj.canvas_name_from_skeleton(node.owner().name());
-                }
-                node.set_world_pos(loc);
-             }
-            emit proj.refresh_canvas(proj, canvas, false);
+        [state, set_positions](project& proj) {
+            set_positions(proj, state->old_positions);
+        },
+        [state]() {
+            return state->memory_usage();
         }
     };
 }
@@ -277,12 +801,17 @@ mdl::command mdl::commands::make_add_tab_command(const std::string& tab)
     auto tab_name = std::make_shared<std::string>(tab);
     return {
         [tab_name](project& proj) {
-            proj.tabs_[*tab_name] = {};
+            proj.add_tab_aux(*tab_name);
+            proj.log(journal::add_tab{ *tab_name });
             emit proj.tab_created_or_deleted(*tab_name, true);
         },
         [tab_name](project& proj) {
-            proj.tabs_.erase(*tab_name);
+            proj.delete_tab_aux(*tab_name);
+            proj.log(journal::remove_tab{ *tab_name });
             emit proj.tab_created_or_deleted(*tab_name, false);
+        },
+        [tab_name]() {
+            return memory_usage(*tab_name);
         }
     };
 }
@@ -4,8 +4,10 @@
 #include <string>
 #include <expected>
 #include <variant>
-#include "../core/sm_types.h" 
-#include "../core/sm_visit.h" 
+#include <optional>
+#include "../core/sm_types.h"
+#include "../core/sm_visit.h"
+#include "../core/sm_snapshot.h"
 #include "project.h"
 #include <unordered_map>
 
@@ -13,47 +15,88 @@
 
 namespace mdl {
 
+    // Commands store only what they need to undo themselves: names that changed, pieces that
+    // were added or removed, and positions as packed arrays parallel to a list of handles.
+    // Every command reports its approximate footprint so the project can keep its history
+    // within a memory budget.
+    //
+    // Handles are ids, so a command that deletes pieces and later recreates them does so
+    // under their old ids; otherwise the handles held by commands further along the history
+    // would no longer resolve.
+
     class commands {
         friend class project;
     private:
 
-        template<typename T>
-        using handle_table = std::unordered_map< handle, T, handle_hash>;
-
+        // the skeleton is created from scratch by the first redo and restored from the
+        // snapshot undo took of it thereafter.
 
         struct create_node_state {
             std::string canvas_name;
-            std::string skeleton;
             sm::point loc;
+            handle skeleton;
+            std::optional<sm::skeleton_snapshot> created;
         };
 
+        // undoing an add-bone splits the merged skeleton back apart in place and then
+        // restores whatever names the merge changed, mapping merged name -> original name.
+
         struct add_bone_state {
             std::string canvas_name;
             handle u_hnd;
             handle v_hnd;
-            sm::world original;
-            std::string merged;
-
-            add_bone_state(const std::string& str, 
+            handle merged;
+            handle bone;
+            handle v_skeleton;
+            std::string v_skeleton_name;
+            sm::skeleton::renames u_node_renames;
+            sm::skeleton::renames u_bone_renames;
+            sm::skeleton::renames v_node_renames;
+            sm::skeleton::renames v_bone_renames;
+
+            add_bone_state(const std::string& str,
                 const handle& u_hnd,
                 const handle& v_hnd);
+            size_t memory_usage() const;
         };
 
         struct rename_state {
-            handle old_handle;
-            handle new_handle;
+            handle piece;
+            std::string old_name;
+            std::string new_name;
+
+            size_t memory_usage() const;
         };
 
+        // replacing skeletons removes every piece of the replacees the way a removal does,
+        // and undoing it removes the replacements the same way, so the state only ever holds
+        // the records of whichever side is out of the world. The replacements' snapshots are
+        // only needed until the first redo has created them.
+
         struct replace_skeleton_state {
             std::string canvas_name;
             std::vector<std::string> replacee_names;
-            sm::world replacees;
             std::vector<std::string> replacement_names;
-            sm::world replacements;
+            std::vector<sm::skeleton_snapshot> replacements;
+            std::vector<sm::piece_removal> removals;
 
             replace_skeleton_state(const std::string& canv,
                 const std::vector<std::string>& replacees,
-                const std::vector<sm::skel_ref>& replacements);
+                const std::vector<sm::skeleton_snapshot>& replacements);
+            size_t memory_usage() const;
+        };
+
+        // removal moves whatever survives into place rather than copying it, so all undo
+        // needs is a record per skeleton of the pieces it lost. A redo hands the previous
+        // records back so that the skeletons and copies it creates reclaim their ids.
+
+        struct remove_pieces_state {
+            std::string canvas_name;
+            std::vector<handle> nodes;
+            std::vector<handle> bones;
+            std::vector<sm::piece_removal> removals;
+
+            size_t memory_usage() const;
         };
 
         struct transform_nodes_and_bones_state {
@@ -61,9 +104,9 @@ namespace mdl {
             std::function<void(sm::node&)> transform_nodes;
             std::function<void(sm::bone&)> transform_bones;
             std::vector<handle> nodes;
+            std::vector<sm::point> old_positions;
             std::vector<handle> bones;
-            handle_table<sm::point> old_node_to_position;
-            handle_table<sm::rot_constraint> old_bone_to_rotcon;
+            std::vector<std::optional<sm::rot_constraint>> old_rot_constraints;
 
             transform_nodes_and_bones_state(
                 project& proj,
@@ -76,33 +119,59 @@ namespace mdl {
                 const std::vector<handle>& bones,
                 const std::function<void(sm::bone&)>& fn
             );
+            size_t memory_usage() const;
         };
 
-        template<sm::is_skel_piece T>
-        static void rename(project& proj, handle old_hnd, handle new_hnd) {
-            auto& old_obj = old_hnd.to<T>(proj.world_);
-            if (!new_hnd.piece_name.empty()) {
-                proj.rename_aux(sm::ref(old_obj), new_hnd.piece_name);
-            }
-            else {
-                proj.rename_aux(sm::ref(old_obj), new_hnd.skel_name);
-            }
-        }
+        // a length or rotation edit moves each node below the bones once, so undo keeps
+        // exactly those nodes with their old positions, packed in the order they move.
+
+        struct edit_bones_state {
+            struct node_position {
+                handle node;
+                sm::point position;
+            };
+
+            std::string canvas;
+            bone_edit edit;
+            std::vector<handle> bones;
+            std::vector<node_position> old_positions;
+            std::vector<std::optional<sm::rot_constraint>> old_rot_constraints;
+
+            edit_bones_state(project& proj, const std::vector<handle>& bones,
+                const bone_edit& edit);
+            size_t memory_usage() const;
+        };
+
+        struct node_positions_state {
+            std::string canvas;
+            std::vector<handle> nodes;
+            std::vector<sm::point> old_positions;
+            std::vector<sm::point> new_positions;
+
+            node_positions_state(
+                project& proj,
+                const std::vector<std::tuple<handle, sm::point>>& old_locs,
+                const std::vector<std::tuple<handle, sm::point>>& new_locs
+            );
+            size_t memory_usage() const;
+        };
 
         template<sm::is_skel_piece T>
         static command make_rename_command(skel_piece piece, const std::string& new_name) {
-            auto old_handle = to_handle(piece);
-            auto new_handle = (old_handle.piece_name.empty()) ?
-                handle{ new_name, {} } :
-                handle{ old_handle.skel_name, new_name };
-            auto state = std::make_shared<rename_state>(old_handle, new_handle);
+            auto old_name = std::visit([](auto ref) { return ref->name(); }, piece);
+            auto state = std::make_shared<rename_state>(to_handle(piece), old_name, new_name);
 
             return {
                 [state](mdl::project& proj) {
-                    rename<T>(proj, state->old_handle, state->new_handle);
+                    auto& obj = state->piece.template to<T>(proj.world_);
+                    proj.rename_aux(sm::ref(obj), state->new_name);
                 },
                 [state](mdl::project& proj) {
-                    rename<T>(proj, state->new_handle, state->old_handle);
+                    auto& obj = state->piece.template to<T>(proj.world_);
+                    proj.rename_aux(sm::ref(obj), state->old_name);
+                },
+                [state]() {
+                    return state->memory_usage();
                 }
             };
         }
@@ -115,6 +184,16 @@ namespace mdl {
             const std::vector<std::string>& replacees,
             const std::vector<sm::skel_ref>& replacements
         );
+        static command make_replace_skeletons_command(
+            const std::string& canvas_name,
+            const std::vector<std::string>& replacees,
+            const std::vector<sm::skeleton_snapshot>& replacements
+        );
+        static command make_remove_pieces_command(
+            const std::string& canvas_name,
+            const std::vector<handle>& nodes,
+            const std::vector<handle>& bones
+        );
         static command make_transform_bones_or_nodes_command(
             project& proj,
             const std::vector<handle>& nodes,
@@ -123,6 +202,12 @@ namespace mdl {
             const std::function<void(sm::bone&)>& bones_fn
         );
 
+        static command make_edit_bones_command(
+            project& proj,
+            const std::vector<handle>& bones,
+            const bone_edit& edit
+        );
+
         static command make_transform_node_positions_command(
             project& proj,
             const std::vector<std::tuple<handle, sm::point>>& old_locs,
@@ -131,4 +216,4 @@ namespace mdl {
 
         static command make_add_tab_command(const std::string& tab_name);
     };
-}
\ No newline at end of file
+}
@@ -11,46 +11,27 @@ namespace mdl {
         std::variant<sm::const_node_ref, sm::const_bone_ref, sm::const_skel_ref>;
     using skel_piece = std::variant<sm::node_ref, sm::bone_ref, sm::skel_ref>;
 
-    struct handle {
-    private:
-        template<sm::is_node_or_bone T>
-        std::expected<sm::ref<T>, sm::result> to_aux(
-                sm::world& world) const {
-            auto skel = world.skeleton(skel_name);
-            if (!skel) {
-                return std::unexpected(skel.error());
-            }
-
-            auto maybe_piece = skel->get().get_by_name<T>(piece_name);
-            if (!maybe_piece) {
-                return std::unexpected(sm::result::not_found);
-            }
-            return *maybe_piece;
-        }
+    // a handle refers to a skeleton, node, or bone by its id in the world rather than by name,
+    // so it survives renames and resolves in constant time. Ids are only unique per piece type,
+    // so a handle must be resolved as the same type of piece it was created from.
 
-        sm::expected_skel to_skeleton(sm::world& world) const;
-    public:
-        std::string skel_name;
-        std::string piece_name;
+    struct handle {
+        sm::piece_id id;
 
         bool operator==(const handle& hand) const;
+        size_t size_in_bytes() const;
 
         template<sm::is_skel_piece T>
         T& to(sm::world& world) const {
-            if constexpr (std::is_same<T, sm::skeleton>::value) {
-                auto val = to_skeleton(world);
-                if (!val) {
+            auto* piece = world.from_id<T>(id);
+            if (!piece) {
+                if constexpr (std::is_same<T, sm::skeleton>::value) {
                     throw std::runtime_error("invalid handle to skeleton");
-                }
-                return val->get();
-            }
-            else {
-                auto val = to_aux<T>(world);
-                if (!val) {
+                } else {
                     throw std::runtime_error("invalid handle to node/bone");
                 }
-                return val->get();
             }
+            return *piece;
         }
     };
 
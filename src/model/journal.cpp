@@ -0,0 +1,553 @@
+#include "journal.h"
+#include <QtGlobal>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <charconv>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+namespace fs = std::filesystem;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
+
+    constexpr char k_magic[] = { 'S', 'M', 'J', '1' };
+    constexpr auto k_segment_prefix = "journal-";
+    constexpr auto k_segment_extension = ".smjl";
+
+    // framing: [uint32 payload size][uint32 checksum][payload]. A crash mid-append leaves a
+    // short or corrupt final frame which the reader detects and treats as the end of the log.
+
+    uint32_t checksum(const char* data, size_t n) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < n; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    /*--------------------------------------------------------------------------------------------*/
+
+    template<typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void write(std::vector<char>& buf, T val) {
+        const char* bytes = reinterpret_cast<const char*>(&val);
+        buf.insert(buf.end(), bytes, bytes + sizeof(T));
+    }
+
+    void write(std::vector<char>& buf, const std::string& str) {
+        write(buf, static_cast<uint32_t>(str.size()));
+        buf.insert(buf.end(), str.begin(), str.end());
+    }
+
+    void write(std::vector<char>& buf, const sm::point& pt) {
+        write(buf, pt.x);
+        write(buf, pt.y);
+    }
+
+    void write(std::vector<char>& buf, const mdl::journal::piece_key& key) {
+        write(buf, key.skeleton);
+        write(buf, key.piece);
+    }
+
+    void write(std::vector<char>& buf, const std::tuple<int, int>& tup) {
+        write(buf, static_cast<int32_t>(std::get<0>(tup)));
+        write(buf, static_cast<int32_t>(std::get<1>(tup)));
+    }
+
+    void write(std::vector<char>& buf, const std::tuple<std::string, std::string>& tup) {
+        write(buf, std::get<0>(tup));
+        write(buf, std::get<1>(tup));
+    }
+
+    void write(std::vector<char>& buf, const std::optional<sm::rot_constraint>& rc) {
+        write(buf, static_cast<uint8_t>(rc.has_value()));
+        if (rc) {
+            write(buf, static_cast<uint8_t>(rc->relative_to_parent));
+            write(buf, rc->start_angle);
+            write(buf, rc->span_angle);
+        }
+    }
+
+    void write(std::vector<char>& buf, const sm::skeleton_snapshot& snap);
+
+    template<typename T>
+    void write(std::vector<char>& buf, const std::vector<T>& vec) {
+        write(buf, static_cast<uint32_t>(vec.size()));
+        for (const auto& item : vec) {
+            write(buf, item);
+        }
+    }
+
+    void write(std::vector<char>& buf, const sm::skeleton_snapshot& snap) {
+        write(buf, snap.name);
+        write(buf, static_cast<int32_t>(snap.root));
+        write(buf, snap.node_names);
+        write(buf, snap.node_positions);
+        write(buf, snap.bone_names);
+        write(buf, snap.bone_nodes);
+        write(buf, snap.bone_constraints);
+    }
+
+    void write_record(std::vector<char>& buf, const mdl::journal::record& rec) {
+        namespace jrnl = mdl::journal;
+        write(buf, static_cast<uint8_t>(rec.index()));
+        std::visit(
+            overload{
+                [&](const jrnl::add_tab& op) {
+                    write(buf, op.tab);
+                },
+                [&](const jrnl::remove_tab& op) {
+                    write(buf, op.tab);
+                },
+                [&](const jrnl::replace_skeletons& op) {
+                    write(buf, op.tab);
+                    write(buf, op.removed);
+                    write(buf, op.added);
+                },
+                [&](const jrnl::rename& op) {
+                    write(buf, op.type);
+                    write(buf, op.piece);
+                    write(buf, op.new_name);
+                },
+                [&](const jrnl::set_positions& op) {
+                    write(buf, op.nodes);
+                    write(buf, op.positions);
+                },
+                [&](const jrnl::set_rot_constraints& op) {
+                    write(buf, op.bones);
+                    write(buf, op.constraints);
+                },
+                [&](const jrnl::open_project& op) {
+                    write(buf, op.json);
+                },
+                [&](const jrnl::remove_pieces& op) {
+                    write(buf, op.tab);
+                    write(buf, op.nodes);
+                    write(buf, op.bones);
+                },
+                [&](const jrnl::add_bone& op) {
+                    write(buf, op.tab);
+                    write(buf, op.u);
+                    write(buf, op.v);
+                    write(buf, op.bone);
+                    write(buf, op.u_nodes);
+                    write(buf, op.u_bones);
+                    write(buf, op.v_nodes);
+                    write(buf, op.v_bones);
+                },
+                [&](const jrnl::remove_bone& op) {
+                    write(buf, op.tab);
+                    write(buf, op.bone);
+                    write(buf, op.v_skeleton);
+                    write(buf, op.u_nodes);
+                    write(buf, op.u_bones);
+                    write(buf, op.v_nodes);
+                    write(buf, op.v_bones);
+                }
+            },
+            rec
+        );
+    }
+
+    /*--------------------------------------------------------------------------------------------*/
+
+    class reader {
+        const char* cur_;
+        const char* end_;
+
+    public:
+        reader(const char* begin, const char* end) : cur_(begin), end_(end)
+        {}
+
+        const char* take(size_t n) {
+            if (static_cast<size_t>(end_ - cur_) < n) {
+                throw std::runtime_error("truncated journal record");
+            }
+            auto* p = cur_;
+            cur_ += n;
+            return p;
+        }
+
+        template<typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+        void read(T& val) {
+            std::memcpy(&val, take(sizeof(T)), sizeof(T));
+        }
+
+        void read(std::string& str) {
+            uint32_t n;
+            read(n);
+            auto* p = take(n);
+            str.assign(p, n);
+        }
+
+        void read(sm::point& pt) {
+            read(pt.x);
+            read(pt.y);
+        }
+
+        void read(mdl::journal::piece_key& key) {
+            read(key.skeleton);
+            read(key.piece);
+        }
+
+        void read(std::tuple<int, int>& tup) {
+            int32_t u, v;
+            read(u);
+            read(v);
+            tup = { u, v };
+        }
+
+        void read(std::tuple<std::string, std::string>& tup) {
+            read(std::get<0>(tup));
+            read(std::get<1>(tup));
+        }
+
+        void read(std::optional<sm::rot_constraint>& rc) {
+            uint8_t has_value;
+            read(has_value);
+            if (!has_value) {
+                rc = {};
+                return;
+            }
+            uint8_t relative_to_parent;
+            sm::rot_constraint constraint;
+            read(relative_to_parent);
+            read(constraint.start_angle);
+            read(constraint.span_angle);
+            constraint.relative_to_parent = relative_to_parent != 0;
+            rc = constraint;
+        }
+
+        void read(sm::skeleton_snapshot& snap) {
+            int32_t root;
+            read(snap.name);
+            read(root);
+            read(snap.node_names);
+            read(snap.node_positions);
+            read(snap.bone_names);
+            read(snap.bone_nodes);
+            read(snap.bone_constraints);
+            snap.root = root;
+        }
+
+        template<typename T>
+        void read(std::vector<T>& vec) {
+            uint32_t n;
+            read(n);
+            vec.clear();
+            vec.reserve(std::min<size_t>(n, end_ - cur_));
+            for (uint32_t i = 0; i < n; ++i) {
+                T item;
+                read(item);
+                vec.push_back(std::move(item));
+            }
+        }
+    };
+
+    template<typename T>
+    mdl::journal::record read_alternative(reader& rdr) {
+        T rec;
+        if constexpr (std::is_same_v<T, mdl::journal::add_tab> ||
+                std::is_same_v<T, mdl::journal::remove_tab>) {
+            rdr.read(rec.tab);
+        } else if constexpr (std::is_same_v<T, mdl::journal::replace_skeletons>) {
+            rdr.read(rec.tab);
+            rdr.read(rec.removed);
+            rdr.read(rec.added);
+        } else if constexpr (std::is_same_v<T, mdl::journal::rename>) {
+            rdr.read(rec.type);
+            rdr.read(rec.piece);
+            rdr.read(rec.new_name);
+        } else if constexpr (std::is_same_v<T, mdl::journal::set_positions>) {
+            rdr.read(rec.nodes);
+            rdr.read(rec.positions);
+        } else if constexpr (std::is_same_v<T, mdl::journal::set_rot_constraints>) {
+            rdr.read(rec.bones);
+            rdr.read(rec.constraints);
+        } else if constexpr (std::is_same_v<T, mdl::journal::open_project>) {
+            rdr.read(rec.json);
+        } else if constexpr (std::is_same_v<T, mdl::journal::remove_pieces>) {
+            rdr.read(rec.tab);
+            rdr.read(rec.nodes);
+            rdr.read(rec.bones);
+        } else if constexpr (std::is_same_v<T, mdl::journal::add_bone>) {
+            rdr.read(rec.tab);
+            rdr.read(rec.u);
+            rdr.read(rec.v);
+            rdr.read(rec.bone);
+            rdr.read(rec.u_nodes);
+            rdr.read(rec.u_bones);
+            rdr.read(rec.v_nodes);
+            rdr.read(rec.v_bones);
+        } else if constexpr (std::is_same_v<T, mdl::journal::remove_bone>) {
+            rdr.read(rec.tab);
+            rdr.read(rec.bone);
+            rdr.read(rec.v_skeleton);
+            rdr.read(rec.u_nodes);
+            rdr.read(rec.u_bones);
+            rdr.read(rec.v_nodes);
+            rdr.read(rec.v_bones);
+        }
+        return rec;
+    }
+
+    mdl::journal::record read_record(reader& rdr) {
+        namespace jrnl = mdl::journal;
+        uint8_t index;
+        rdr.read(index);
+        switch (index) {
+            case 0: return read_alternative<jrnl::add_tab>(rdr);
+            case 1: return read_alternative<jrnl::remove_tab>(rdr);
+            case 2: return read_alternative<jrnl::replace_skeletons>(rdr);
+            case 3: return read_alternative<jrnl::rename>(rdr);
+            case 4: return read_alternative<jrnl::set_positions>(rdr);
+            case 5: return read_alternative<jrnl::set_rot_constraints>(rdr);
+            case 6: return read_alternative<jrnl::open_project>(rdr);
+            case 7: return read_alternative<jrnl::remove_pieces>(rdr);
+            case 8: return read_alternative<jrnl::add_bone>(rdr);
+            case 9: return read_alternative<jrnl::remove_bone>(rdr);
+        }
+        throw std::runtime_error("unknown journal record");
+    }
+
+    /*--------------------------------------------------------------------------------------------*/
+
+    std::optional<uint64_t> segment_first_revision(const fs::path& path) {
+        auto stem = path.stem().string();
+        std::string prefix = k_segment_prefix;
+        if (path.extension() != k_segment_extension || !stem.starts_with(prefix)) {
+            return {};
+        }
+        uint64_t revision;
+        auto [ptr, ec] = std::from_chars(
+            stem.data() + prefix.size(), stem.data() + stem.size(), revision
+        );
+        if (ec != std::errc{} || ptr != stem.data() + stem.size()) {
+            return {};
+        }
+        return revision;
+    }
+
+    std::vector<std::tuple<uint64_t, fs::path>> segments(const std::string& directory) {
+        std::vector<std::tuple<uint64_t, fs::path>> segs;
+        std::error_code ec;
+        for (const auto& dir_entry : fs::directory_iterator(directory, ec)) {
+            auto revision = segment_first_revision(dir_entry.path());
+            if (revision) {
+                segs.emplace_back(*revision, dir_entry.path());
+            }
+        }
+        r::sort(segs);
+        return segs;
+    }
+
+    fs::path segment_path(const std::string& directory, uint64_t first_revision) {
+        auto digits = std::to_string(first_revision);
+        auto padded = std::string(20 - std::min<size_t>(20, digits.size()), '0') + digits;
+        return fs::path(directory) / (k_segment_prefix + padded + k_segment_extension);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+mdl::journal::piece_key mdl::journal::to_key(const skel_piece& piece) {
+    return std::visit(
+        overload{
+            [](sm::is_node_or_bone_ref auto node_or_bone)->piece_key {
+                return { node_or_bone->owner().name(), node_or_bone->name() };
+            },
+            [](sm::skel_ref skel)->piece_key {
+                return { skel->name(), {} };
+            }
+        },
+        piece
+    );
+}
+
+std::vector<std::string> mdl::journal::segment_paths(const std::string& directory) {
+    return segments(directory) |
+        rv::transform(
+            [](const auto& seg) {
+                return std::get<1>(seg).string();
+            }
+        ) | r::to<std::vector<std::string>>();
+}
+
+std::vector<mdl::journal::entry> mdl::journal::read_segment(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> contents{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    std::vector<entry> entries;
+
+    if (contents.size() < sizeof(k_magic) ||
+            !std::equal(std::begin(k_magic), std::end(k_magic), contents.begin())) {
+        return entries;
+    }
+
+    reader frames(contents.data() + sizeof(k_magic), contents.data() + contents.size());
+    try {
+        while (true) {
+            uint32_t size, sum;
+            frames.read(size);
+            frames.read(sum);
+            const char* payload = frames.take(size);
+            if (checksum(payload, size) != sum) {
+                break;
+            }
+            reader rdr(payload, payload + size);
+            entry e;
+            rdr.read(e.revision);
+            e.rec = read_record(rdr);
+            entries.push_back(std::move(e));
+        }
+    } catch (...) {
+        // a torn final frame just marks the end of what made it to disk.
+    }
+
+    return entries;
+}
+
+void mdl::journal::delete_segments(const std::string& directory) {
+    for (const auto& [revision, path] : segments(directory)) {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+mdl::journal::writer::writer(const std::string& directory, uint64_t first_revision) :
+        directory_(directory),
+        file_(nullptr),
+        first_revision_(first_revision) {
+    open_segment(first_revision);
+    worker_ = std::jthread(
+        [this](std::stop_token token) {
+            run(token);
+        }
+    );
+}
+
+void mdl::journal::writer::run(std::stop_token token) {
+    while (true) {
+        std::vector<task> batch;
+        {
+            std::unique_lock lock(mutex_);
+            has_tasks_.wait(lock, token, [this]() { return !tasks_.empty(); });
+            if (tasks_.empty()) {
+                break;
+            }
+            batch.swap(tasks_);
+        }
+
+        for (auto& t : batch) {
+            std::visit(
+                overload{
+                    [this](const std::vector<char>& bytes) {
+                        if (file_) {
+                            std::fwrite(bytes.data(), 1, bytes.size(), file_);
+                        }
+                    },
+                    [this](const rotation& rot) {
+                        close_segment();
+                        open_segment(rot.first_revision);
+                    },
+                    [this](const discard& dis) {
+                        discard_segments(dis.before_revision);
+                    }
+                },
+                t
+            );
+        }
+        sync();
+    }
+    close_segment();
+}
+
+void mdl::journal::writer::push(task&& t) {
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(t));
+    }
+    has_tasks_.notify_one();
+}
+
+void mdl::journal::writer::open_segment(uint64_t first_revision) {
+    first_revision_ = first_revision;
+    auto path = segment_path(directory_, first_revision);
+    std::error_code ec;
+    bool is_new = !fs::exists(path, ec) || fs::file_size(path, ec) == 0;
+    file_ = std::fopen(path.string().c_str(), "ab");
+    if (file_ && is_new) {
+        std::fwrite(k_magic, 1, sizeof(k_magic), file_);
+    }
+}
+
+void mdl::journal::writer::sync() {
+    if (!file_) {
+        return;
+    }
+    std::fflush(file_);
+#ifdef Q_OS_WIN
+    _commit(_fileno(file_));
+#else
+    fsync(fileno(file_));
+#endif
+}
+
+void mdl::journal::writer::close_segment() {
+    if (!file_) {
+        return;
+    }
+    sync();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void mdl::journal::writer::discard_segments(uint64_t before_revision) {
+    for (const auto& [revision, path] : segments(directory_)) {
+        if (revision < before_revision && revision != first_revision_) {
+            std::error_code ec;
+            fs::remove(path, ec);
+        }
+    }
+}
+
+// serialization happens on the calling thread since it needs the record, which may refer to
+// the live project, and it is cheap next to the i/o left to the worker.
+
+void mdl::journal::writer::append(uint64_t revision, const record& rec) {
+    std::vector<char> payload;
+    write(payload, revision);
+    write_record(payload, rec);
+
+    std::vector<char> frame;
+    frame.reserve(payload.size() + 2 * sizeof(uint32_t));
+    write(frame, static_cast<uint32_t>(payload.size()));
+    write(frame, checksum(payload.data(), payload.size()));
+    frame.insert(frame.end(), payload.begin(), payload.end());
+
+    push(std::move(frame));
+}
+
+void mdl::journal::writer::rotate(uint64_t first_revision) {
+    push(rotation{ first_revision });
+}
+
+void mdl::journal::writer::discard_before(uint64_t revision) {
+    push(discard{ revision });
+}
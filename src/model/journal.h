@@ -0,0 +1,181 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <variant>
+#include <optional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include <cstdio>
+#include <tuple>
+#include "../core/sm_types.h"
+#include "../core/sm_snapshot.h"
+#include "handle.h"
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace mdl::journal {
+
+    // Journal records describe the effect of a command, undo, or redo on the project rather
+    // than the command itself, so replaying them does not depend on undo history that may
+    // predate the snapshot being replayed onto. Each record is tagged with the project
+    // revision that produced it.
+    //
+    // Records refer to skeletons, nodes, and bones by name rather than by handle because
+    // handles are ids that are only meaningful in the world that issued them, whereas a
+    // journal is replayed onto a world loaded from a snapshot.
+
+    enum class piece_type : uint8_t {
+        node,
+        bone,
+        skeleton
+    };
+
+    struct piece_key {
+        std::string skeleton;
+        std::string piece;
+    };
+
+    struct add_tab {
+        std::string tab;
+    };
+
+    struct remove_tab {
+        std::string tab;
+    };
+
+    struct replace_skeletons {
+        std::string tab;
+        std::vector<std::string> removed;
+        std::vector<sm::skeleton_snapshot> added;
+    };
+
+    struct rename {
+        piece_type type;
+        piece_key piece;
+        std::string new_name;
+    };
+
+    struct set_positions {
+        std::vector<piece_key> nodes;
+        std::vector<sm::point> positions;
+    };
+
+    struct set_rot_constraints {
+        std::vector<piece_key> bones;
+        std::vector<std::optional<sm::rot_constraint>> constraints;
+    };
+
+    struct open_project {
+        std::string json;
+    };
+
+    // replaying a removal removes the same pieces again, which splits what is left of their
+    // skeletons the same way it did the first time.
+
+    struct remove_pieces {
+        std::string tab;
+        std::vector<piece_key> nodes;
+        std::vector<piece_key> bones;
+    };
+
+    // a new bone records only the skeletons it merged and the names the merge changed, which
+    // map original to merged names. Replaying it merges the same skeletons and then renames
+    // anything the merge named differently this time.
+
+    using renames = std::vector<std::tuple<std::string, std::string>>;
+
+    struct add_bone {
+        std::string tab;
+        piece_key u;
+        piece_key v;
+        std::string bone;
+        renames u_nodes;
+        renames u_bones;
+        renames v_nodes;
+        renames v_bones;
+    };
+
+    // undoing a new bone splits its skeleton back apart and restores the names the merge
+    // changed; here the renames map merged to original names.
+
+    struct remove_bone {
+        std::string tab;
+        piece_key bone;
+        std::string v_skeleton;
+        renames u_nodes;
+        renames u_bones;
+        renames v_nodes;
+        renames v_bones;
+    };
+
+    using record = std::variant<
+        add_tab,
+        remove_tab,
+        replace_skeletons,
+        rename,
+        set_positions,
+        set_rot_constraints,
+        open_project,
+        remove_pieces,
+        add_bone,
+        remove_bone
+    >;
+
+    struct entry {
+        uint64_t revision;
+        record rec;
+    };
+
+    piece_key to_key(const skel_piece& piece);
+
+    std::vector<std::string> segment_paths(const std::string& directory);
+    std::vector<entry> read_segment(const std::string& path);
+    void delete_segments(const std::string& directory);
+
+    // The writer appends framed, checksummed records to the current segment file on a worker
+    // thread. Whatever has queued up while the previous batch was being written is written as
+    // the next batch and synced to disk once. Segments are named by the first revision they
+    // may contain so that once a snapshot of revision n is safely on disk every segment that
+    // precedes the one beginning at n + 1 can be discarded.
+
+    class writer {
+
+        struct rotation {
+            uint64_t first_revision;
+        };
+
+        struct discard {
+            uint64_t before_revision;
+        };
+
+        using task = std::variant<std::vector<char>, rotation, discard>;
+
+        std::string directory_;
+        std::mutex mutex_;
+        std::condition_variable_any has_tasks_;
+        std::vector<task> tasks_;
+        std::FILE* file_;
+        uint64_t first_revision_;
+        std::jthread worker_;
+
+        void run(std::stop_token token);
+        void push(task&& t);
+        void open_segment(uint64_t first_revision);
+        void sync();
+        void close_segment();
+        void discard_segments(uint64_t before_revision);
+
+    public:
+        writer(const std::string& directory, uint64_t first_revision);
+        writer(const writer&) = delete;
+        writer& operator=(const writer&) = delete;
+
+        void append(uint64_t revision, const record& rec);
+        void rotate(uint64_t first_revision);
+        void discard_before(uint64_t revision);
+    };
+
+}
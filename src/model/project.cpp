@@ -7,6 +7,9 @@
 #include <ranges>
 #include <optional>
 #include <tuple>
+#include <map>
+#include <unordered_map>
+#include <iterator>
 
 using json = nlohmann::json;
 namespace r = std::ranges;
@@ -16,9 +19,32 @@ namespace rv = std::ranges::views;
 
 namespace {
 
+    constexpr size_t k_default_undo_memory_budget = 64 * 1024 * 1024;
+
+    size_t memory_usage(const mdl::command& cmd) {
+        return sizeof(mdl::command) + ((cmd.memory_usage) ? cmd.memory_usage() : 0);
+    }
+
     template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
 
-    json tabs_to_json(const std::unordered_map<std::string, std::vector<std::string>>& tabs) {
+    template<sm::is_skel_piece T>
+    T& from_key(sm::world& world, const mdl::journal::piece_key& key) {
+        auto skel = world.skeleton(key.skeleton);
+        if (!skel) {
+            throw std::runtime_error("journal replay: unknown skeleton");
+        }
+        if constexpr (std::is_same<T, sm::skeleton>::value) {
+            return skel->get();
+        } else {
+            auto piece = skel->get().get_by_name<T>(key.piece);
+            if (!piece) {
+                throw std::runtime_error("journal replay: unknown node/bone");
+            }
+            return piece->get();
+        }
+    }
+
+    json tabs_to_json(const auto& tabs) {
         return tabs |
             rv::transform(
                 [](const auto& item)->json {
@@ -42,7 +68,7 @@ namespace {
 
     using tab_table = std::unordered_map<std::string, std::vector<std::string>>;
 
-    std::optional<std::tuple<tab_table, sm::world>> json_to_project_components(
+    std::optional<std::tuple<tab_table, sm::world, uint64_t>> json_to_project_components(
             const std::string& str) {
         try {
 
@@ -55,13 +81,46 @@ namespace {
                 throw result;
             }
 
-            return { {new_tabs, std::move(new_world) } };
+            // only autosave snapshots carry a revision
+            uint64_t revision = proj.value("revision", uint64_t{ 0 });
+
+            return { {new_tabs, std::move(new_world), revision } };
 
         } catch (...) {
             return {};
         };
     }
 
+    // each piece of a skeleton paired with the name a recorded merge gave it, which is its
+    // current name unless the merge renamed it.
+
+    template<typename T>
+    std::vector<std::tuple<T*, std::string>> merged_names(auto pieces,
+            const mdl::journal::renames& renames) {
+        std::unordered_map<std::string, std::string> merged;
+        for (const auto& [original_name, merged_name] : renames) {
+            merged[original_name] = merged_name;
+        }
+        return pieces |
+            rv::transform(
+                [&merged](auto piece)->std::tuple<T*, std::string> {
+                    auto iter = merged.find(piece->name());
+                    return { piece.ptr(), (iter != merged.end()) ? iter->second : piece->name() };
+                }
+            ) | r::to<std::vector<std::tuple<T*, std::string>>>();
+    }
+
+    template<typename T>
+    sm::skeleton::renames renames_to(const std::vector<std::tuple<T*, std::string>>& names) {
+        sm::skeleton::renames renames;
+        for (const auto& [piece, name] : names) {
+            if (piece->name() != name) {
+                renames.emplace_back(piece->name(), name);
+            }
+        }
+        return renames;
+    }
+
     std::string get_prefix(const std::string& name) {
         if (!name.contains('-')) {
             return name;
@@ -89,32 +148,158 @@ namespace {
 
 /*------------------------------------------------------------------------------------------------*/
 
-void mdl::project::delete_skeleton_name_from_canvas_table(
-        const std::string& tab, const std::string& skel) {
+void mdl::project::set_tabs(const tab_table& tabs) {
+    tabs_ = tabs;
+    skeleton_to_tab_.clear();
+    for (const auto& [tab, skels] : tabs_) {
+        for (size_t i = 0; i < skels.size(); ++i) {
+            skeleton_to_tab_[skels[i]] = { tab, i };
+        }
+    }
+}
+
+void mdl::project::add_tab_aux(const std::string& tab) {
+    delete_tab_aux(tab);
+    tabs_[tab] = {};
+}
+
+void mdl::project::delete_tab_aux(const std::string& tab) {
     auto iter_tab = tabs_.find(tab);
     if (iter_tab == tabs_.end()) {
         return;
     }
-    auto& skel_group = iter_tab->second;
-    auto iter_skel = r::find_if(skel_group, [skel](auto str) {return str == skel; });
-    if (iter_skel == skel_group.end()) {
+    for (const auto& skel : iter_tab->second) {
+        skeleton_to_tab_.erase(skel);
+    }
+    tabs_.erase(iter_tab);
+}
+
+void mdl::project::add_skeleton_name_to_canvas_table(
+        const std::string& tab, const std::string& skel) {
+    auto& skel_group = tabs_[tab];
+    skeleton_to_tab_[skel] = { tab, skel_group.size() };
+    skel_group.push_back(skel);
+}
+
+// the order of the skeletons on a tab is not meaningful, so a name is removed by moving the
+// last name on the tab into its place.
+
+void mdl::project::delete_skeleton_name_from_canvas_table(
+        const std::string& tab, const std::string& skel) {
+    auto iter_loc = skeleton_to_tab_.find(skel);
+    if (iter_loc == skeleton_to_tab_.end() || iter_loc->second.tab != tab) {
         return;
     }
-    skel_group.erase(iter_skel);
+    auto index = iter_loc->second.index;
+    skeleton_to_tab_.erase(iter_loc);
+
+    auto& skel_group = tabs_.at(tab);
+    if (index != skel_group.size() - 1) {
+        skel_group[index] = std::move(skel_group.back());
+        skeleton_to_tab_.at(skel_group[index]).index = index;
+    }
+    skel_group.pop_back();
+}
+
+void mdl::project::rename_skeleton_in_canvas_table(
+        const std::string& old_name, const std::string& new_name) {
+    auto iter_loc = skeleton_to_tab_.find(old_name);
+    if (iter_loc == skeleton_to_tab_.end()) {
+        return;
+    }
+    auto loc = iter_loc->second;
+    skeleton_to_tab_.erase(iter_loc);
+    tabs_.at(loc.tab)[loc.index] = new_name;
+    skeleton_to_tab_[new_name] = loc;
+}
+
+void mdl::project::mark_dirty(const std::string& tab,
+        const std::vector<handle>& nodes, const std::vector<handle>& bones) {
+    auto& dirty = dirty_[tab];
+    dirty.nodes.insert(dirty.nodes.end(), nodes.begin(), nodes.end());
+    dirty.bones.insert(dirty.bones.end(), bones.begin(), bones.end());
+}
+
+// hands the pieces marked dirty on the given tab to the caller, skipping any that have since
+// been deleted, and resets the tab's dirty set.
+
+std::tuple<std::vector<sm::node*>, std::vector<sm::bone*>> mdl::project::take_dirty(
+        const std::string& tab) {
+    auto iter = dirty_.find(tab);
+    if (iter == dirty_.end()) {
+        return {};
+    }
+    auto dirty = std::move(iter->second);
+    dirty_.erase(iter);
+
+    std::vector<sm::node*> nodes;
+    nodes.reserve(dirty.nodes.size());
+    for (const auto& hnd : dirty.nodes) {
+        if (auto* node = world_.from_id<sm::node>(hnd.id)) {
+            nodes.push_back(node);
+        }
+    }
+    std::vector<sm::bone*> bones;
+    bones.reserve(dirty.bones.size());
+    for (const auto& hnd : dirty.bones) {
+        if (auto* bone = world_.from_id<sm::bone>(hnd.id)) {
+            bones.push_back(bone);
+        }
+    }
+    return { std::move(nodes), std::move(bones) };
+}
+
+void mdl::project::push_history(std::deque<history_entry>& stack, const command& cmd) {
+    auto bytes = memory_usage(cmd);
+    stack.push_back({ cmd, bytes });
+    undo_memory_usage_ += bytes;
+}
+
+mdl::command mdl::project::pop_history(std::deque<history_entry>& stack) {
+    auto entry = std::move(stack.back());
+    stack.pop_back();
+    undo_memory_usage_ -= entry.memory_usage;
+    return std::move(entry.cmd);
+}
+
+void mdl::project::clear_history() {
+    redo_stack_ = {};
+    undo_stack_ = {};
+    undo_memory_usage_ = 0;
 }
 
 void mdl::project::clear_redo_stack() {
+    for (const auto& entry : redo_stack_) {
+        undo_memory_usage_ -= entry.memory_usage;
+    }
     redo_stack_ = {};
 }
 
 void mdl::project::execute_command(const command& cmd) {
     clear_redo_stack();
+    ++revision_;
     cmd.redo(*this);
-    undo_stack_.push(cmd);
+    push_history(undo_stack_, cmd);
+    enforce_undo_memory_budget();
     emit refresh_undo_redo_state(can_redo(), can_undo());
 }
 
-mdl::project::project()
+// drops the oldest undo history until the total footprint of the undo and redo stacks
+// fits in the budget. The most recent command is always kept so the last action can
+// be undone no matter how large it is.
+
+void mdl::project::enforce_undo_memory_budget() {
+    while (undo_memory_usage_ > undo_memory_budget_ && undo_stack_.size() > 1) {
+        undo_memory_usage_ -= undo_stack_.front().memory_usage;
+        undo_stack_.pop_front();
+    }
+}
+
+mdl::project::project() :
+    undo_memory_usage_(0),
+    undo_memory_budget_(k_default_undo_memory_budget),
+    revision_(0),
+    journal_(nullptr)
 {}
 
 const sm::world& mdl::project::world() const {
@@ -127,19 +312,21 @@ sm::world& mdl::project::world() {
 
 void mdl::project::clear() {
     tabs_.clear();
+    skeleton_to_tab_.clear();
+    dirty_.clear();
     world_.clear();
-    redo_stack_ = {};
-    undo_stack_ = {};
+    clear_history();
 }
 
 void mdl::project::undo() {
     if (!can_undo()) {
         return;
     }
-    auto cmd = undo_stack_.top();
-    undo_stack_.pop();
+    auto cmd = pop_history(undo_stack_);
+    ++revision_;
     cmd.undo(*this);
-    redo_stack_.push(cmd);
+    push_history(redo_stack_, cmd);
+    enforce_undo_memory_budget();
 
     emit refresh_undo_redo_state(can_redo(), can_undo());
 }
@@ -148,10 +335,11 @@ void mdl::project::redo() {
     if (!can_redo()) {
         return;
     }
-    auto cmd = redo_stack_.top();
-    redo_stack_.pop();
+    auto cmd = pop_history(redo_stack_);
+    ++revision_;
     cmd.redo(*this);
-    undo_stack_.push(cmd);
+    push_history(undo_stack_, cmd);
+    enforce_undo_memory_budget();
 
     emit refresh_undo_redo_state(can_redo(), can_undo());
 }
@@ -164,6 +352,19 @@ bool mdl::project::can_redo() const {
     return !redo_stack_.empty();
 }
 
+size_t mdl::project::undo_memory_usage() const {
+    return undo_memory_usage_;
+}
+
+size_t mdl::project::undo_memory_budget() const {
+    return undo_memory_budget_;
+}
+
+void mdl::project::set_undo_memory_budget(size_t bytes) {
+    undo_memory_budget_ = bytes;
+    enforce_undo_memory_budget();
+}
+
 bool mdl::project::has_tab(const std::string& str) const {
     return tabs_.contains(str);
 }
@@ -182,6 +383,26 @@ std::string mdl::project::to_json() const {
     return stick_man_project.dump(4);
 }
 
+uint64_t mdl::project::revision() const {
+    return revision_;
+}
+
+mdl::project_snapshot mdl::project::snapshot() const {
+    return {
+        revision_,
+        tabs_ | rv::transform(
+                [](const auto& pair) {
+                    return std::tuple(pair.first, pair.second);
+                }
+            ) | r::to<std::vector<std::tuple<std::string, std::vector<std::string>>>>(),
+        world_.skeletons() | rv::transform(
+                [](auto skel) {
+                    return skel->snapshot();
+                }
+            ) | r::to<std::vector<sm::skeleton_snapshot>>()
+    };
+}
+
 bool mdl::project::from_json(const std::string& str) {
 
     auto comps = json_to_project_components(str);
@@ -190,13 +411,206 @@ bool mdl::project::from_json(const std::string& str) {
     }
 
     clear();
-    tabs_ = std::get<0>(*comps);
+    set_tabs(std::get<0>(*comps));
     world_ = std::move(std::get<1>(*comps));
+    ++revision_;
+    log(journal::open_project{ str });
 
     emit new_project_opened(*this);
     return true;
 }
 
+// restores the project to the state described by an autosave snapshot, which may be empty,
+// followed by the journal entries recorded after it. The snapshot is parsed and the journal
+// replayed before anything is replaced, so if either fails the project is left untouched.
+
+bool mdl::project::recover(const std::string& snapshot_json, 
+        const std::vector<journal::entry>& entries) {
+    tab_table tabs;
+    sm::world world;
+    uint64_t snapshot_revision = 0;
+    if (!snapshot_json.empty()) {
+        auto comps = json_to_project_components(snapshot_json);
+        if (!comps) {
+            return false;
+        }
+        std::tie(tabs, world, snapshot_revision) = std::move(*comps);
+    }
+
+    // replay runs against the recovered tabs and world swapped in for the current ones, and
+    // they are swapped back out if any entry cannot be applied.
+    auto old_tabs = std::move(tabs_);
+    auto old_skeleton_to_tab = std::move(skeleton_to_tab_);
+    auto old_world = std::move(world_);
+    auto* journal = std::exchange(journal_, nullptr);
+    set_tabs(tabs);
+    world_ = std::move(world);
+
+    bool success = true;
+    try {
+        for (const auto& entry : entries) {
+            if (entry.revision > snapshot_revision) {
+                apply(entry.rec);
+            }
+        }
+    } catch (...) {
+        success = false;
+    }
+    journal_ = journal;
+
+    if (!success) {
+        tabs_ = std::move(old_tabs);
+        skeleton_to_tab_ = std::move(old_skeleton_to_tab);
+        world_ = std::move(old_world);
+        return false;
+    }
+
+    dirty_.clear();
+    clear_history();
+    ++revision_;
+
+    emit new_project_opened(*this);
+    return true;
+}
+
+void mdl::project::set_journal(journal::writer* journal) {
+    journal_ = journal;
+}
+
+void mdl::project::log(const journal::record& rec) {
+    if (journal_) {
+        journal_->append(revision_, rec);
+    }
+}
+
+void mdl::project::apply(const journal::record& rec) {
+    std::visit(
+        overload{
+            [this](const journal::add_tab& op) {
+                add_tab_aux(op.tab);
+            },
+            [this](const journal::remove_tab& op) {
+                delete_tab_aux(op.tab);
+            },
+            [this](const journal::replace_skeletons& op) {
+                for (const auto& skel_name : op.removed) {
+                    delete_skeleton_name_from_canvas_table(op.tab, skel_name);
+                    world_.delete_skeleton(skel_name);
+                }
+                for (const auto& snapshot : op.added) {
+                    if (!world_.restore(snapshot)) {
+                        throw std::runtime_error("journal replay: restore failed");
+                    }
+                    add_skeleton_name_to_canvas_table(op.tab, snapshot.name);
+                }
+            },
+            [this](const journal::rename& op) {
+                auto result = sm::result::success;
+                if (op.type == journal::piece_type::skeleton) {
+                    auto& skel = from_key<sm::skeleton>(world_, op.piece);
+                    result = world_.set_name(skel, op.new_name);
+                    if (result == sm::result::success) {
+                        rename_skeleton_in_canvas_table(op.piece.skeleton, op.new_name);
+                    }
+                } else if (op.type == journal::piece_type::node) {
+                    auto& node = from_key<sm::node>(world_, op.piece);
+                    result = node.owner().set_name(node, op.new_name);
+                } else {
+                    auto& bone = from_key<sm::bone>(world_, op.piece);
+                    result = bone.owner().set_name(bone, op.new_name);
+                }
+                if (result != sm::result::success) {
+                    throw std::runtime_error("journal replay: rename failed");
+                }
+            },
+            [this](const journal::set_positions& op) {
+                for (size_t i = 0; i < op.nodes.size(); ++i) {
+                    from_key<sm::node>(world_, op.nodes[i]).set_world_pos(op.positions[i]);
+                }
+            },
+            [this](const journal::set_rot_constraints& op) {
+                for (size_t i = 0; i < op.bones.size(); ++i) {
+                    auto& bone = from_key<sm::bone>(world_, op.bones[i]);
+                    const auto& rot_con = op.constraints[i];
+                    if (rot_con) {
+                        bone.set_rotation_constraint(
+                            rot_con->start_angle, rot_con->span_angle, rot_con->relative_to_parent
+                        );
+                    } else if (bone.rotation_constraint()) {
+                        bone.remove_rotation_constraint();
+                    }
+                }
+            },
+            [this](const journal::open_project& op) {
+                auto comps = json_to_project_components(op.json);
+                if (!comps) {
+                    throw std::runtime_error("journal replay: invalid project");
+                }
+                dirty_.clear();
+                set_tabs(std::get<0>(*comps));
+                world_ = std::move(std::get<1>(*comps));
+            },
+            [this](const journal::remove_pieces& op) {
+                // skeletons are processed in name order, as the removal command does, so
+                // that the skeletons split off are named the same way.
+                std::map<std::string,
+                    std::tuple<std::vector<sm::node_ref>, std::vector<sm::bone_ref>>> pieces;
+                for (const auto& key : op.nodes) {
+                    std::get<0>(pieces[key.skeleton]).push_back(from_key<sm::node>(world_, key));
+                }
+                for (const auto& key : op.bones) {
+                    std::get<1>(pieces[key.skeleton]).push_back(from_key<sm::bone>(world_, key));
+                }
+                for (const auto& [skel_name, skel_pieces] : pieces) {
+                    const auto& [nodes, bones] = skel_pieces;
+                    auto& skel = from_key<sm::skeleton>(world_, { skel_name, {} });
+                    remove_pieces_aux(op.tab, skel, nodes, bones, nullptr);
+                }
+            },
+            [this](const journal::add_bone& op) {
+                auto& u = from_key<sm::node>(world_, op.u);
+                auto& v = from_key<sm::node>(world_, op.v);
+                auto nodes = merged_names<sm::node>(u.owner().nodes(), op.u_nodes);
+                auto bones = merged_names<sm::bone>(u.owner().bones(), op.u_bones);
+                r::move(merged_names<sm::node>(v.owner().nodes(), op.v_nodes),
+                    std::back_inserter(nodes));
+                r::move(merged_names<sm::bone>(v.owner().bones(), op.v_bones),
+                    std::back_inserter(bones));
+
+                delete_skeleton_name_from_canvas_table(op.tab, v.owner().name());
+                auto bone = world_.create_bone({}, u, v);
+                if (!bone) {
+                    throw std::runtime_error("journal replay: create_bone failed");
+                }
+                bones.emplace_back(bone->ptr(), op.bone);
+
+                // the merge only renames to resolve clashes, but which of two clashing pieces
+                // keeps its name depends on the order the skeleton is traversed in.
+                auto& merged = bone->get().owner();
+                if (merged.set_names(renames_to(nodes), renames_to(bones)) !=
+                        sm::result::success) {
+                    throw std::runtime_error("journal replay: merged names differ");
+                }
+            },
+            [this](const journal::remove_bone& op) {
+                auto& bone = from_key<sm::bone>(world_, op.bone);
+                auto& merged = bone.owner();
+                auto split = world_.split_skeleton(bone, op.v_skeleton);
+                if (!split) {
+                    throw std::runtime_error("journal replay: split_skeleton failed");
+                }
+                auto u_result = merged.set_names(op.u_nodes, op.u_bones);
+                auto v_result = split->get().set_names(op.v_nodes, op.v_bones);
+                if (u_result != sm::result::success || v_result != sm::result::success) {
+                    throw std::runtime_error("journal replay: restoring names failed");
+                }
+                add_skeleton_name_to_canvas_table(op.tab, op.v_skeleton);
+            }
+        },
+        rec
+    );
+}
+
 bool mdl::project::add_new_tab(const std::string& tab_name)
 {
     if (has_tab(tab_name)) {
@@ -221,20 +635,29 @@ void mdl::project::add_new_skeleton_root(const std::string& tab, sm::point loc)
     );
 }
 
-//TODO: maintain a skeleton -> canvas table...
 std::string mdl::project::canvas_name_from_skeleton(const std::string& skel) const {
-    for (const auto& [canv_name, skels] : tabs_) {
-        for (auto skel_name : skels) {
-            if (skel == skel_name) {
-                return canv_name;
-            }
-        }
+    auto iter = skeleton_to_tab_.find(skel);
+    if (iter == skeleton_to_tab_.end()) {
+        return {};
     }
-    return {};
+    return iter->second.tab;
 }
 
 void mdl::project::rename_aux(skel_piece piece_var, const std::string& new_name)
 {
+    journal::rename rename_record{
+        std::visit(
+            overload{
+                [](sm::node_ref)->journal::piece_type { return journal::piece_type::node; },
+                [](sm::bone_ref)->journal::piece_type { return journal::piece_type::bone; },
+                [](sm::skel_ref)->journal::piece_type { return journal::piece_type::skeleton; }
+            },
+            piece_var
+        ),
+        journal::to_key(piece_var),
+        new_name
+    };
+
     auto result = std::visit(
         [&](auto ref)->sm::result {
             auto& piece = ref.get();
@@ -246,7 +669,11 @@ void mdl::project::rename_aux(skel_piece piece_var, const std::string& new_name)
     if (result != sm::result::success) {
         throw std::runtime_error("mod::project::rename_aux");
     }
-    
+    if (rename_record.type == journal::piece_type::skeleton) {
+        rename_skeleton_in_canvas_table(rename_record.piece.skeleton, new_name);
+    }
+    log(rename_record);
+
     emit name_changed(piece_var, new_name);
 }
 
@@ -301,6 +728,18 @@ void mdl::project::transform(const std::vector<handle>& bones,
     );
 }
 
+// unlike transform(), which applies a function to each bone in turn, this edits the whole
+// set in one pass; see sm::set_length() and sm::set_world_rotation().
+
+void mdl::project::edit_bones(const std::vector<handle>& bones, const bone_edit& edit) {
+    if (bones.empty()) {
+        return;
+    }
+    execute_command(
+        commands::make_edit_bones_command(*this, bones, edit)
+    );
+}
+
 void mdl::project::transform_node_positions(const node_locs& old_locs, const node_locs& new_locs)
 {
     execute_command(
@@ -308,36 +747,51 @@ void mdl::project::transform_node_positions(const node_locs& old_locs, const nod
     );
 }
 
-void mdl::project::replace_skeletons_aux(const std::string& canvas_name,
-        const std::vector<std::string>& replacees,
-        const std::vector<sm::skel_ref>& replacements,
-        std::vector<std::string>* new_names) {
+// removes every piece of each of the named skeletons, which takes the skeletons out of the
+// world and the canvas table, and returns the records that restore them.
 
-    for (auto replacee : replacees) {
-        if (canvas_name_from_skeleton(replacee) != canvas_name) {
+std::vector<sm::piece_removal> mdl::project::remove_skeletons_aux(
+        const std::string& canvas_name, const std::vector<std::string>& skel_names) {
+    std::vector<sm::piece_removal> removals;
+    removals.reserve(skel_names.size());
+    for (const auto& skel_name : skel_names) {
+        if (canvas_name_from_skeleton(skel_name) != canvas_name) {
             throw std::runtime_error("replace_skeletons must be called on a single canvas");
         }
-        delete_skeleton_name_from_canvas_table(canvas_name, replacee);
-        world_.delete_skeleton(replacee);
-
+        auto& skel = world_.skeleton(skel_name)->get();
+        auto nodes = skel.nodes() | r::to<std::vector<sm::node_ref>>();
+        auto bones = skel.bones() | r::to<std::vector<sm::bone_ref>>();
+        removals.push_back(remove_pieces_aux(canvas_name, skel, nodes, bones, nullptr));
     }
-    bool should_rename = new_names != nullptr;
-    for (auto replacement : replacements) {
-        auto& skel = replacement.get();
-        auto new_skel = skel.copy_to(
-            world_, 
-            should_rename ? unique_skeleton_name(skel.name(), world_.skeleton_names()) : ""
+    return removals;
+}
+
+// creates skeletons from snapshots under names unique in the world, appending the names
+// they were given.
+
+void mdl::project::add_skeletons_aux(const std::string& canvas_name,
+        const std::vector<sm::skeleton_snapshot>& snapshots,
+        std::vector<std::string>& new_names) {
+    for (const auto& snapshot : snapshots) {
+        auto new_skel = world_.restore(
+            snapshot, unique_skeleton_name(snapshot.name, world_.skeleton_names())
         );
         if (!new_skel) {
             throw std::runtime_error("skeleton copy failed");
         }
-        if (should_rename) {
-            new_names->push_back(new_skel->get().name());
-        }
-        tabs_[canvas_name].push_back(new_skel->get().name());
+        new_names.push_back(new_skel->get().name());
+        add_skeleton_name_to_canvas_table(canvas_name, new_skel->get().name());
     }
+}
 
-    emit refresh_canvas(*this, canvas_name, true);
+std::vector<sm::skeleton_snapshot> mdl::project::snapshots_of(
+        const std::vector<std::string>& skel_names) const {
+    return skel_names |
+        rv::transform(
+            [this](const auto& skel_name) {
+                return world_.skeleton(skel_name)->get().snapshot();
+            }
+        ) | r::to<std::vector<sm::skeleton_snapshot>>();
 }
 
 void mdl::project::replace_skeletons(const std::string& canvas_name,
@@ -348,6 +802,96 @@ void mdl::project::replace_skeletons(const std::string& canvas_name,
     );
 }
 
+void mdl::project::replace_skeletons(const std::string& canvas_name,
+        const std::vector<std::string>& replacees,
+        const std::vector<sm::skeleton_snapshot>& replacements) {
+    execute_command(
+        commands::make_replace_skeletons_command(canvas_name, replacees, replacements)
+    );
+}
+
+// removes pieces from one skeleton in place and keeps the canvas table in step with the
+// skeletons the removal split off or deleted.
+
+sm::piece_removal mdl::project::remove_pieces_aux(const std::string& canvas_name,
+        sm::skeleton& skel, const std::vector<sm::node_ref>& nodes,
+        const std::vector<sm::bone_ref>& bones, const sm::piece_removal* previous) {
+    auto removal = world_.remove_pieces(skel, nodes, bones, previous);
+    if (!removal) {
+        throw std::runtime_error("piece removal failed");
+    }
+    if (removal->skeleton_removed) {
+        delete_skeleton_name_from_canvas_table(canvas_name, removal->skeleton_name);
+    }
+    for (auto split : removal->splits) {
+        add_skeleton_name_to_canvas_table(
+            canvas_name, world_.from_id<sm::skeleton>(split)->name()
+        );
+    }
+    return std::move(*removal);
+}
+
+void mdl::project::restore_pieces_aux(const std::string& canvas_name,
+        const sm::piece_removal& removal) {
+    for (auto split : removal.splits) {
+        auto* skel = world_.from_id<sm::skeleton>(split);
+        if (skel) {
+            delete_skeleton_name_from_canvas_table(canvas_name, skel->name());
+        }
+    }
+    if (world_.restore(removal) != sm::result::success) {
+        throw std::runtime_error("piece restore failed");
+    }
+    if (removal.skeleton_removed) {
+        add_skeleton_name_to_canvas_table(canvas_name, removal.skeleton_name);
+    }
+}
+
+void mdl::project::remove_pieces(const std::string& canvas_name,
+        const std::vector<handle>& nodes, const std::vector<handle>& bones) {
+    execute_command(
+        commands::make_remove_pieces_command(canvas_name, nodes, bones)
+    );
+}
+
+size_t mdl::project_snapshot::num_nodes() const {
+    size_t count = 0;
+    for (const auto& skel : skeletons) {
+        count += skel.num_nodes();
+    }
+    return count;
+}
+
+std::string mdl::project_snapshot::to_json() const {
+    auto skeletons_json = skeletons | 
+        rv::transform(&sm::skeleton_snapshot::to_json) | r::to<json>();
+    json world_json = {
+        {"version", 0.0},
+        {"skeletons", skeletons_json}
+    };
+    json stick_man_project = {
+        {"version", 0.0},
+        {"revision", revision},
+        {"tabs", tabs_to_json(tabs)},
+        {"world", world_json}
+    };
+
+    return stick_man_project.dump(4);
+}
+
+// a removal deletes its skeleton or restructures it and creates the skeletons it splits off;
+// restoring it does the opposite.
+
+void mdl::skeleton_changes::add_removal(const sm::piece_removal& removal) {
+    (removal.skeleton_removed ? removed : changed).push_back(removal.skeleton);
+    added.insert(added.end(), removal.splits.begin(), removal.splits.end());
+}
+
+void mdl::skeleton_changes::add_restore(const sm::piece_removal& removal) {
+    removed.insert(removed.end(), removal.splits.begin(), removal.splits.end());
+    (removal.skeleton_removed ? added : changed).push_back(removal.skeleton);
+}
+
 std::string mdl::unique_skeleton_name(const std::string& old_name,
     const std::vector<std::string>& used_names) {
     auto is_not_unique = r::find_if(used_names,
@@ -8,9 +8,14 @@
 #include <span>
 #include <string_view>
 #include <memory>
-#include <stack>
+#include <deque>
+#include <tuple>
+#include <variant>
+#include <optional>
+#include <cstdint>
 #include "../core/sm_skeleton.h"
 #include "handle.h"
+#include "journal.h"
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -21,30 +26,125 @@ namespace mdl {
     struct command {
         std::function<void(project&)> redo;
         std::function<void(project&)> undo;
+        std::function<size_t()> memory_usage;
     };
 
+    // a consistent copy of the project's tabs and skeletons as of some revision, cheap to
+    // capture on the UI thread and safe to serialize from any other thread.
+
+    struct project_snapshot {
+        uint64_t revision;
+        std::vector<std::tuple<std::string, std::vector<std::string>>> tabs;
+        std::vector<sm::skeleton_snapshot> skeletons;
+
+        size_t num_nodes() const;
+        std::string to_json() const;
+    };
+
+    // the nodes and bones of a tab changed since the tab's canvas last synced to the model.
+    // Commands that only move or restyle pieces mark them dirty rather than forcing the
+    // canvas to resync every item it has.
+
+    struct dirty_set {
+        std::vector<handle> nodes;
+        std::vector<handle> bones;
+    };
+
+    // the skeletons a command deleted, restructured, or created, by id, as found from the
+    // records of what it removed, restored, or split. Views of the skeletons update their rows
+    // from these rather than rebuilding; refresh_canvas follows for the canvas itself.
+
+    struct skeleton_changes {
+        std::vector<sm::piece_id> removed;
+        std::vector<sm::piece_id> changed;
+        std::vector<sm::piece_id> added;
+
+        void add_removal(const sm::piece_removal& removal);
+        void add_restore(const sm::piece_removal& removal);
+    };
+
+    // a property set on every bone of a selection at once; see project::edit_bones(). A
+    // constraint edit without a constraint removes the bones' constraints.
+
+    struct length_edit {
+        double length;
+    };
+
+    struct rotation_edit {
+        double world_rotation;
+    };
+
+    struct constraint_edit {
+        std::optional<sm::rot_constraint> constraint;
+    };
+
+    using bone_edit = std::variant<length_edit, rotation_edit, constraint_edit>;
+
     class project : public QObject {
 
         friend class commands;
 
         Q_OBJECT
 
-        std::unordered_map<std::string, std::vector<std::string>> tabs_;
-        sm::world world_;
+        using tab_table = std::unordered_map<std::string, std::vector<std::string>>;
 
-        std::stack<command> redo_stack_;
-        std::stack<command> undo_stack_;
+        // where a skeleton's name is stored in tabs_, so that finding a skeleton's tab and
+        // removing a skeleton from its tab are constant time.
 
+        struct tab_location {
+            std::string tab;
+            size_t index;
+        };
+
+        tab_table tabs_;
+        std::unordered_map<std::string, tab_location> skeleton_to_tab_;
+        std::unordered_map<std::string, dirty_set> dirty_;
+        sm::world world_;
+
+        // each command in the history is stored with its footprint as of when it last ran,
+        // so the running total can be kept as commands move between the stacks.
+        struct history_entry {
+            command cmd;
+            size_t memory_usage;
+        };
+
+        std::deque<history_entry> redo_stack_;
+        std::deque<history_entry> undo_stack_;
+        size_t undo_memory_usage_;
+        size_t undo_memory_budget_;
+        uint64_t revision_;
+        journal::writer* journal_;
+
+        void set_tabs(const tab_table& tabs);
+        void add_tab_aux(const std::string& tab);
+        void delete_tab_aux(const std::string& tab);
+        void add_skeleton_name_to_canvas_table(const std::string& tab, const std::string& skel);
         void delete_skeleton_name_from_canvas_table(const std::string& tab, const std::string& skel);
+        void rename_skeleton_in_canvas_table(const std::string& old_name, const std::string& new_name);
+        void mark_dirty(const std::string& tab, 
+            const std::vector<handle>& nodes, const std::vector<handle>& bones);
+        void push_history(std::deque<history_entry>& stack, const command& cmd);
+        command pop_history(std::deque<history_entry>& stack);
+        void clear_history();
         void clear_redo_stack();
         void execute_command(const command& cmd);
+        void enforce_undo_memory_budget();
         void rename_aux(skel_piece piece, const std::string& new_name);
         bool can_rename(skel_piece piece, const std::string& new_name);
-        void replace_skeletons_aux(const std::string& canvas_name,
-            const std::vector<std::string>& replacees,
-            const std::vector<sm::skel_ref>& replacements,
-            std::vector<std::string>* new_names_of_replacements);
+        std::vector<sm::piece_removal> remove_skeletons_aux(const std::string& canvas_name,
+            const std::vector<std::string>& skel_names);
+        void add_skeletons_aux(const std::string& canvas_name,
+            const std::vector<sm::skeleton_snapshot>& snapshots,
+            std::vector<std::string>& new_names);
+        std::vector<sm::skeleton_snapshot> snapshots_of(
+            const std::vector<std::string>& skel_names) const;
+        sm::piece_removal remove_pieces_aux(const std::string& canvas_name, sm::skeleton& skel,
+            const std::vector<sm::node_ref>& nodes, const std::vector<sm::bone_ref>& bones,
+            const sm::piece_removal* previous);
+        void restore_pieces_aux(const std::string& canvas_name, const sm::piece_removal& removal);
         void clear();
+        void log(const journal::record& rec);
+        void apply(const journal::record& rec);
 
     public:
         project();
@@ -52,6 +152,9 @@ namespace mdl {
         const sm::world& world() const;        
         bool can_undo() const;
         bool can_redo() const;
+        size_t undo_memory_usage() const;
+        size_t undo_memory_budget() const;
+        void set_undo_memory_budget(size_t bytes);
         auto tabs() const {
             namespace rv = std::ranges::views;
             return tabs_ | rv::transform([](auto&& p) {return p.first; });
@@ -69,11 +172,14 @@ namespace mdl {
         }
         bool has_tab(const std::string& str) const;
         std::string to_json() const;
+        uint64_t revision() const;
+        project_snapshot snapshot() const;
         std::string canvas_name_from_skeleton(const std::string& skel) const;
 
         void undo();
         void redo();
         sm::world& world();
+        std::tuple<std::vector<sm::node*>, std::vector<sm::bone*>> take_dirty(const std::string& tab);
         bool add_new_tab(const std::string& name);
         auto skeletons_on_tab(std::string_view name) {
             namespace rv = std::ranges::views;
@@ -86,6 +192,8 @@ namespace mdl {
                 );
         }
         bool from_json(const std::string& str);
+        bool recover(const std::string& snapshot_json, const std::vector<journal::entry>& entries);
+        void set_journal(journal::writer* journal);
         void add_bone(const std::string& tab, 
             const handle& node_u, const handle& node_v);
         void add_new_skeleton_root(const std::string& tab, sm::point loc);
@@ -94,10 +202,17 @@ namespace mdl {
             const std::vector<std::string>& replacees,
             const std::vector<sm::skel_ref>& replacements
         );
+        void replace_skeletons(const std::string& canvas_name,
+            const std::vector<std::string>& replacees,
+            const std::vector<sm::skeleton_snapshot>& replacements
+        );
+        void remove_pieces(const std::string& canvas_name,
+            const std::vector<handle>& nodes, const std::vector<handle>& bones);
         void transform(const std::vector<handle>& nodes, 
             const std::function<void(sm::node&)>& fn);
         void transform(const std::vector<handle>& nodes,
             const std::function<void(sm::bone&)>& fn);
+        void edit_bones(const std::vector<handle>& bones, const bone_edit& edit);
 
         using node_locs = std::vector<std::tuple<handle, sm::point>>;
         void transform_node_positions(
@@ -111,6 +226,7 @@ namespace mdl {
         void new_project_opened(project& model);
         void new_skeleton_added(const std::string& canvas_name, sm::skel_ref skel);
         void refresh_canvas(project& model, const std::string& canvas, bool clear);
+        void skeletons_changed(const std::string& canvas, const skeleton_changes& changes);
         void name_changed(skel_piece piece, const std::string& new_name);
         void refresh_undo_redo_state(bool, bool);
     };
@@ -22,45 +22,97 @@ namespace {
         return { pts };
     }
 
-    void set_bone_item_pos( ui::canvas::item::bone* itm, double len, const
-            sm::point& pos, double rot, double scale) {
-        itm->setPos(0, 0);
-        itm->setRotation(0);
-        itm->setPolygon(bone_polygon(len, ui::canvas::k_node_radius, scale));
-        itm->setRotation(ui::radians_to_degrees(rot));
-        itm->setPos(ui::to_qt_pt(pos));
+    QPen cosmetic_pen(const QColor& color, double width, Qt::PenStyle style = Qt::SolidLine) {
+        QPen pen(color, width, style);
+        pen.setCosmetic(true);
+        return pen;
     }
 
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
-ui::canvas::item::bone::bone(sm::bone& bone, double scale) :
-        treeview_item_(nullptr),
+ui::canvas::item::bone::bone(sm::bone& bone) :
         has_stick_man_model<ui::canvas::item::bone, sm::bone&>(bone),
-    rot_constraint_(nullptr) {
+    rot_constraint_(nullptr),
+    length_(0.0),
+    body_polygon_scale_(0.0) {
     setBrush(Qt::black);
-    setPen(QPen(Qt::black, 1.0 / scale));
-    set_bone_item_pos(
-        this,
-        bone.scaled_length(),
-        bone.parent_node().world_pos(),
-        bone.world_rotation(),
-        1.0 / scale
-    );
+    setPen(cosmetic_pen(Qt::black, 1.0));
+    sync_geometry();
     setZValue(k_bone_zorder);
 }
 
+// a bone's polygon meets its nodes' circles tangentially and node circles are a constant
+// size on screen, so the polygon depends on the zoom level. It is rebuilt lazily when it
+// is next painted or hit tested at a different scale rather than whenever the view zooms.
+
+QPolygonF ui::canvas::item::bone::body_polygon() const {
+    auto* canv = canvas();
+    auto scale = canv ? canv->scale() : 1.0;
+    if (scale != body_polygon_scale_) {
+        body_polygon_ = bone_polygon(length_, k_node_radius, 1.0 / scale);
+        body_polygon_scale_ = scale;
+    }
+    return body_polygon_;
+}
+
+// however wide a bone's polygon is at a given scale, its half width is never more than half
+// its length, so this bound holds at every zoom level.
+
+QRectF ui::canvas::item::bone::boundingRect() const {
+    return { 0.0, -length_ / 2.0, length_, length_ };
+}
+
+QPainterPath ui::canvas::item::bone::shape() const {
+    QPainterPath path;
+    path.addPolygon(body_polygon());
+    path.closeSubpath();
+    return path;
+}
+
+void ui::canvas::item::bone::paint(QPainter* painter,
+        const QStyleOptionGraphicsItem* option, QWidget* widget) {
+    painter->setPen(pen());
+    painter->setBrush(brush());
+    painter->drawPolygon(body_polygon());
+}
+
+void ui::canvas::item::bone::sync_geometry() {
+    prepareGeometryChange();
+    length_ = model_->scaled_length();
+    body_polygon_scale_ = 0.0;
+    setRotation(ui::radians_to_degrees(model_->world_rotation()));
+    setPos(ui::to_qt_pt(model_->parent_node().world_pos()));
+}
+
+void ui::canvas::item::bone::show_between(const sm::point& u, const sm::point& v) {
+    prepareGeometryChange();
+    length_ = sm::distance(u, v);
+    body_polygon_scale_ = 0.0;
+    setRotation(ui::radians_to_degrees(sm::angle_from_u_to_v(u, v)));
+    setPos(ui::to_qt_pt(u));
+    if (selection_frame_) {
+        sync_sel_frame_to_model();
+    }
+}
+
+void ui::canvas::item::bone::rebind(sm::bone& bone) {
+    set_model(bone);
+}
+
+void ui::canvas::item::bone::hide_rotation_constraint() {
+    if (rot_constraint_) {
+        rot_constraint_->hide();
+    }
+}
+
 ui::canvas::item::node& ui::canvas::item::bone::parent_node_item() const {
-    return std::any_cast<sm::ref<ui::canvas::item::node>>(
-        model_.parent_node().get_user_data()
-    );
+    return *canvas()->item_of(model_->parent_node());
 }
 
 ui::canvas::item::node& ui::canvas::item::bone::child_node_item() const {
-    return std::any_cast<sm::ref<ui::canvas::item::node>>(
-        model_.child_node().get_user_data()
-    );
+    return *canvas()->item_of(model_->child_node());
 }
 
 void ui::canvas::item::bone::sync_rotation_constraint_to_model() {
@@ -75,7 +127,7 @@ void ui::canvas::item::bone::sync_rotation_constraint_to_model() {
     if (!rot_constraint_) {
         canvas()->addItem(rot_constraint_ = new rot_constraint_adornment());
     }
-    rot_constraint_->set(model(), *constraint, canvas()->scale());
+    rot_constraint_->set(model(), *constraint);
     if (is_selected()) {
         rot_constraint_->show();
     }
@@ -90,31 +142,19 @@ mdl::const_skel_piece ui::canvas::item::bone::to_skeleton_piece() const {
 }
 
 void ui::canvas::item::bone::sync_item_to_model() {
-    auto& canv = *canvas();
-    setPen(QPen(Qt::black, 1.0 / canv.scale()));
-    set_bone_item_pos(
-        this,
-        model_.scaled_length(),
-        model_.parent_node().world_pos(),
-        model_.world_rotation(),
-        1.0 / canv.scale()
-    );
+    sync_geometry();
     sync_rotation_constraint_to_model();
 }
 
 void ui::canvas::item::bone::sync_sel_frame_to_model() {
     auto* sf = static_cast<QGraphicsLineItem*>(selection_frame_);
-    auto inv_scale = 1.0 / canvas()->scale();
-    sf->setLine(0, 0, model_.scaled_length(), 0);
-    sf->setPen(QPen(k_sel_color, k_sel_thickness * inv_scale, Qt::DotLine));
+    sf->setLine(0, 0, length_, 0);
 }
 
 QGraphicsItem* ui::canvas::item::bone::create_selection_frame() const {
-    auto& canv = *canvas();
-    auto inv_scale = 1.0 / canvas()->scale();
     auto sf = new QGraphicsLineItem();
-    sf->setLine(0, 0, model_.length(), 0);
-    sf->setPen(QPen(k_sel_color, k_sel_thickness * inv_scale, Qt::DotLine));
+    sf->setLine(0, 0, length_, 0);
+    sf->setPen(cosmetic_pen(k_sel_color, k_sel_thickness, Qt::DotLine));
     return sf;
 }
 
@@ -129,16 +169,20 @@ QGraphicsItem* ui::canvas::item::bone::item_body() {
 /*------------------------------------------------------------------------------------------------*/
 
 
+// the adornment ignores the view's transformation so its radius is constant on screen.
+// That also drops the view's vertical flip, hence the arc's angles are negated relative to
+// an arc drawn in scene coordinates.
+
 ui::canvas::item::rot_constraint_adornment::rot_constraint_adornment() {
+    setFlag(QGraphicsItem::ItemIgnoresTransformations);
     setBrush(QBrush(k_sel_color));
     setPen(Qt::NoPen);
 }
 
 void ui::canvas::item::rot_constraint_adornment::set(const sm::bone& bone,
-    const sm::rot_constraint& constraint, double scale) {
+        const sm::rot_constraint& constraint) {
     QPointF pivot = {};
     double start_angle = 0;
-    double radius = k_joint_constraint_radius * (1.0 / scale);
 
     if (constraint.relative_to_parent) {
         auto& anchor_bone = bone.parent_bone()->get();
@@ -152,6 +196,7 @@ void ui::canvas::item::rot_constraint_adornment::set(const sm::bone& bone,
         start_angle = constraint.start_angle;
         pivot = ui::to_qt_pt(center_pt);
     }
-    ui::set_arc(this, pivot, radius, start_angle, constraint.span_angle);
+    setPos(pivot);
+    ui::set_arc(this, {}, k_joint_constraint_radius, -start_angle, -constraint.span_angle);
     show();
 }
\ No newline at end of file
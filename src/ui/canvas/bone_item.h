@@ -11,13 +11,15 @@ namespace ui {
             class rot_constraint_adornment;
 
             class bone :
-                public has_treeview_item,
                 public has_stick_man_model<bone, sm::bone&>,
                 public QGraphicsPolygonItem {
             private:
                 rot_constraint_adornment* rot_constraint_;
-                QStandardItem* treeview_item_;
+                double length_;
+                mutable QPolygonF body_polygon_;
+                mutable double body_polygon_scale_;
 
+                void sync_geometry();
                 void sync_item_to_model() override;
                 void sync_sel_frame_to_model() override;
                 QGraphicsItem* create_selection_frame() const override;
@@ -29,9 +31,21 @@ namespace ui {
             public:
                 using model_type = sm::bone;
 
-                bone(sm::bone& bone, double scale);
+                bone(sm::bone& bone);
+                void rebind(sm::bone& bone);
+                void hide_rotation_constraint();
                 item::node& parent_node_item() const;
                 item::node& child_node_item() const;
+                QPolygonF body_polygon() const;
+
+                // lays the item out between the given points without touching its model,
+                // e.g. to show an animated pose.
+                void show_between(const sm::point& u, const sm::point& v);
+
+                QRectF boundingRect() const override;
+                QPainterPath shape() const override;
+                void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+                    QWidget* widget) override;
             };
 
             Q_DECLARE_METATYPE(bone*);
@@ -43,8 +57,7 @@ namespace ui {
                 rot_constraint_adornment();
                 void set(
                     const sm::bone& node,
-                    const sm::rot_constraint& constraint,
-                    double scale
+                    const sm::rot_constraint& constraint
                 );
             };
         }
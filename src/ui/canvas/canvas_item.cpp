@@ -8,7 +8,7 @@ namespace rv = std::ranges::views;
 
 /*------------------------------------------------------------------------------------------------*/
 
-ui::canvas::item::base::base() : selection_frame_(nullptr)
+ui::canvas::item::base::base() : selection_frame_(nullptr), is_selected_(false), canvas_id_(0)
 {}
 
 void ui::canvas::item::base::sync_to_model() {
@@ -26,16 +26,32 @@ ui::canvas::scene* ui::canvas::item::base::canvas() const {
 }
 
 bool ui::canvas::item::base::is_selected() const {
-	if (!is_selection_frame_only()) {
-		return selection_frame_ && selection_frame_->isVisible();
-	} else {
-		return item_body()->isVisible();
-	}
+	return is_selected_;
+}
+
+// the dense id the item's canvas registered it under; ids of removed items are reused.
+
+uint32_t ui::canvas::item::base::canvas_id() const {
+	return canvas_id_;
 }
 
+// when the canvas is rendering batched, nodes and bones are drawn by their skeleton's item
+// so their selection frames are too; selecting one only needs to repaint that spot.
+
 void ui::canvas::item::base::set_selected(bool selected) {
+	is_selected_ = selected;
+	auto* canv = canvas();
+	bool is_batched = canv && canv->is_batched();
 	if (!is_selection_frame_only()) {
-		if (selected) {
+		if (is_batched) {
+			if (selection_frame_) {
+				selection_frame_->hide();
+			}
+			auto margin = (k_sel_frame_distance + k_sel_thickness) / canv->scale();
+			canv->update(
+				canv->scene_bounding_rect(item_body()).adjusted(-margin, -margin, margin, margin)
+			);
+		} else if (selected) {
 			if (!selection_frame_) {
 				selection_frame_ = create_selection_frame();
 				selection_frame_->setParentItem(dynamic_cast<QGraphicsItem*>(this));
@@ -49,7 +65,8 @@ void ui::canvas::item::base::set_selected(bool selected) {
 		}
 	} else {
 		sync_to_model();
-		item_body()->setVisible(selected);
+		item_body()->setVisible(selected || is_batched);
+		item_body()->update();
 	}
 }
 
@@ -76,19 +93,3 @@ const QGraphicsItem* ui::canvas::item::base::item_body() const {
 QGraphicsItem* ui::canvas::item::base::selection_frame() {
 	return selection_frame_;
 }
-
-/*------------------------------------------------------------------------------------------------*/
-
-ui::canvas::item::has_treeview_item::has_treeview_item() :
-	tree_view_item_(nullptr) {
-}
-
-void ui::canvas::item::has_treeview_item::set_treeview_item(QStandardItem* itm) {
-	tree_view_item_ = itm;
-}
-
-QStandardItem* ui::canvas::item::has_treeview_item::treeview_item() const {
-	return tree_view_item_;
-}
-
-
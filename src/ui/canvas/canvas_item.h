@@ -7,7 +7,9 @@
 #include <any>
 #include <ranges>
 #include <variant>
+#include <type_traits>
 #include "../../core/sm_types.h"
+#include "../../core/sm_slots.h"
 #include "../../model/project.h"
 
 /*------------------------------------------------------------------------------------------------*/
@@ -24,6 +26,8 @@ namespace ui {
                 friend class scene;
             protected:
                 QGraphicsItem* selection_frame_;
+                bool is_selected_;
+                uint32_t canvas_id_;
 
                 virtual QGraphicsItem* create_selection_frame() const = 0;
                 virtual void sync_item_to_model() = 0;
@@ -37,6 +41,7 @@ namespace ui {
                 void sync_to_model();
                 scene* canvas() const;
                 bool is_selected() const;
+                uint32_t canvas_id() const;
                 void set_selected(bool selected);
                 mdl::skel_piece to_skeleton_piece();
                 virtual mdl::const_skel_piece to_skeleton_piece() const = 0;
@@ -46,38 +51,26 @@ namespace ui {
             template<typename T, typename U>
             class has_stick_man_model : public base {
             protected:
-                U& model_;
+                std::remove_reference_t<U>* model_;
+                sm::piece_id model_id_;
+
+                // canvas items are pooled and rebound to other model pieces when the
+                // pieces they were showing are deleted. The id is kept so that the item
+                // can be unregistered from its canvas after its piece is gone.
+                void set_model(U& model) {
+                    model_ = &model;
+                    model_id_ = model.id();
+                }
             public:
-                has_stick_man_model(U& model) : model_(model) {
-                    auto* derived = static_cast<T*>(this);
-                    model.set_user_data(sm::ref(*derived));
+                has_stick_man_model(U& model) : model_(nullptr) {
+                    set_model(model);
                 }
-                U& model() { return model_; }
-                const U& model() const { return model_; }
+                U& model() { return *model_; }
+                const U& model() const { return *model_; }
+                sm::piece_id model_id() const { return model_id_; }
                 virtual ~has_stick_man_model() {
-                    //model_.set_user_data(std::any{});
                 }
             };
-
-            class has_treeview_item {
-                QStandardItem* tree_view_item_;
-            public:
-                has_treeview_item();
-                void set_treeview_item(QStandardItem* itm);
-                QStandardItem* treeview_item() const;
-            };
-        }
-
-        // T is a graphics item type (node_item, bone_item, or skeleton_item) and 
-        // is provided explicitely by the caller
-        // U is a model type (node, bone, or skeleton) and is deduced.
-        template<typename T, typename U>
-        T& item_from_model(U& model_obj) {
-            return std::any_cast<sm::ref<T>>(model_obj.get_user_data());
-        }
-
-        bool has_canvas_item(const auto& model_obj) {
-            return model_obj.get_user_data().has_value();
         }
 
         // items are a view of canvas_item pointers of some type.
@@ -104,5 +97,6 @@ namespace ui {
         constexpr auto k_sel_color = QColorConstants::Svg::turquoise;
         constexpr auto k_sel_thickness = 3.0;
         constexpr auto k_node_radius = 8.0;
+        constexpr auto k_pin_radius = k_node_radius - 3.0;
     }
 }
\ No newline at end of file
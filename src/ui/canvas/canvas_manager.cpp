@@ -45,6 +45,7 @@ void ui::canvas::manager::disconnect_current_tab_signal() {
 
 ui::canvas::manager::manager(tool::input_handler& inp_handler) :
     drag_mode_(drag_mode::none),
+    render_mode_(render_mode::items),
     inp_handler_(inp_handler),
     active_canv_(nullptr) {
     setStyleSheet(
@@ -62,13 +63,15 @@ void ui::canvas::manager::init(mdl::project& proj) {
     connect(&proj, &mdl::project::new_bone_added, this, &manager::add_new_bone);
     connect(&proj, &mdl::project::new_skeleton_added, this, &manager::add_new_skeleton);
     connect(&proj, &mdl::project::new_project_opened, this, &manager::set_contents);
+    connect(&proj, &mdl::project::skeletons_changed, this, &manager::add_skeleton_changes);
     connect(&proj, &mdl::project::refresh_canvas,
         [this](mdl::project& model, const std::string& canvas, bool clear) {
             if (clear) {
                 set_contents_of_canvas(model, canvas);
             }
             else {
-                canvas_from_name(canvas)->sync_to_model();
+                auto [nodes, bones] = model.take_dirty(canvas);
+                canvas_from_name(canvas)->sync_to_model(nodes, bones);
             }
         }
     );
@@ -87,7 +90,7 @@ void ui::canvas::manager::add_tab(const std::string& name) {
     QGraphicsView* view = new QGraphicsView();
 
     view->setRenderHint(QPainter::Antialiasing, true);
-    view->setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    view->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
     view->scale(1, -1);
 
     addTab(view, name.c_str());
@@ -95,6 +98,8 @@ void ui::canvas::manager::add_tab(const std::string& name) {
     view->setScene(canv);
     canv->init();
     canv->set_drag_mode(drag_mode_);
+    canv->set_render_mode(render_mode_);
+    canv->set_lod_thresholds(lod_thresholds_);
 
     if (active_canv_ == nullptr) {
         active_canv_ = canv;
@@ -189,6 +194,7 @@ std::string ui::canvas::manager::tab_name(const scene& canv) const {
 void ui::canvas::manager::set_contents(mdl::project& model) {
 
     // clear the old tabs and create new ones based on what is in the project
+    skeleton_changes_.clear();
     disconnect_current_tab_signal();
     clear();
     for (auto tab_name : model.tabs()) {
@@ -205,18 +211,55 @@ void ui::canvas::manager::set_contents(mdl::project& model) {
     emit canvas_refresh(model.world());
 }
 
+// a command that restructures skeletons says which ones just before it refreshes their
+// canvas, so only the items of those skeletons are resynced. A refresh with no changes
+// recorded resyncs everything.
+
+void ui::canvas::manager::add_skeleton_changes(const std::string& canvas,
+        const mdl::skeleton_changes& changes) {
+    auto& pending = skeleton_changes_[canvas];
+    pending.changed.insert(pending.changed.end(), changes.changed.begin(), changes.changed.end());
+    pending.added.insert(pending.added.end(), changes.added.begin(), changes.added.end());
+}
+
 void ui::canvas::manager::set_contents_of_canvas(mdl::project& model, const std::string& canvas) {
     auto* canv = canvas_from_name(canvas);
     if (!canv) {
         return;
     }
 
+    std::optional<std::unordered_set<const sm::skeleton*>> stale;
+    if (auto changes = skeleton_changes_.extract(canvas); changes) {
+        stale.emplace();
+        auto add_stale = [&](const std::vector<sm::piece_id>& ids) {
+            for (auto id : ids) {
+                if (auto* skel = model.world().from_id<sm::skeleton>(id); skel) {
+                    stale->insert(skel);
+                }
+            }
+        };
+        add_stale(changes.mapped().changed);
+        add_stale(changes.mapped().added);
+    }
+
     auto new_contents = model.skeletons_on_tab(canvas) | r::to<std::vector<sm::skel_ref>>();
-    canv->set_contents(new_contents);
+    canv->set_contents(new_contents, stale ? &*stale : nullptr);
 
     emit canvas_refresh(model.world());
 }
 
+// returns the canvas that has an item for the given skeleton, if any. There are only ever a
+// handful of tabs so asking each of them is cheap.
+
+ui::canvas::scene* ui::canvas::manager::canvas_of(const sm::skeleton& skel) {
+    for (auto* canv : canvases()) {
+        if (canv->item_of(skel)) {
+            return canv;
+        }
+    }
+    return nullptr;
+}
+
 void ui::canvas::manager::clear_canvas(const std::string& canv)
 {
     canvas_from_name(canv)->clear();
@@ -229,6 +272,20 @@ void ui::canvas::manager::set_drag_mode(drag_mode dm) {
     }
 }
 
+void ui::canvas::manager::set_render_mode(render_mode rm) {
+    render_mode_ = rm;
+    for (auto* canv : canvases()) {
+        canv->set_render_mode(rm);
+    }
+}
+
+void ui::canvas::manager::set_lod_thresholds(const lod_thresholds& thresholds) {
+    lod_thresholds_ = thresholds;
+    for (auto* canv : canvases()) {
+        canv->set_lod_thresholds(thresholds);
+    }
+}
+
 void ui::canvas::manager::set_active_canvas(const scene& c) {
     auto canvases = this->canvases();
     for (auto [index, canv_ptr] : rv::enumerate(canvases)) {
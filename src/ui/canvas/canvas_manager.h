@@ -3,6 +3,8 @@
 #include <QWidget>
 #include <QtWidgets>
 #include "scene.h"
+#include <unordered_map>
+#include <string>
 
 namespace ui {
 
@@ -22,6 +24,9 @@ namespace ui {
             QMetaObject::Connection current_tab_conn_;
             tool::input_handler& inp_handler_;
             drag_mode drag_mode_;
+            render_mode render_mode_;
+            lod_thresholds lod_thresholds_;
+            std::unordered_map<std::string, mdl::skeleton_changes> skeleton_changes_;
 
             void connect_current_tab_signal();
             void disconnect_current_tab_signal();
@@ -32,6 +37,8 @@ namespace ui {
             void add_new_skeleton(const std::string& canvas, sm::skel_ref skel);
             void set_contents(mdl::project& model);
             void set_contents_of_canvas(mdl::project& model, const std::string& canvas);
+            void add_skeleton_changes(const std::string& canvas,
+                const mdl::skeleton_changes& changes);
             void clear_canvas(const std::string& canv);
 
         public:
@@ -41,7 +48,10 @@ namespace ui {
             void center_active_view();
             scene& active_canvas() const;
             scene* canvas_from_name(const std::string& canv_name);
+            scene* canvas_of(const sm::skeleton& skel);
             void set_drag_mode(drag_mode dm);
+            void set_render_mode(render_mode rm);
+            void set_lod_thresholds(const lod_thresholds& thresholds);
             void set_active_canvas(const scene& c);
             std::vector<std::string> tab_names() const;
             std::string tab_name(const scene& canv) const;
@@ -61,8 +71,10 @@ namespace ui {
 
         signals:
             void active_canvas_changed(ui::canvas::scene& old_canv, ui::canvas::scene& canv);
-            void selection_changed(ui::canvas::scene& canv);
+            void selection_changed(ui::canvas::scene& canv, const ui::canvas::selection_delta& delta);
             void canvas_refresh(sm::world& proj);
+            void playback_progress(ui::canvas::scene& canv, uint64_t ticks, uint64_t dropped,
+                uint64_t late);
         };
     }
 }
\ No newline at end of file
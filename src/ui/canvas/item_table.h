@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../../core/sm_slots.h"
+#include <vector>
+#include <cstdint>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace ui {
+
+    namespace canvas {
+
+        // maps the dense ids of a world's pieces to the canvas items showing them. Entries
+        // remember the generation of the id they were added under so a stale id, or the id
+        // of a piece on another canvas, finds nothing.
+
+        template<typename T>
+        class item_table {
+
+            struct entry {
+                uint32_t generation;
+                T* item;
+            };
+
+            std::vector<entry> entries_;
+
+        public:
+
+            void insert(sm::piece_id id, T* item) {
+                if (id.index >= entries_.size()) {
+                    entries_.resize(id.index + 1, entry{ 0, nullptr });
+                }
+                entries_[id.index] = { id.generation, item };
+            }
+
+            // only erases the entry if it still belongs to the given item; the piece's id
+            // may have been reclaimed by another piece and item since.
+
+            void erase(sm::piece_id id, const T* item) {
+                if (id.index < entries_.size() && entries_[id.index].item == item) {
+                    entries_[id.index] = { 0, nullptr };
+                }
+            }
+
+            T* get(sm::piece_id id) const {
+                if (id.index >= entries_.size()) {
+                    return nullptr;
+                }
+                const auto& e = entries_[id.index];
+                return (e.generation == id.generation) ? e.item : nullptr;
+            }
+
+            void clear() {
+                entries_.clear();
+            }
+        };
+    }
+}
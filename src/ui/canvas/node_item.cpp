@@ -12,11 +12,9 @@ namespace rv = std::ranges::views;
 namespace {
 
     constexpr auto k_node_zorder = 10;
-    constexpr auto k_pin_radius = ui::canvas::k_node_radius - 3.0;
 
-    void set_circle(QGraphicsEllipseItem* ei, QPointF pos, double radius, double scale) {
+    void set_circle(QGraphicsEllipseItem* ei, QPointF pos, double r) {
         ei->setPos(0, 0);
-        double r = radius * scale;
         ei->setRect(
             QRectF(
                 -r, -r, 2.0 * r, 2.0 * r
@@ -29,31 +27,42 @@ namespace {
 
 /*------------------------------------------------------------------------------------------------*/
 
-ui::canvas::item::node::node(sm::node& node, double scale) :
+// node items ignore the view's transformation so a node, its pin, and its selection frame
+// are a constant size on screen and zooming does not need to touch them. Their position is
+// still in scene coordinates.
+
+ui::canvas::item::node::node(sm::node& node) :
     has_stick_man_model<ui::canvas::item::node, sm::node&>(node),
     is_pinned_(false),
     pin_(nullptr) {
-    auto inv_scale = 1.0 / scale;
+    setFlag(QGraphicsItem::ItemIgnoresTransformations);
     setBrush(Qt::white);
-    setPen(QPen(Qt::black, 2.0 * inv_scale));
-    set_circle(this, to_qt_pt(model_.world_pos()), k_node_radius, inv_scale);
+    setPen(QPen(Qt::black, 2.0));
+    set_circle(this, to_qt_pt(model_->world_pos()), k_node_radius);
     setZValue(k_node_zorder);
 }
 
 void ui::canvas::item::node::set_pinned(bool pinned) {
     if (!pin_) {
         pin_ = new QGraphicsEllipseItem();
-        set_circle(pin_, { 0,0 }, k_pin_radius, 1.0 / canvas()->scale());
+        set_circle(pin_, { 0,0 }, k_pin_radius);
         pin_->setPen(Qt::NoPen);
         pin_->setBrush(Qt::black);
         pin_->setParentItem(this);
     }
-    if (pinned) {
-        pin_->show();
-    } else {
+    is_pinned_ = pinned;
+    pin_->setVisible(pinned && !canvas()->is_batched());
+    if (canvas()->is_batched()) {
+        canvas()->update(canvas()->scene_bounding_rect(this));
+    }
+}
+
+void ui::canvas::item::node::rebind(sm::node& node) {
+    set_model(node);
+    is_pinned_ = false;
+    if (pin_) {
         pin_->hide();
     }
-    is_pinned_ = pinned;
 }
 
 bool ui::canvas::item::node::is_pinned() const {
@@ -61,28 +70,23 @@ bool ui::canvas::item::node::is_pinned() const {
 }
 
 void ui::canvas::item::node::sync_item_to_model() {
-    auto& canv = *canvas();
-    double inv_scale = 1.0 / canv.scale();
-    setPen(QPen(Qt::black, 2.0 * inv_scale));
-    set_circle(this, to_qt_pt(model_.world_pos()), k_node_radius, inv_scale);
+    setPos(to_qt_pt(model_->world_pos()));
     if (pin_) {
-        set_circle(pin_, { 0,0 }, k_pin_radius, inv_scale);
+        pin_->setVisible(is_pinned_ && !canvas()->is_batched());
     }
 }
 
+void ui::canvas::item::node::show_at(const sm::point& pt) {
+    setPos(to_qt_pt(pt));
+}
+
 void ui::canvas::item::node::sync_sel_frame_to_model() {
-    auto* sf = static_cast<QGraphicsEllipseItem*>(selection_frame_);
-    auto inv_scale = 1.0 / canvas()->scale();
-    set_circle(sf, { 0,0 }, k_node_radius + k_sel_frame_distance, inv_scale);
-    sf->setPen(QPen(k_sel_color, k_sel_thickness * inv_scale, Qt::DotLine));
 }
 
 QGraphicsItem* ui::canvas::item::node::create_selection_frame() const {
-    auto& canv = *canvas();
-    auto inv_scale = 1.0 / canvas()->scale();
     auto sf = new QGraphicsEllipseItem();
-    set_circle(sf, { 0.0,0.0 }, k_node_radius + k_sel_frame_distance, inv_scale);
-    sf->setPen(QPen(k_sel_color, k_sel_thickness * inv_scale, Qt::DotLine));
+    set_circle(sf, { 0.0,0.0 }, k_node_radius + k_sel_frame_distance);
+    sf->setPen(QPen(k_sel_color, k_sel_thickness, Qt::DotLine));
     sf->setBrush(Qt::NoBrush);
     return sf;
 }
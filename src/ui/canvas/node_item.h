@@ -21,9 +21,13 @@ namespace ui {
             public:
                 using model_type = sm::node;
 
-                node(sm::node& node, double scale);
+                node(sm::node& node);
+                void rebind(sm::node& node);
                 void set_pinned(bool pinned);
                 bool is_pinned() const;
+
+                // moves the item without touching its model, e.g. to show an animated pose.
+                void show_at(const sm::point& pt);
             };
         }
     }
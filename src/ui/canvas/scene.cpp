@@ -26,6 +26,12 @@ namespace {
     const auto k_light_gridline_color = QColor::fromRgb(240, 240, 240);
     constexpr int k_ribbon_height = 35;
     constexpr double k_zoom_base = 1.5;
+    const auto k_background_color = QColor::fromRgb(53, 53, 53);
+
+    // grid tiles are this many pixels on a side whatever the zoom level, and the tile
+    // cache is bounded by total pixel count.
+    constexpr int k_grid_tile_pixels = 256;
+    constexpr int k_grid_tile_cache_pixels = 256 * k_grid_tile_pixels * k_grid_tile_pixels;
 
     QGraphicsView::DragMode to_qt_drag_mode(ui::canvas::drag_mode dm) {
         switch (dm) {
@@ -44,20 +50,6 @@ namespace {
         return ui::to_vector_of_type<ui::canvas::item::base*>(collection);
     }
 
-    template<typename T>
-    T* top_item_of_type(const QGraphicsScene& scene, QPointF pt) {
-        auto itms = scene.items(pt);
-        auto itms_at_pt = itms |
-            rv::transform(
-                [](auto itm)->T* {return dynamic_cast<T*>(itm); }
-        );
-        auto first = r::find_if(itms_at_pt, [](auto ptr)->bool { return ptr; });
-        if (first == itms_at_pt.end()) {
-            return nullptr;
-        }
-        return *first;
-    }
-
     void draw_ribbon(QPainter* painter, QRect rr, QString txt) {
         QRect ribbon_rect = rr;
 
@@ -112,14 +104,12 @@ namespace {
 		painter->drawLine(x1, 0, x2, 0);
     }
 
-    auto child_bones(ui::canvas::item::node* node) {
+    auto child_bones(const ui::canvas::scene& canv, ui::canvas::item::node* node) {
         auto bones = node->model().child_bones();
         return bones |
             rv::transform(
-                [](sm::const_bone_ref bone)->ui::canvas::item::bone& {
-                    return std::any_cast<sm::ref<ui::canvas::item::bone>>(
-                        bone->get_user_data()
-                    );
+                [&canv](sm::const_bone_ref bone)->ui::canvas::item::bone& {
+                    return *canv.item_of(bone.get());
                 }
         );
     }
@@ -136,6 +126,13 @@ namespace {
 		return (adj_dup != nodes.end()) ? *adj_dup : nullptr;
 	}  
 
+    constexpr size_t k_max_pooled_items = 4096;
+
+    template<typename T>
+    std::unordered_set<T*> to_set(const std::vector<T*>& items) {
+        return { items.begin(), items.end() };
+    }
+
 	sm::bone* parent_bone(sm::bone* bone_1, sm::bone* bone_2) {
 		return (&(bone_1->parent_node()) == find_shared_node(bone_1, bone_2)) ? bone_2 : bone_1;
 	}
@@ -143,20 +140,87 @@ namespace {
 /*------------------------------------------------------------------------------------------------*/
 
 ui::canvas::scene::scene(tool::input_handler& inp_handler) :
-        inp_handler_(inp_handler), rubber_band_(nullptr) {
+        selection_(items_by_id_), synced_selection_(items_by_id_),
+        inp_handler_(inp_handler), rubber_band_(nullptr), render_mode_(render_mode::items),
+        grid_tiles_(k_grid_tile_cache_pixels), playback_world_(nullptr) {
     setSceneRect(QRectF(-1500, -1500, 3000, 3000));
+    playback_timer_.setTimerType(Qt::PreciseTimer);
+    connect(&playback_timer_, &QTimer::timeout, this, &scene::show_latest_pose);
+}
+
+ui::canvas::scene::~scene() {
 }
 
+// with partial viewport updates scrolling moves the viewport's pixels, which would drag
+// the status ribbon along with the contents, so while it is visible scrolling repaints
+// the whole viewport.
+
 void ui::canvas::scene::init() {
+    auto repaint_ribbon = [this]() {
+        if (is_status_line_visible()) {
+            view().viewport()->update();
+        }
+    };
+    connect(view().horizontalScrollBar(), &QScrollBar::valueChanged, this, repaint_ribbon);
+    connect(view().verticalScrollBar(), &QScrollBar::valueChanged, this, repaint_ribbon);
+}
+
+// the grid is painted once per zoom level into tiles that are a fixed number of pixels on a
+// side, so repainting the background is blitting whichever tiles the dirty rect overlaps.
+// Tiles are rendered in scene orientation, i.e. row zero is the tile's minimum y, which the
+// view's flipped transform then puts at the bottom of the tile on screen.
+
+const QPixmap& ui::canvas::scene::grid_tile(
+        int col, int row, double tile_size, qreal pixel_ratio) {
+    grid_tile_id key{ col, row, tile_size };
+    auto* tile = grid_tiles_.object(key);
+    if (tile && tile->devicePixelRatio() == pixel_ratio) {
+        return *tile;
+    }
+
+    auto pixels = static_cast<int>(std::ceil(k_grid_tile_pixels * pixel_ratio));
+    tile = new QPixmap(pixels, pixels);
+    tile->setDevicePixelRatio(pixel_ratio);
+
+    QRectF tile_rect(col * tile_size, row * tile_size, tile_size, tile_size);
+    QPainter painter(tile);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.scale(k_grid_tile_pixels / tile_size, k_grid_tile_pixels / tile_size);
+    painter.translate(-tile_rect.topLeft());
+    painter.fillRect(tile_rect, k_background_color);
+    auto grid_rect = tile_rect.intersected(sceneRect());
+    if (!grid_rect.isEmpty()) {
+        draw_grid_lines(&painter, grid_rect, k_grid_line_spacing);
+    }
+    painter.end();
+
+    grid_tiles_.insert(key, tile, pixels * pixels);
+    return *tile;
 }
 
 void ui::canvas::scene::drawBackground(QPainter* painter, const QRectF& dirty_rect) {
-    painter->fillRect(dirty_rect, QColor::fromRgb(53,53,53));
-    painter->setRenderHint(QPainter::Antialiasing, true);
-    auto scene_rect = sceneRect();
-    auto rect = dirty_rect.intersected(scene_rect);
+    painter->fillRect(dirty_rect, k_background_color);
+    auto rect = dirty_rect.intersected(sceneRect());
+    if (rect.isEmpty()) {
+        return;
+    }
 
-    draw_grid_lines(painter, rect, k_grid_line_spacing);
+    auto tile_size = k_grid_tile_pixels / scale();
+    auto pixel_ratio = painter->device()->devicePixelRatioF();
+    int left = static_cast<int>(std::floor(rect.left() / tile_size));
+    int right = static_cast<int>(std::floor(rect.right() / tile_size));
+    int top = static_cast<int>(std::floor(rect.top() / tile_size));
+    int bottom = static_cast<int>(std::floor(rect.bottom() / tile_size));
+    for (auto row : rv::iota(top, bottom + 1)) {
+        for (auto col : rv::iota(left, right + 1)) {
+            const auto& tile = grid_tile(col, row, tile_size, pixel_ratio);
+            painter->drawPixmap(
+                QRectF(col * tile_size, row * tile_size, tile_size, tile_size),
+                tile,
+                QRectF(tile.rect())
+            );
+        }
+    }
 }
 
 QRect client_rectangle(const QGraphicsView* view) {
@@ -202,13 +266,30 @@ void ui::canvas::scene::focusOutEvent(QFocusEvent* focusEvent) {
 }
 
 void ui::canvas::scene::set_scale_aux(double scale, std::optional<QPointF> center) {
+    auto was_batched = is_batched();
     auto& view = this->view();
     view.resetTransform();
     view.scale(scale, -scale);
     if (center) {
         view.centerOn(*center);
     }
-    sync_to_model();
+    if (is_batched() != was_batched) {
+        prepare_items();
+        return;
+    }
+    sync_skeletons_to_scale();
+}
+
+// only shown skeleton items have geometry that depends on the scale. Drawing items rather
+// than batches, that is just the selected ones; the others sync to the scale when they are
+// shown, since showing one syncs it to the model.
+
+void ui::canvas::scene::sync_skeletons_to_scale() {
+    auto skels = is_batched() ?
+        skeleton_items() : to_vector_of_type<item::skeleton>(selection_);
+    for (auto* skel : skels) {
+        skel->sync_to_scale();
+    }
 }
 
 void ui::canvas::scene::set_scale(double scale, std::optional<QPointF> center) {
@@ -230,31 +311,251 @@ void ui::canvas::scene::sync_to_model() {
     auto itms = items() | r::to<std::vector>();
     for (auto* child : itms | rv::transform(to_stick_man) | rv::filter([](auto* p) {return p; })) {
         child->sync_to_model();
+        update_index(child);
+    }
+    aggregates_.update();
+}
+
+// syncs only the items that depend on the given nodes and bones: their own items, the bones
+// attached to the nodes, and the bounding boxes of the skeletons they belong to.
+
+void ui::canvas::scene::sync_to_model(
+        std::span<sm::node* const> nodes, std::span<sm::bone* const> bones) {
+    std::unordered_set<item::base*> stale;
+    std::unordered_set<sm::skeleton*> skeletons;
+    auto add_item = [&](auto* itm) {
+        if (itm) {
+            stale.insert(itm);
+        }
+    };
+    auto add_bone = [&](sm::bone& bone) {
+        add_item(item_of(bone));
+    };
+    for (auto* node : nodes) {
+        add_item(item_of(*node));
+        auto parent = node->parent_bone();
+        if (parent) {
+            add_bone(parent->get());
+        }
+        for (auto child : node->child_bones()) {
+            add_bone(child.get());
+        }
+        skeletons.insert(&node->owner());
+    }
+    for (auto* bone : bones) {
+        add_bone(*bone);
+        skeletons.insert(&bone->owner());
+    }
+    for (auto* skel : skeletons) {
+        add_item(item_of(*skel));
+    }
+
+    for (auto* itm : stale) {
+        itm->sync_to_model();
+        update_index(itm);
     }
+    aggregates_.update(nodes, bones);
 }
 
-void ui::canvas::scene::set_contents(const std::vector<sm::skel_ref>& contents) {
+// poses are shown by moving the skeleton's items, not its model, so playback never shows up
+// in undo, the journal or an autosave. The spatial index is left where the model is, so
+// picking during playback still finds pieces where editing them would act.
 
-    clear();
+void ui::canvas::scene::show_pose(sm::skeleton& skel, std::span<const sm::point> pose) {
+    auto node_ids = playback_->animation().node_ids();
+    for (auto [id, pt] : rv::zip(node_ids, pose)) {
+        auto* node = playback_world_->from_id<sm::node>(id);
+        if (auto* ni = node ? item_of(*node) : nullptr; ni) {
+            ni->show_at(pt);
+        }
+    }
+    for (auto bone : skel.bones()) {
+        auto* bi = item_of(bone.get());
+        if (!bi) {
+            continue;
+        }
+        auto u = bi->parent_node_item().pos();
+        auto v = bi->child_node_item().pos();
+        bi->show_between({ u.x(), u.y() }, { v.x(), v.y() });
+    }
+    if (auto* si = item_of(skel); si) {
+        si->sync_to_items();
+    }
+}
+
+// whether the worker is done is read before taking the latest pose, so its final pose is
+// always shown before the timer stops.
+
+void ui::canvas::scene::show_latest_pose() {
+    auto* skel = playback_world_->from_id<sm::skeleton>(playback_skeleton_);
+    if (!skel) {
+        stop_playback();
+        return;
+    }
+    auto is_playing = playback_->is_playing();
+    if (auto* frame = playback_->take_latest(); frame) {
+        show_pose(*skel, frame->positions);
+    }
+    emit manager().playback_progress(*this, playback_->ticks_played(),
+        playback_->dropped_frames(), playback_->late_frames());
+    if (!is_playing) {
+        playback_timer_.stop();
+    }
+}
+
+// QGraphicsView does not expose vsync, so the canvas polls for the latest pose once per
+// refresh of the screen it is on; between polls the worker just overwrites its back frame.
+
+void ui::canvas::scene::play(std::shared_ptr<const sm::compiled_animation> anim,
+        sm::skeleton& skel, const sm::playback_options& opts) {
+    stop_playback();
+    playback_world_ = &skel.owner();
+    playback_skeleton_ = skel.id();
+    playback_ = std::make_unique<sm::playback_scheduler>(std::move(anim), opts);
+
+    auto* screen = view().screen();
+    auto refresh_rate = (screen) ? screen->refreshRate() : 60.0;
+    playback_timer_.setInterval(std::max(static_cast<int>(1000.0 / refresh_rate), 1));
+    playback_->start();
+    playback_timer_.start();
+}
+
+void ui::canvas::scene::stop_playback() {
+    if (!playback_) {
+        return;
+    }
+    playback_timer_.stop();
+    playback_->stop();
+    if (auto* skel = playback_world_->from_id<sm::skeleton>(playback_skeleton_); skel) {
+        auto nodes = skel->nodes() | rv::transform(
+                [](sm::node& node) { return &node; }
+            ) | r::to<std::vector>();
+        auto bones = skel->bones() | rv::transform(
+                [](sm::bone& bone) { return &bone; }
+            ) | r::to<std::vector>();
+        sync_to_model(nodes, bones);
+    }
+    playback_.reset();
+}
+
+const sm::playback_scheduler* ui::canvas::scene::playback() const {
+    return playback_.get();
+}
+
+// reconciles the canvas's items with the given skeletons instead of rebuilding all of them.
+// Items whose model pieces are still here are kept, items whose pieces are gone are pooled,
+// and pieces without items take them from the pool before new ones are made. Kept items are
+// only synced if their skeletons are among the stale ones, or if none are given.
+
+void ui::canvas::scene::set_contents(const std::vector<sm::skel_ref>& contents,
+        const std::unordered_set<const sm::skeleton*>* stale) {
+    stop_playback();
+    selection_.clear();
+    synced_selection_.clear();
+    aggregates_.clear();
+
+    auto unclaimed_skels = to_set(skeleton_items());
+    auto unclaimed_nodes = to_set(index_.nodes());
+    auto unclaimed_bones = to_set(index_.bones());
+    std::vector<sm::skeleton*> new_skels;
+    std::vector<sm::node*> new_nodes;
+    std::vector<sm::bone*> new_bones;
+
+    auto claim = [this](auto& piece, auto& unclaimed, auto& unmatched, bool should_sync) {
+        auto* itm = item_of(piece);
+        if (!itm || !unclaimed.contains(itm)) {
+            unmatched.push_back(&piece);
+            return;
+        }
+        unclaimed.erase(itm);
+        if (itm->is_selected()) {
+            itm->set_selected(false);
+        }
+        if (should_sync) {
+            itm->sync_to_model();
+            update_index(itm);
+        }
+    };
     for (auto skel_ref : contents) {
         auto& skel = skel_ref.get();
-        insert_item(skel);
-
+        bool should_sync = !stale || stale->contains(&skel);
+        claim(skel, unclaimed_skels, new_skels, should_sync);
         for (auto node : skel.nodes()) {
-            addItem(new ui::canvas::item::node(node.get(), scale()));
+            claim(node.get(), unclaimed_nodes, new_nodes, should_sync);
         }
-
         for (auto bone : skel.bones()) {
-            addItem(new ui::canvas::item::bone(bone.get(), scale()));
+            claim(bone.get(), unclaimed_bones, new_bones, should_sync);
         }
     }
 
+    release_items(unclaimed_skels, skeleton_pool_);
+    release_items(unclaimed_nodes, node_pool_);
+    release_items(unclaimed_bones, bone_pool_);
+
+    for (auto* skel : new_skels) {
+        reuse_item(*skel, skeleton_pool_);
+    }
+    for (auto* node : new_nodes) {
+        reuse_item(*node, node_pool_);
+    }
+    for (auto* bone : new_bones) {
+        reuse_item(*bone, bone_pool_);
+    }
+}
+
+// the model pieces of released items may already be destroyed, so nothing here can go
+// through an item's model.
+
+template<typename T>
+void ui::canvas::scene::release_items(
+        const std::unordered_set<T*>& items, std::vector<std::unique_ptr<T>>& pool) {
+    for (auto* itm : items) {
+        auto* base = static_cast<item::base*>(itm);
+        base->is_selected_ = false;
+        if (base->selection_frame_) {
+            base->selection_frame_->hide();
+        }
+        if constexpr (std::is_same_v<T, item::bone>) {
+            itm->hide_rotation_constraint();
+        }
+        if constexpr (!std::is_same_v<T, item::skeleton>) {
+            index_.remove(itm);
+        }
+        unregister_item(itm);
+        removeItem(itm);
+        if (pool.size() < k_max_pooled_items) {
+            pool.emplace_back(itm);
+        } else {
+            delete itm;
+        }
+    }
+}
+
+template<typename T>
+T* ui::canvas::scene::reuse_item(
+        typename T::model_type& piece, std::vector<std::unique_ptr<T>>& pool) {
+    if (pool.empty()) {
+        return insert_item(piece);
+    }
+    auto* itm = pool.back().release();
+    pool.pop_back();
+    itm->rebind(piece);
+    register_item(itm);
+    addItem(itm);
+    prepare_item(itm);
+    itm->sync_to_model();
+    update_index(itm);
+    return itm;
 }
 
 const ui::canvas::selection_set&  ui::canvas::scene::selection() const {
 	return selection_;
 }
 
+const ui::canvas::selection_aggregates& ui::canvas::scene::aggregates() const {
+    return aggregates_;
+}
+
 ui::canvas::item::skeleton* ui::canvas::scene::selected_skeleton() const {
 	auto skeletons = to_vector_of_type<ui::canvas::item::skeleton>(selection_);
 	return (skeletons.size() == 1) ? skeletons.front() : nullptr;
@@ -274,19 +575,28 @@ bool ui::canvas::scene::is_status_line_visible() const {
 
 ui::canvas::item::node* ui::canvas::scene::insert_item(sm::node& node) {
 	ui::canvas::item::node* ni;
-	addItem(ni = new item::node(node, scale()));
+	addItem(ni = new item::node(node));
+	register_item(ni);
+	prepare_item(ni);
+	update_index(ni);
 	return ni;
 }
 
 ui::canvas::item::bone* ui::canvas::scene::insert_item(sm::bone& bone) {
 	ui::canvas::item::bone* bi;
-	addItem(bi = new item::bone(bone, scale()));
+	addItem(bi = new item::bone(bone));
+	register_item(bi);
+	prepare_item(bi);
+	update_index(bi);
+	aggregates_.invalidate_order();
 	return bi;
 }
 
 ui::canvas::item::skeleton* ui::canvas::scene::insert_item(sm::skeleton& skel) {
 	ui::canvas::item::skeleton* si;
-	addItem(si = new item::skeleton(skel, scale()));
+	addItem(si = new item::skeleton(skel));
+	register_item(si);
+	prepare_item(si);
 	return si;
 }
 
@@ -341,7 +651,16 @@ void ui::canvas::scene::clear_selection() {
 }
 
 void ui::canvas::scene::clear() {
+    stop_playback();
     selection_.clear();
+    synced_selection_.clear();
+    aggregates_.clear();
+    items_by_id_.clear();
+    free_ids_.clear();
+    index_.clear();
+    node_table_.clear();
+    bone_table_.clear();
+    skeleton_table_.clear();
     auto items = canvas_items();
 	for (auto* item : items) {
         if (item->selection_frame()) {
@@ -354,13 +673,23 @@ void ui::canvas::scene::clear() {
 	}
 }
 
+// only the items whose selection state changed since the last sync are touched, and the
+// selection_changed signal carries just what was added and removed.
+
 void ui::canvas::scene::sync_selection() {
-    auto itms = items() | r::to<std::vector>();
-    for (auto* itm : as_range_view_of_type<ui::canvas::item::base>(itms)) {
-        bool selected = selection_.contains(itm);
-        itm->set_selected(selected);
+    selection_delta delta{
+        selection_.minus(synced_selection_),
+        synced_selection_.minus(selection_)
+    };
+    for (auto* itm : delta.removed) {
+        itm->set_selected(false);
     }
-    emit manager().selection_changed(*this);
+    for (auto* itm : delta.added) {
+        itm->set_selected(true);
+    }
+    synced_selection_ = selection_;
+    aggregates_.apply(delta);
+    emit manager().selection_changed(*this, delta);
 }
 
 QGraphicsView& ui::canvas::scene::view() {
@@ -377,28 +706,34 @@ void ui::canvas::scene::show_status_line(const QString& txt) {
     setFocus();
 }
 
+// filtered out items are deselected right away but are only reported as removed by the
+// next sync_selection().
+
 void ui::canvas::scene::filter_selection(std::function<bool(item::base*)> filter) {
-	selection_set sel;
+	std::vector<item::base*> rejected;
 	for (auto* aci : selection_) {
-		if (filter(aci)) {
-			sel.insert(aci);
-		} else {
-			aci->set_selected(false);
+		if (!filter(aci)) {
+			rejected.push_back(aci);
 		}
 	}
-	selection_ = sel;
+	for (auto* aci : rejected) {
+		selection_.erase(aci);
+		aci->set_selected(false);
+	}
 }
 
 void ui::canvas::scene::delete_item(item::base* deletee, bool emit_signals) {
-	bool was_selected = deletee->is_selected();
-	if (was_selected) {
-		filter_selection(
-			[deletee](item::base* item)->bool {
-				return item != deletee;
-			}
-		);
+	if (emit_signals && deletee->is_selected()) {
+		subtract_from_selection(deletee, true);
 	}
 
+    if (auto* ni = dynamic_cast<item::node*>(deletee); ni) {
+        index_.remove(ni);
+    } else if (auto* bi = dynamic_cast<item::bone*>(deletee); bi) {
+        index_.remove(bi);
+    }
+    unregister_item(deletee);
+
     auto* body = deletee->item_body();
     auto* sel_frame = deletee->selection_frame();
     if (body) {
@@ -411,13 +746,6 @@ void ui::canvas::scene::delete_item(item::base* deletee, bool emit_signals) {
         delete sel_frame;
     }
     delete body;
-
-
-	if (emit_signals) {
-		if (was_selected) {
-			emit manager().selection_changed(*this);
-		}
-	}
 }
 
 QPointF ui::canvas::scene::from_global_to_canvas(const QPoint& pt) {
@@ -429,6 +757,144 @@ void ui::canvas::scene::set_drag_mode(drag_mode dm) {
     view().setDragMode( to_qt_drag_mode(dm) );
 }
 
+bool ui::canvas::scene::is_batched() const {
+    return render_mode_ == render_mode::batched || level_of_detail() != detail_level::full;
+}
+
+ui::canvas::detail_level ui::canvas::scene::level_of_detail() const {
+    auto scale = this->scale();
+    if (scale < lod_thresholds_.bounding_boxes) {
+        return detail_level::bounding_boxes;
+    } else if (scale < lod_thresholds_.polylines) {
+        return detail_level::polylines;
+    } else if (scale < lod_thresholds_.simplified) {
+        return detail_level::simplified;
+    }
+    return detail_level::full;
+}
+
+void ui::canvas::scene::prepare_item(item::base* itm) {
+    if (!itm->is_selection_frame_only()) {
+        itm->item_body()->setFlag(QGraphicsItem::ItemHasNoContents, is_batched());
+    } else {
+        itm->item_body()->setVisible(itm->is_selected() || is_batched());
+        if (is_batched()) {
+            itm->sync_to_model();
+        }
+    }
+}
+
+// items are registered under the ids of their model pieces; see item_of(). They are also
+// given dense ids of their own, shared by all three kinds of item, which the selection is
+// a bitset over.
+
+void ui::canvas::scene::register_item(item::base* itm) {
+    if (free_ids_.empty()) {
+        itm->canvas_id_ = static_cast<uint32_t>(items_by_id_.size());
+        items_by_id_.push_back(itm);
+    } else {
+        itm->canvas_id_ = free_ids_.back();
+        free_ids_.pop_back();
+        items_by_id_[itm->canvas_id_] = itm;
+    }
+    if (auto* ni = dynamic_cast<item::node*>(itm); ni) {
+        node_table_.insert(ni->model_id(), ni);
+    } else if (auto* bi = dynamic_cast<item::bone*>(itm); bi) {
+        bone_table_.insert(bi->model_id(), bi);
+    } else if (auto* si = dynamic_cast<item::skeleton*>(itm); si) {
+        skeleton_table_.insert(si->model_id(), si);
+    }
+}
+
+void ui::canvas::scene::unregister_item(item::base* itm) {
+    if (synced_selection_.contains(itm)) {
+        aggregates_.remove(itm);
+    }
+    selection_.erase(itm);
+    synced_selection_.erase(itm);
+    items_by_id_[itm->canvas_id_] = nullptr;
+    free_ids_.push_back(itm->canvas_id_);
+    if (auto* ni = dynamic_cast<item::node*>(itm); ni) {
+        node_table_.erase(ni->model_id(), ni);
+    } else if (auto* bi = dynamic_cast<item::bone*>(itm); bi) {
+        bone_table_.erase(bi->model_id(), bi);
+    } else if (auto* si = dynamic_cast<item::skeleton*>(itm); si) {
+        skeleton_table_.erase(si->model_id(), si);
+    }
+}
+
+// a piece restored by undo reclaims the id it had before it was deleted, so until the
+// canvas is refreshed its id can still map to the item of the deleted piece; the item only
+// counts as the piece's if it is showing that very piece.
+
+ui::canvas::item::node* ui::canvas::scene::item_of(const sm::node& node) const {
+    auto* itm = node_table_.get(node.id());
+    return (itm && &itm->model() == &node) ? itm : nullptr;
+}
+
+ui::canvas::item::bone* ui::canvas::scene::item_of(const sm::bone& bone) const {
+    auto* itm = bone_table_.get(bone.id());
+    return (itm && &itm->model() == &bone) ? itm : nullptr;
+}
+
+ui::canvas::item::skeleton* ui::canvas::scene::item_of(const sm::skeleton& skel) const {
+    auto* itm = skeleton_table_.get(skel.id());
+    return (itm && &itm->model() == &skel) ? itm : nullptr;
+}
+
+// the index holds node centers and bone segments in world coordinates, which are
+// also scene coordinates; skeleton items are not indexed.
+
+void ui::canvas::scene::update_index(item::base* itm) {
+    if (auto* ni = dynamic_cast<item::node*>(itm); ni) {
+        index_.insert(ni, ni->model().world_pos());
+    } else if (auto* bi = dynamic_cast<item::bone*>(itm); bi) {
+        const auto& bone = bi->model();
+        index_.insert(bi, bone.parent_node().world_pos(), bone.child_node().world_pos());
+    }
+}
+
+// node items are drawn at a constant size on screen so in scene coordinates how close
+// a point has to be to hit one depends on the zoom level.
+
+double ui::canvas::scene::pick_radius() const {
+    return k_node_radius / scale();
+}
+
+void ui::canvas::scene::set_render_mode(render_mode rm) {
+    if (rm == render_mode_) {
+        return;
+    }
+    auto was_batched = is_batched();
+    render_mode_ = rm;
+    if (is_batched() != was_batched) {
+        prepare_items();
+    }
+}
+
+void ui::canvas::scene::set_lod_thresholds(const lod_thresholds& thresholds) {
+    auto was_batched = is_batched();
+    lod_thresholds_ = thresholds;
+    if (is_batched() != was_batched) {
+        prepare_items();
+        return;
+    }
+    sync_skeletons_to_scale();
+}
+
+// switching between drawing items individually and batching them by skeleton touches
+// every item, so it only happens when the render mode changes or zooming crosses the
+// threshold of full detail.
+
+void ui::canvas::scene::prepare_items() {
+    for (auto* itm : canvas_items()) {
+        prepare_item(itm);
+        itm->set_selected(itm->is_selected());
+        itm->sync_to_model();
+    }
+    update();
+}
+
 void ui::canvas::scene::hide_status_line() {
     status_line_.clear();
     update();
@@ -465,15 +931,52 @@ std::string ui::canvas::scene::tab_name() const {
 /*------------------------------------------------------------------------------------------------*/
 
 ui::canvas::item::node* ui::canvas::scene::top_node(const QPointF& pt) const {
-    return top_item_of_type<ui::canvas::item::node>(*this, pt);
+    auto nodes = index_.nodes_near(from_qt_pt(pt), pick_radius());
+    return nodes.empty() ? nullptr : nodes.front();
 }
 
+// nodes are drawn on top of bones and bones on top of the bounding boxes of selected
+// skeletons, so hits are tested in that order. The index only narrows bones down to
+// those near the point; whether the point is on the bone's shape is up to the item.
+
 ui::canvas::item::base* ui::canvas::scene::top_item(const QPointF& pt) const {
-    return top_item_of_type<ui::canvas::item::base>(*this, pt);
+    auto* node = top_node(pt);
+    if (node) {
+        return node;
+    }
+    for (auto* bone : index_.bones_near(from_qt_pt(pt), pick_radius())) {
+        if (bone->contains(bone->mapFromScene(pt))) {
+            return bone;
+        }
+    }
+    for (auto* skel : to_vector_of_type<item::skeleton>(selection_)) {
+        if (skel->contains(skel->mapFromScene(pt))) {
+            return skel;
+        }
+    }
+    return nullptr;
+}
+
+ui::canvas::item::node* ui::canvas::scene::nearest_node(
+        const QPointF& pt, double max_distance) const {
+    return index_.nearest_node(from_qt_pt(pt), max_distance);
 }
 
 std::vector<ui::canvas::item::base*> ui::canvas::scene::items_in_rect(const QRectF& r) const {
-    return qt_to_vector_of_type<ui::canvas::item::base>( items(r) );
+    auto rect = r.normalized();
+    sm::point min = { rect.left(), rect.top() };
+    sm::point max = { rect.right(), rect.bottom() };
+    auto itms = index_.nodes_in_rect(min, max, pick_radius()) |
+        r::to<std::vector<item::base*>>();
+    for (auto* bone : index_.bones_in_rect(min, max)) {
+        itms.push_back(bone);
+    }
+    for (auto* skel : to_vector_of_type<item::skeleton>(selection_)) {
+        if (skel->sceneBoundingRect().intersects(rect)) {
+            itms.push_back(skel);
+        }
+    }
+    return itms;
 }
 
 std::vector<ui::canvas::item::base*> ui::canvas::scene::canvas_items() const {
@@ -491,17 +994,26 @@ std::vector<ui::canvas::item::node*> ui::canvas::scene::root_node_items() const
 }
 
 std::vector<ui::canvas::item::node*> ui::canvas::scene::node_items() const {
-    return qt_to_vector_of_type<item::node>( items());
+    return index_.nodes();
 }
 
 std::vector<ui::canvas::item::bone*> ui::canvas::scene::bone_items() const {
-    return qt_to_vector_of_type<item::bone>( items() );
+    return index_.bones();
 }
 
 std::vector<ui::canvas::item::skeleton*> ui::canvas::scene::skeleton_items() const {
     return qt_to_vector_of_type<item::skeleton>( items() );
 }
 
+// items that ignore the view's transformation are sized in pixels, which
+// QGraphicsItem::sceneBoundingRect() would treat as scene units.
+
+QRectF ui::canvas::scene::scene_bounding_rect(const QGraphicsItem* itm) const {
+    const auto& view = this->view();
+    auto device_rect = itm->deviceTransform(view.viewportTransform()).mapRect(itm->boundingRect());
+    return view.mapToScene(device_rect.toAlignedRect()).boundingRect();
+}
+
 std::optional<int> ui::canvas::scene::zoom_level() const
 {
     return zoom_level_;
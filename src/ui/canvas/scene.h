@@ -2,11 +2,20 @@
 
 #include "../util.h"
 #include "../../model/project.h"
+#include "../../core/sm_scheduler.h"
 #include "rubber_band.h"
+#include "spatial_index.h"
+#include "item_table.h"
+#include "selection_set.h"
+#include "selection_aggregates.h"
 #include <QWidget>
 #include <QtWidgets>
 #include <QGraphicsScene>
+#include <QTimer>
+#include <QCache>
+#include <QPixmap>
 #include <vector>
+#include <memory>
 #include <any>
 #include <unordered_set>
 #include <span>
@@ -47,8 +56,6 @@ namespace ui {
             class skeleton;
         }
 
-        using selection_set = std::unordered_set<item::base*>;
-
         using item_transform = std::function<void(item::base*)>;
         using node_transform = std::function<void(item::node*)>;
         using bone_transform = std::function<void(item::bone*)>;
@@ -59,6 +66,46 @@ namespace ui {
             rubber_band
         };
 
+        // in batched mode each skeleton item paints all of its skeleton's nodes and bones
+        // itself, and node and bone items only carry geometry and selection state.
+
+        enum class render_mode {
+            items,
+            batched
+        };
+
+        // when zoomed out past these scales skeletons are drawn with less detail: bones as
+        // lines and nodes as dots, then bones as lines only, then each skeleton as just its
+        // bounding box. Below full detail skeletons are always drawn batched.
+
+        enum class detail_level {
+            full,
+            simplified,
+            polylines,
+            bounding_boxes
+        };
+
+        struct lod_thresholds {
+            double simplified = 0.3;
+            double polylines = 0.1;
+            double bounding_boxes = 0.03;
+        };
+
+        // grid tiles are cached per tile size, i.e. per zoom level, so zooming back to a
+        // level reuses its tiles rather than repainting them.
+
+        struct grid_tile_id {
+            int col;
+            int row;
+            double tile_size;
+
+            bool operator==(const grid_tile_id&) const = default;
+        };
+
+        inline size_t qHash(const grid_tile_id& id, size_t seed = 0) {
+            return qHashMulti(seed, id.col, id.row, id.tile_size);
+        }
+
         class scene : public QGraphicsScene {
 
             Q_OBJECT
@@ -69,16 +116,51 @@ namespace ui {
 
             constexpr static auto k_grid_line_spacing = 10;
             QString status_line_;
+            std::vector<item::base*> items_by_id_;
+            std::vector<uint32_t> free_ids_;
             selection_set selection_;
+            selection_set synced_selection_;
+            selection_aggregates aggregates_;
             tool::input_handler& inp_handler_;
             item::rubber_band* rubber_band_;
             std::optional<int> zoom_level_;
+            render_mode render_mode_;
+            lod_thresholds lod_thresholds_;
+            spatial_index index_;
+            item_table<item::node> node_table_;
+            item_table<item::bone> bone_table_;
+            item_table<item::skeleton> skeleton_table_;
+            QCache<grid_tile_id, QPixmap> grid_tiles_;
+            std::vector<std::unique_ptr<item::node>> node_pool_;
+            std::vector<std::unique_ptr<item::bone>> bone_pool_;
+            std::vector<std::unique_ptr<item::skeleton>> skeleton_pool_;
+            std::unique_ptr<sm::playback_scheduler> playback_;
+            sm::world* playback_world_;
+            sm::piece_id playback_skeleton_;
+            QTimer playback_timer_;
 
             
             QGraphicsView& view();
             const QGraphicsView& view() const;
             void set_drag_mode(drag_mode dm);
-            void set_contents(const std::vector<sm::skel_ref>& contents);
+            void set_render_mode(render_mode rm);
+            void set_lod_thresholds(const lod_thresholds& thresholds);
+            void prepare_items();
+            void prepare_item(item::base* itm);
+            void update_index(item::base* itm);
+            void register_item(item::base* itm);
+            void unregister_item(item::base* itm);
+            double pick_radius() const;
+            void set_contents(const std::vector<sm::skel_ref>& contents,
+                const std::unordered_set<const sm::skeleton*>* stale = nullptr);
+            template<typename T>
+            void release_items(
+                const std::unordered_set<T*>& items, std::vector<std::unique_ptr<T>>& pool);
+            template<typename T>
+            T* reuse_item(typename T::model_type& piece, std::vector<std::unique_ptr<T>>& pool);
+            const QPixmap& grid_tile(int col, int row, double tile_size, qreal pixel_ratio);
+            void show_pose(sm::skeleton& skel, std::span<const sm::point> pose);
+            void show_latest_pose();
 
             void keyPressEvent(QKeyEvent* event) override;
             void keyReleaseEvent(QKeyEvent* event) override;
@@ -91,12 +173,18 @@ namespace ui {
             void drawForeground(QPainter* painter, const QRectF& rect) override;
             void focusOutEvent(QFocusEvent* focusEvent) override;
             void set_scale_aux(double scale, std::optional<QPointF> pt = {});
+            void sync_skeletons_to_scale();
         public:
 
             scene(tool::input_handler& inp_handler);
+            ~scene();
             void init();
             item::node* top_node(const QPointF& pt) const;
             item::base* top_item(const QPointF & pt) const;
+            item::node* nearest_node(const QPointF& pt, double max_distance) const;
+            item::node* item_of(const sm::node& node) const;
+            item::bone* item_of(const sm::bone& bone) const;
+            item::skeleton* item_of(const sm::skeleton& skel) const;
             std::vector<item::base*> items_in_rect(const QRectF& pt) const;
             std::vector<item::base*> canvas_items() const;
             std::vector<item::node*> root_node_items() const;
@@ -108,11 +196,25 @@ namespace ui {
             double scale() const;
             void set_zoom_level(int zoom, std::optional<QPointF> pt = {});
             std::optional<int> zoom_level() const;
+            QRectF scene_bounding_rect(const QGraphicsItem* itm) const;
             int closest_zoom_level() const;
 
+            bool is_batched() const;
+            detail_level level_of_detail() const;
             void sync_to_model();
+            void sync_to_model(std::span<sm::node* const> nodes, std::span<sm::bone* const> bones);
+
+            // plays the animation on the skeleton. Poses are evaluated on a worker thread and
+            // the canvas shows the latest one at the screen's refresh rate by moving the
+            // skeleton's items; the model is never changed. Stopping puts the items back
+            // where the model is.
+            void play(std::shared_ptr<const sm::compiled_animation> anim, sm::skeleton& skel,
+                const sm::playback_options& opts = {});
+            void stop_playback();
+            const sm::playback_scheduler* playback() const;
 
             const selection_set& selection() const;
+            const selection_aggregates& aggregates() const;
             //sel_type selection_type() const;
 
             item::skeleton* selected_skeleton() const;
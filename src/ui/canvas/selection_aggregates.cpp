@@ -0,0 +1,273 @@
+#include "selection_aggregates.h"
+#include "node_item.h"
+#include "bone_item.h"
+#include "../util.h"
+#include "../../core/sm_skeleton.h"
+#include "../../core/sm_bone.h"
+#include <algorithm>
+#include <ranges>
+#include <tuple>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+
+/*------------------------------------------------------------------------------------------------*/
+
+void ui::canvas::value_tally::insert(double val) {
+    ++counts_[val];
+}
+
+void ui::canvas::value_tally::erase(double val) {
+    auto iter = counts_.find(val);
+    if (iter != counts_.end() && --iter->second == 0) {
+        counts_.erase(iter);
+    }
+}
+
+void ui::canvas::value_tally::clear() {
+    counts_.clear();
+}
+
+bool ui::canvas::value_tally::empty() const {
+    return counts_.empty();
+}
+
+std::optional<double> ui::canvas::value_tally::min() const {
+    if (counts_.empty()) {
+        return {};
+    }
+    return counts_.begin()->first;
+}
+
+std::optional<double> ui::canvas::value_tally::max() const {
+    if (counts_.empty()) {
+        return {};
+    }
+    return counts_.rbegin()->first;
+}
+
+std::optional<double> ui::canvas::value_tally::common() const {
+    if (counts_.empty() || !ui::is_approximately_equal(*min(), *max(), ui::k_tolerance)) {
+        return {};
+    }
+    return min();
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+void ui::canvas::selection_aggregates::insert(sm::node& node) {
+    node_values vals{ node.world_x(), node.world_y() };
+    if (!nodes_.emplace(&node, vals).second) {
+        return;
+    }
+    x_.insert(vals.x);
+    y_.insert(vals.y);
+}
+
+void ui::canvas::selection_aggregates::insert(sm::bone& bone) {
+    bone_values vals{ bone.scaled_length(), bone.world_rotation() };
+    if (!bones_.emplace(&bone, vals).second) {
+        return;
+    }
+    length_.insert(vals.length);
+    rotation_.insert(vals.rotation);
+    bone_order_.reset();
+}
+
+void ui::canvas::selection_aggregates::erase(sm::node* node) {
+    auto iter = nodes_.find(node);
+    if (iter == nodes_.end()) {
+        return;
+    }
+    x_.erase(iter->second.x);
+    y_.erase(iter->second.y);
+    nodes_.erase(iter);
+}
+
+void ui::canvas::selection_aggregates::erase(sm::bone* bone) {
+    auto iter = bones_.find(bone);
+    if (iter == bones_.end()) {
+        return;
+    }
+    length_.erase(iter->second.length);
+    rotation_.erase(iter->second.rotation);
+    bones_.erase(iter);
+    bone_order_.reset();
+}
+
+void ui::canvas::selection_aggregates::retally(sm::node& node) {
+    if (nodes_.contains(&node)) {
+        erase(&node);
+        insert(node);
+    }
+}
+
+// a bone's tallies change but its place in the order does not.
+
+void ui::canvas::selection_aggregates::retally(sm::bone& bone) {
+    auto iter = bones_.find(&bone);
+    if (iter == bones_.end()) {
+        return;
+    }
+    auto& vals = iter->second;
+    length_.erase(vals.length);
+    rotation_.erase(vals.rotation);
+    vals = { bone.scaled_length(), bone.world_rotation() };
+    length_.insert(vals.length);
+    rotation_.insert(vals.rotation);
+}
+
+void ui::canvas::selection_aggregates::apply(const selection_delta& delta) {
+    for (auto* itm : delta.removed) {
+        remove(itm);
+    }
+    for (auto* itm : delta.added) {
+        if (auto* ni = dynamic_cast<item::node*>(itm); ni) {
+            insert(ni->model());
+        } else if (auto* bi = dynamic_cast<item::bone*>(itm); bi) {
+            insert(bi->model());
+        }
+    }
+}
+
+// the model marks dirty the nodes it moved and the bones it changed; moving a node also
+// changes the bones attached to it, as when the canvas syncs its items.
+
+void ui::canvas::selection_aggregates::update(
+        std::span<sm::node* const> nodes, std::span<sm::bone* const> bones) {
+    if (nodes_.empty() && bones_.empty()) {
+        return;
+    }
+    for (auto* node : nodes) {
+        retally(*node);
+        auto parent = node->parent_bone();
+        if (parent) {
+            retally(parent->get());
+        }
+        for (auto child : node->child_bones()) {
+            retally(child.get());
+        }
+    }
+    for (auto* bone : bones) {
+        retally(*bone);
+    }
+}
+
+// for when the model changed without saying which pieces it changed.
+
+void ui::canvas::selection_aggregates::update() {
+    for (auto& [node, vals] : nodes_) {
+        x_.erase(vals.x);
+        y_.erase(vals.y);
+        vals = { node->world_x(), node->world_y() };
+        x_.insert(vals.x);
+        y_.insert(vals.y);
+    }
+    for (auto& [bone, vals] : bones_) {
+        length_.erase(vals.length);
+        rotation_.erase(vals.rotation);
+        vals = { bone->scaled_length(), bone->world_rotation() };
+        length_.insert(vals.length);
+        rotation_.insert(vals.rotation);
+    }
+    bone_order_.reset();
+}
+
+// the item's model may already be deleted, so it is only used as a key.
+
+void ui::canvas::selection_aggregates::remove(item::base* itm) {
+    if (auto* ni = dynamic_cast<item::node*>(itm); ni) {
+        erase(&ni->model());
+    } else if (auto* bi = dynamic_cast<item::bone*>(itm); bi) {
+        erase(&bi->model());
+    }
+}
+
+void ui::canvas::selection_aggregates::invalidate_order() {
+    bone_order_.reset();
+}
+
+void ui::canvas::selection_aggregates::clear() {
+    nodes_.clear();
+    bones_.clear();
+    x_.clear();
+    y_.clear();
+    length_.clear();
+    rotation_.clear();
+    bone_order_.reset();
+}
+
+size_t ui::canvas::selection_aggregates::node_count() const {
+    return nodes_.size();
+}
+
+size_t ui::canvas::selection_aggregates::bone_count() const {
+    return bones_.size();
+}
+
+const ui::canvas::value_tally& ui::canvas::selection_aggregates::node_x() const {
+    return x_;
+}
+
+const ui::canvas::value_tally& ui::canvas::selection_aggregates::node_y() const {
+    return y_;
+}
+
+const ui::canvas::value_tally& ui::canvas::selection_aggregates::bone_length() const {
+    return length_;
+}
+
+const ui::canvas::value_tally& ui::canvas::selection_aggregates::bone_rotation() const {
+    return rotation_;
+}
+
+// ordering by depth puts every bone after its ancestors. Depths are memoized as they are
+// found, so only the chains above the selected bones are walked, and each of them once.
+
+const std::vector<sm::bone*>& ui::canvas::selection_aggregates::bones_in_topological_order() const {
+    if (bone_order_) {
+        return *bone_order_;
+    }
+
+    std::unordered_map<const sm::bone*, int> depths;
+    auto depth_of = [&depths](const sm::bone& bone)->int {
+        std::vector<const sm::bone*> chain;
+        const sm::bone* curr = &bone;
+        int depth = 0;
+        while (curr) {
+            if (auto iter = depths.find(curr); iter != depths.end()) {
+                depth = iter->second + 1;
+                break;
+            }
+            chain.push_back(curr);
+            auto parent = curr->parent_bone();
+            curr = (parent) ? &parent->get() : nullptr;
+        }
+        for (auto* b : chain | rv::reverse) {
+            depths[b] = depth++;
+        }
+        return depths.at(&bone);
+    };
+
+    struct ordered_bone {
+        int depth;
+        sm::piece_id id;
+        sm::bone* bone;
+    };
+    auto ordered = bones_ |
+        rv::transform(
+            [&](const auto& pair)->ordered_bone {
+                return { depth_of(*pair.first), pair.first->id(), pair.first };
+            }
+        ) | r::to<std::vector<ordered_bone>>();
+    r::sort(ordered,
+        [](const ordered_bone& lhs, const ordered_bone& rhs) {
+            return std::tie(lhs.depth, lhs.id.index) < std::tie(rhs.depth, rhs.id.index);
+        }
+    );
+
+    bone_order_ = ordered |
+        rv::transform([](const ordered_bone& ob) { return ob.bone; }) |
+        r::to<std::vector<sm::bone*>>();
+    return *bone_order_;
+}
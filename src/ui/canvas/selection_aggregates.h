@@ -0,0 +1,97 @@
+#pragma once
+
+#include "selection_set.h"
+#include <unordered_map>
+#include <map>
+#include <vector>
+#include <optional>
+#include <span>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace sm {
+    class node;
+    class bone;
+}
+
+namespace ui {
+
+    namespace canvas {
+
+        // how many of the selected pieces take each value of some property, so that the
+        // property's range and whether the selection agrees on it are known without visiting
+        // the selection.
+
+        class value_tally {
+
+            std::map<double, int> counts_;
+
+        public:
+
+            void insert(double val);
+            void erase(double val);
+            void clear();
+            bool empty() const;
+            std::optional<double> min() const;
+            std::optional<double> max() const;
+
+            // the value every piece has, to within the panes' tolerance, if there is one.
+            std::optional<double> common() const;
+        };
+
+        // summaries of a canvas's selection shared by the property panes: per-property tallies
+        // over the selected nodes and bones, and the selected bones in topological order. The
+        // canvas keeps it current as its selection is synced, as the model reports pieces
+        // dirty, and as items are unregistered, so the panes never rescan the selection or
+        // the skeletons. Pieces are remembered with the values they were tallied under, which
+        // lets them be taken out again without touching a model that may already be gone.
+
+        class selection_aggregates {
+
+            struct node_values {
+                double x;
+                double y;
+            };
+
+            struct bone_values {
+                double length;
+                double rotation;
+            };
+
+            std::unordered_map<sm::node*, node_values> nodes_;
+            std::unordered_map<sm::bone*, bone_values> bones_;
+            value_tally x_;
+            value_tally y_;
+            value_tally length_;
+            value_tally rotation_;
+            mutable std::optional<std::vector<sm::bone*>> bone_order_;
+
+            void insert(sm::node& node);
+            void insert(sm::bone& bone);
+            void erase(sm::node* node);
+            void erase(sm::bone* bone);
+            void retally(sm::node& node);
+            void retally(sm::bone& bone);
+
+        public:
+
+            void apply(const selection_delta& delta);
+            void update(std::span<sm::node* const> nodes, std::span<sm::bone* const> bones);
+            void update();
+            void remove(item::base* itm);
+            void invalidate_order();
+            void clear();
+
+            size_t node_count() const;
+            size_t bone_count() const;
+            const value_tally& node_x() const;
+            const value_tally& node_y() const;
+            const value_tally& bone_length() const;
+            const value_tally& bone_rotation() const;
+
+            // parents before children, which is the order edits that move descendants along
+            // with a bone have to be applied in.
+            const std::vector<sm::bone*>& bones_in_topological_order() const;
+        };
+    }
+}
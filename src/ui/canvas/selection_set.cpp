@@ -0,0 +1,79 @@
+#include "selection_set.h"
+#include "canvas_item.h"
+#include <algorithm>
+#include <cassert>
+
+/*------------------------------------------------------------------------------------------------*/
+
+ui::canvas::selection_set::selection_set(const std::vector<item::base*>& items) :
+        items_(&items) {
+}
+
+// an item's canvas id only means something to the canvas that gave it, so items of any
+// other canvas are never in the set and are ignored rather than aliasing one of its own.
+
+bool ui::canvas::selection_set::owns(const item::base* itm) const {
+    auto id = itm->canvas_id();
+    return id < items_->size() && (*items_)[id] == itm;
+}
+
+bool ui::canvas::selection_set::contains(const item::base* itm) const {
+    auto id = itm->canvas_id();
+    return id < bits_.size() && bits_.test(id) && owns(itm);
+}
+
+void ui::canvas::selection_set::insert(item::base* itm) {
+    assert(owns(itm));
+    if (!owns(itm)) {
+        return;
+    }
+    auto id = itm->canvas_id();
+    if (id >= bits_.size()) {
+        bits_.resize(std::max<size_t>(id + 1, items_->size()));
+    }
+    bits_.set(id);
+}
+
+void ui::canvas::selection_set::erase(const item::base* itm) {
+    auto id = itm->canvas_id();
+    if (id < bits_.size() && owns(itm)) {
+        bits_.reset(id);
+    }
+}
+
+void ui::canvas::selection_set::clear() {
+    bits_.reset();
+}
+
+size_t ui::canvas::selection_set::size() const {
+    return bits_.count();
+}
+
+bool ui::canvas::selection_set::empty() const {
+    return bits_.none();
+}
+
+ui::canvas::selection_set::iterator ui::canvas::selection_set::begin() const {
+    return { this, bits_.find_first() };
+}
+
+ui::canvas::selection_set::iterator ui::canvas::selection_set::end() const {
+    return { this, boost::dynamic_bitset<>::npos };
+}
+
+std::vector<ui::canvas::item::base*> ui::canvas::selection_set::minus(
+        const selection_set& other) const {
+    auto diff = bits_;
+    auto other_bits = other.bits_;
+    auto size = std::max(diff.size(), other_bits.size());
+    diff.resize(size);
+    other_bits.resize(size);
+    diff -= other_bits;
+
+    std::vector<item::base*> items;
+    items.reserve(diff.count());
+    for (auto id = diff.find_first(); id != diff.npos; id = diff.find_next(id)) {
+        items.push_back((*items_)[id]);
+    }
+    return items;
+}
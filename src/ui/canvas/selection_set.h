@@ -0,0 +1,90 @@
+#pragma once
+
+#include <boost/dynamic_bitset.hpp>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace ui {
+
+    namespace canvas {
+
+        namespace item {
+            class base;
+        }
+
+        // a canvas's selection as a bitset over the dense ids the canvas gives its items; see
+        // scene::register_item(). The set resolves ids through the canvas's id-to-item table
+        // and iterates over its items in id order.
+
+        class selection_set {
+
+            boost::dynamic_bitset<> bits_;
+            const std::vector<item::base*>* items_;
+
+            bool owns(const item::base* itm) const;
+
+        public:
+
+            class iterator {
+                const selection_set* set_;
+                size_t pos_;
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = item::base*;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = item::base*;
+
+                iterator() : set_(nullptr), pos_(boost::dynamic_bitset<>::npos) {}
+                iterator(const selection_set* set, size_t pos) : set_(set), pos_(pos) {}
+
+                item::base* operator*() const {
+                    return (*set_->items_)[pos_];
+                }
+                iterator& operator++() {
+                    pos_ = set_->bits_.find_next(pos_);
+                    return *this;
+                }
+                iterator operator++(int) {
+                    auto prev = *this;
+                    ++*this;
+                    return prev;
+                }
+                bool operator==(const iterator& i) const {
+                    return pos_ == i.pos_;
+                }
+            };
+
+            selection_set(const std::vector<item::base*>& items);
+
+            bool contains(const item::base* itm) const;
+            void insert(item::base* itm);
+            void erase(const item::base* itm);
+            void clear();
+            size_t size() const;
+            bool empty() const;
+            iterator begin() const;
+            iterator end() const;
+
+            template<typename I>
+            void insert(I first, I last) {
+                for (; first != last; ++first) {
+                    insert(*first);
+                }
+            }
+
+            // the items in this set that are not in the other one.
+            std::vector<item::base*> minus(const selection_set& other) const;
+        };
+
+        // what a change to a canvas's selection added to and removed from it.
+
+        struct selection_delta {
+            std::vector<item::base*> added;
+            std::vector<item::base*> removed;
+        };
+    }
+}
@@ -1,6 +1,8 @@
 #include "scene.h"
 #include "canvas_item.h"
 #include "skel_item.h"
+#include "node_item.h"
+#include "bone_item.h"
 #include "../util.h"
 #include "../../core/sm_skeleton.h"
 
@@ -12,14 +14,13 @@ namespace rv = std::ranges::views;
 namespace {
 
     constexpr auto k_skel_marg = 11.0;
+    constexpr auto k_lod_dot_radius = 2.0;
+    const auto k_impostor_color = QColor::fromRgb(160, 160, 160);
 
-    QRectF scale_rect(double scale, const QRectF r) {
-        return {
-            scale * r.topLeft().x(),
-            scale * r.topLeft().y(),
-            scale * r.width(),
-            scale * r.height()
-        };
+    QPen cosmetic_pen(const QColor& color, double width, Qt::PenStyle style = Qt::SolidLine) {
+        QPen pen(color, width, style);
+        pen.setCosmetic(true);
+        return pen;
     }
 
     QRectF inflate_rect(const QRectF& originalRect, qreal amnt)
@@ -32,12 +33,7 @@ namespace {
         return QRectF(x, y, width, height);
     }
 
-    QRectF skeleton_bounds(const sm::skeleton& skel) {
-        auto pts = skel.nodes() | rv::transform(
-            [](const sm::node& node)->sm::point {
-                return node.world_pos();
-            }
-        ) | r::to<std::vector<sm::point>>();
+    QRectF bounds_of(const std::vector<sm::point>& pts) {
         auto [min_x, max_x] = r::minmax(
             pts | rv::transform([](const auto& pt) {return pt.x; })
         );
@@ -51,18 +47,220 @@ namespace {
         };
     }
 
+    QRectF skeleton_bounds(const sm::skeleton& skel) {
+        return bounds_of(
+            skel.nodes() | rv::transform(
+                [](const sm::node& node)->sm::point {
+                    return node.world_pos();
+                }
+            ) | r::to<std::vector<sm::point>>()
+        );
+    }
+
+    // where a node is drawn: its item's position, which is the model's except while the
+    // canvas is showing a pose the model is not in.
+
+    QPointF drawn_pos(const ui::canvas::scene& canv, const sm::node& node) {
+        auto* ni = canv.item_of(node);
+        return ni ? ni->pos() : ui::to_qt_pt(node.world_pos());
+    }
+
 }
 
 /*------------------------------------------------------------------------------------------------*/
 
 void ui::canvas::item::skeleton::sync_item_to_model() {
-    QRectF rect = inflate_rect(skeleton_bounds(model_), k_skel_marg);
+    model_bounds_ = skeleton_bounds(*model_);
+    sync_to_scale();
+    setVisible(is_selected() || canvas()->is_batched());
+}
+
+// the frame's margin and the extent of the batched body are constant on screen, so unlike
+// node and bone items a skeleton item has to be resized when the view zooms. This only
+// inflates the bounds cached by the last sync.
+
+void ui::canvas::item::skeleton::sync_to_items() {
     auto& canv = *canvas();
-    double inv_scale = 1.0 / canv.scale();
-    setRect(
-        scale_rect(inv_scale, rect)
+    model_bounds_ = bounds_of(
+        model_->nodes() | rv::transform(
+            [&canv](const sm::node& node)->sm::point {
+                auto pt = drawn_pos(canv, node);
+                return { pt.x(), pt.y() };
+            }
+        ) | r::to<std::vector<sm::point>>()
     );
-    setVisible(is_selected());
+    sync_to_scale();
+}
+
+void ui::canvas::item::skeleton::sync_to_scale() {
+    double inv_scale = 1.0 / canvas()->scale();
+    setRect(inflate_rect(model_bounds_, k_skel_marg * inv_scale));
+
+    prepareGeometryChange();
+    body_bounds_ = inflate_rect(
+        model_bounds_, (k_node_radius + k_sel_frame_distance + k_sel_thickness) * inv_scale
+    );
+    is_body_stale_ = true;
+    update();
+}
+
+// when the canvas is rendering batched the node and bone items of the skeleton have no
+// contents and exist only to hold geometry and selection state; the skeleton item draws
+// all of them as two paths plus an overlay of selection frames and pins. How detailed the
+// paths are depends on how far out the canvas is zoomed.
+
+void ui::canvas::item::skeleton::build_body_paths(detail_level detail) {
+    auto inv_scale = 1.0 / canvas()->scale();
+    bones_path_ = {};
+    bones_path_.setFillRule(Qt::WindingFill);
+    nodes_path_ = {};
+    nodes_path_.setFillRule(Qt::WindingFill);
+
+    if (detail == detail_level::full) {
+        auto& canv = *canvas();
+        auto node_radius = k_node_radius * inv_scale;
+        for (auto bone : model_->bones()) {
+            if (auto* bi = canv.item_of(bone.get()); bi) {
+                bones_path_.addPolygon(bi->sceneTransform().map(bi->body_polygon()));
+            }
+        }
+        for (auto node : model_->nodes()) {
+            if (auto* ni = canv.item_of(node.get()); ni) {
+                nodes_path_.addEllipse(ni->pos(), node_radius, node_radius);
+            }
+        }
+        return;
+    }
+
+    const auto& canv = *canvas();
+    for (auto bone : model_->bones()) {
+        bones_path_.moveTo(drawn_pos(canv, bone->parent_node()));
+        bones_path_.lineTo(drawn_pos(canv, bone->child_node()));
+    }
+    if (detail == detail_level::simplified) {
+        auto dot_radius = k_lod_dot_radius * inv_scale;
+        for (auto node : model_->nodes()) {
+            nodes_path_.addEllipse(drawn_pos(canv, node.get()), dot_radius, dot_radius);
+        }
+    }
+}
+
+void ui::canvas::item::skeleton::paint_body(QPainter* painter) {
+    auto detail = canvas()->level_of_detail();
+    if (detail == detail_level::bounding_boxes) {
+        painter->setPen(cosmetic_pen(Qt::black, 1.0));
+        painter->setBrush(k_impostor_color);
+        painter->drawRect(model_bounds_);
+        return;
+    }
+
+    if (is_body_stale_) {
+        build_body_paths(detail);
+        is_body_stale_ = false;
+    }
+
+    if (detail == detail_level::full) {
+        painter->setPen(cosmetic_pen(Qt::black, 1.0));
+        painter->setBrush(Qt::black);
+        painter->drawPath(bones_path_);
+        painter->setPen(cosmetic_pen(Qt::black, 2.0));
+        painter->setBrush(Qt::white);
+        painter->drawPath(nodes_path_);
+        return;
+    }
+
+    painter->setPen(cosmetic_pen(Qt::black, 1.0));
+    painter->setBrush(Qt::NoBrush);
+    painter->drawPath(bones_path_);
+    if (!nodes_path_.isEmpty()) {
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(Qt::black);
+        painter->drawPath(nodes_path_);
+    }
+}
+
+void ui::canvas::item::skeleton::paint_overlay(QPainter* painter) {
+    auto& canv = *canvas();
+    auto inv_scale = 1.0 / canv.scale();
+    auto frame_radius = (k_node_radius + k_sel_frame_distance) * inv_scale;
+    auto pin_radius = k_pin_radius * inv_scale;
+
+    QPainterPath frames;
+    QPainterPath pins;
+    for (auto node : model_->nodes()) {
+        auto* ni = canv.item_of(node.get());
+        if (!ni) {
+            continue;
+        }
+        if (ni->is_selected()) {
+            frames.addEllipse(ni->pos(), frame_radius, frame_radius);
+        }
+        if (ni->is_pinned()) {
+            pins.addEllipse(ni->pos(), pin_radius, pin_radius);
+        }
+    }
+    for (auto bone : model_->bones()) {
+        auto* bi = canv.item_of(bone.get());
+        if (!bi) {
+            continue;
+        }
+        if (bi->is_selected()) {
+            auto line = bi->sceneTransform().map(QLineF(0, 0, bone->scaled_length(), 0));
+            frames.moveTo(line.p1());
+            frames.lineTo(line.p2());
+        }
+    }
+
+    if (!pins.isEmpty()) {
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(Qt::black);
+        painter->drawPath(pins);
+    }
+    if (!frames.isEmpty()) {
+        painter->setPen(cosmetic_pen(k_sel_color, k_sel_thickness, Qt::DotLine));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawPath(frames);
+    }
+}
+
+QRectF ui::canvas::item::skeleton::boundingRect() const {
+    auto bounds = QGraphicsRectItem::boundingRect();
+    auto* canv = canvas();
+    if (canv && canv->is_batched()) {
+        bounds = bounds.united(body_bounds_);
+    }
+    return bounds;
+}
+
+// a batched skeleton item is always visible, but it should only be hit by the cursor
+// where it would have been had it been rendered the usual way.
+
+QPainterPath ui::canvas::item::skeleton::shape() const {
+    auto* canv = canvas();
+    if (canv && canv->is_batched() && !is_selected()) {
+        return {};
+    }
+    return QGraphicsRectItem::shape();
+}
+
+void ui::canvas::item::skeleton::paint(QPainter* painter,
+        const QStyleOptionGraphicsItem* option, QWidget* widget) {
+    auto* canv = canvas();
+    if (canv && canv->is_batched()) {
+        paint_body(painter);
+        if (canv->level_of_detail() != detail_level::bounding_boxes) {
+            paint_overlay(painter);
+        }
+        if (!is_selected()) {
+            return;
+        }
+    }
+    QGraphicsRectItem::paint(painter, option, widget);
+}
+
+void ui::canvas::item::skeleton::rebind(sm::skeleton& skel) {
+    set_model(skel);
+    is_body_stale_ = true;
 }
 
 void ui::canvas::item::skeleton::sync_sel_frame_to_model() {
@@ -85,9 +283,10 @@ mdl::const_skel_piece ui::canvas::item::skeleton::to_skeleton_piece() const {
     return sm::const_skel_ref(skel);
 }
 
-ui::canvas::item::skeleton::skeleton(sm::skeleton& skel, double scale) :
-    has_stick_man_model<ui::canvas::item::skeleton, sm::skeleton&>(skel) {
-    setPen(QPen(Qt::cyan, 3, Qt::DotLine));
+ui::canvas::item::skeleton::skeleton(sm::skeleton& skel) :
+    has_stick_man_model<ui::canvas::item::skeleton, sm::skeleton&>(skel),
+    is_body_stale_(true) {
+    setPen(cosmetic_pen(Qt::cyan, 3, Qt::DotLine));
     setBrush(Qt::NoBrush);
     setVisible(false);
 }
@@ -5,22 +5,43 @@
 namespace ui {
 
     namespace canvas {
+        enum class detail_level;
+
         namespace item {
             class skeleton :
-                public has_treeview_item,
                 public has_stick_man_model<skeleton, sm::skeleton&>,
                 public QGraphicsRectItem {
             private:
+                QRectF model_bounds_;
+                QRectF body_bounds_;
+                bool is_body_stale_;
+                QPainterPath bones_path_;
+                QPainterPath nodes_path_;
+
                 void sync_item_to_model() override;
                 void sync_sel_frame_to_model() override;
                 QGraphicsItem* create_selection_frame() const override;
                 bool is_selection_frame_only() const override;
                 QGraphicsItem* item_body() override;
                 mdl::const_skel_piece to_skeleton_piece() const override;
+                void build_body_paths(detail_level detail);
+                void paint_body(QPainter* painter);
+                void paint_overlay(QPainter* painter);
 
             public:
                 using model_type = sm::skeleton;
-                skeleton(sm::skeleton& skel, double scale);
+                skeleton(sm::skeleton& skel);
+                void rebind(sm::skeleton& skel);
+                void sync_to_scale();
+
+                // recomputes the bounds from where the skeleton's node items are rather than
+                // from the model, for when the items are showing a pose the model is not in.
+                void sync_to_items();
+
+                QRectF boundingRect() const override;
+                QPainterPath shape() const override;
+                void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+                    QWidget* widget) override;
             };
         }
     }
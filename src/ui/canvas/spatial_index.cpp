@@ -0,0 +1,140 @@
+#include "spatial_index.h"
+#include <ranges>
+#include <algorithm>
+#include <iterator>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+namespace bg = boost::geometry;
+namespace bgi = boost::geometry::index;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    using point = bg::model::point<double, 2, bg::cs::cartesian>;
+    using box = bg::model::box<point>;
+
+    point to_bg_pt(const sm::point& pt) {
+        return { pt.x, pt.y };
+    }
+
+    box box_around(const sm::point& pt, double radius) {
+        return {
+            { pt.x - radius, pt.y - radius },
+            { pt.x + radius, pt.y + radius }
+        };
+    }
+
+    // orders query results nearest first and drops the ones farther away than the radius,
+    // which the rectangular query lets through at the corners.
+
+    template<typename T, typename V>
+    std::vector<T*> nearest_first(const std::vector<V>& values, const sm::point& pt, double radius) {
+        auto query_pt = to_bg_pt(pt);
+        std::vector<std::tuple<double, T*>> dist_and_item;
+        dist_and_item.reserve(values.size());
+        for (const auto& [geom, item] : values) {
+            auto dist = bg::distance(query_pt, geom);
+            if (dist <= radius) {
+                dist_and_item.emplace_back(dist, item);
+            }
+        }
+        r::sort(dist_and_item,
+            [](const auto& lhs, const auto& rhs) {
+                return std::get<0>(lhs) < std::get<0>(rhs);
+            }
+        );
+        return dist_and_item | rv::elements<1> | r::to<std::vector<T*>>();
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+void ui::canvas::spatial_index::insert(item::node* node, const sm::point& pt) {
+    remove(node);
+    auto loc = to_bg_pt(pt);
+    nodes_.insert({ loc, node });
+    node_locs_[node] = loc;
+}
+
+void ui::canvas::spatial_index::insert(item::bone* bone, const sm::point& u, const sm::point& v) {
+    remove(bone);
+    segment loc{ to_bg_pt(u), to_bg_pt(v) };
+    bones_.insert({ loc, bone });
+    bone_locs_[bone] = loc;
+}
+
+void ui::canvas::spatial_index::remove(item::node* node) {
+    auto iter = node_locs_.find(node);
+    if (iter == node_locs_.end()) {
+        return;
+    }
+    nodes_.remove(node_value{ iter->second, node });
+    node_locs_.erase(iter);
+}
+
+void ui::canvas::spatial_index::remove(item::bone* bone) {
+    auto iter = bone_locs_.find(bone);
+    if (iter == bone_locs_.end()) {
+        return;
+    }
+    bones_.remove(bone_value{ iter->second, bone });
+    bone_locs_.erase(iter);
+}
+
+void ui::canvas::spatial_index::clear() {
+    nodes_.clear();
+    bones_.clear();
+    node_locs_.clear();
+    bone_locs_.clear();
+}
+
+std::vector<ui::canvas::item::node*> ui::canvas::spatial_index::nodes_near(
+        const sm::point& pt, double radius) const {
+    std::vector<node_value> candidates;
+    nodes_.query(bgi::intersects(box_around(pt, radius)), std::back_inserter(candidates));
+    return nearest_first<item::node>(candidates, pt, radius);
+}
+
+std::vector<ui::canvas::item::bone*> ui::canvas::spatial_index::bones_near(
+        const sm::point& pt, double radius) const {
+    std::vector<bone_value> candidates;
+    bones_.query(bgi::intersects(box_around(pt, radius)), std::back_inserter(candidates));
+    return nearest_first<item::bone>(candidates, pt, radius);
+}
+
+std::vector<ui::canvas::item::node*> ui::canvas::spatial_index::nodes_in_rect(
+        const sm::point& min, const sm::point& max, double radius) const {
+    box rect{ { min.x - radius, min.y - radius }, { max.x + radius, max.y + radius } };
+    std::vector<node_value> values;
+    nodes_.query(bgi::intersects(rect), std::back_inserter(values));
+    return values | rv::elements<1> | r::to<std::vector<item::node*>>();
+}
+
+std::vector<ui::canvas::item::bone*> ui::canvas::spatial_index::bones_in_rect(
+        const sm::point& min, const sm::point& max) const {
+    box rect{ to_bg_pt(min), to_bg_pt(max) };
+    std::vector<bone_value> values;
+    bones_.query(bgi::intersects(rect), std::back_inserter(values));
+    return values | rv::elements<1> | r::to<std::vector<item::bone*>>();
+}
+
+ui::canvas::item::node* ui::canvas::spatial_index::nearest_node(
+        const sm::point& pt, double max_distance) const {
+    std::vector<node_value> nearest;
+    auto query_pt = to_bg_pt(pt);
+    nodes_.query(bgi::nearest(query_pt, 1), std::back_inserter(nearest));
+    if (nearest.empty() || bg::distance(query_pt, nearest.front().first) > max_distance) {
+        return nullptr;
+    }
+    return nearest.front().second;
+}
+
+std::vector<ui::canvas::item::node*> ui::canvas::spatial_index::nodes() const {
+    return node_locs_ | rv::keys | r::to<std::vector<item::node*>>();
+}
+
+std::vector<ui::canvas::item::bone*> ui::canvas::spatial_index::bones() const {
+    return bone_locs_ | rv::keys | r::to<std::vector<item::bone*>>();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../../core/sm_types.h"
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace ui {
+
+    namespace canvas {
+
+        namespace item {
+            class node;
+            class bone;
+        }
+
+        // An R-tree of node centers and bone segments in world coordinates, maintained
+        // incrementally as a canvas's items are inserted, moved, and deleted. How large a node
+        // or bone is in world coordinates depends on the zoom level, so queries take the
+        // radius to search within rather than the index storing extents.
+
+        class spatial_index {
+
+            using point = boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian>;
+            using box = boost::geometry::model::box<point>;
+            using segment = boost::geometry::model::segment<point>;
+            using node_value = std::pair<point, item::node*>;
+            using bone_value = std::pair<segment, item::bone*>;
+            using node_tree = boost::geometry::index::rtree<
+                node_value, boost::geometry::index::rstar<16>>;
+            using bone_tree = boost::geometry::index::rtree<
+                bone_value, boost::geometry::index::rstar<16>>;
+
+            node_tree nodes_;
+            bone_tree bones_;
+            std::unordered_map<item::node*, point> node_locs_;
+            std::unordered_map<item::bone*, segment> bone_locs_;
+
+        public:
+            void insert(item::node* node, const sm::point& pt);
+            void insert(item::bone* bone, const sm::point& u, const sm::point& v);
+            void remove(item::node* node);
+            void remove(item::bone* bone);
+            void clear();
+
+            std::vector<item::node*> nodes_near(const sm::point& pt, double radius) const;
+            std::vector<item::bone*> bones_near(const sm::point& pt, double radius) const;
+            std::vector<item::node*> nodes_in_rect(
+                const sm::point& min, const sm::point& max, double radius) const;
+            std::vector<item::bone*> bones_in_rect(
+                const sm::point& min, const sm::point& max) const;
+            item::node* nearest_node(const sm::point& pt, double max_distance) const;
+
+            std::vector<item::node*> nodes() const;
+            std::vector<item::bone*> bones() const;
+        };
+    }
+}
@@ -18,6 +18,10 @@
 #include <memory>
 #include <limits>
 #include <sstream>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -29,7 +33,8 @@ namespace {
 
     template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
 
-    static const QByteArray k_stickman_mime_type = "application/x-stick_man";
+    static const QString k_stickman_mime_type = "application/x-stick_man";
+    static const QString k_stickman_binary_mime_type = "application/x-stick_man-binary";
 
     class skeleton_piece_set {
         std::unordered_set<const void*> impl_;
@@ -138,14 +143,12 @@ namespace {
             for (auto skel_item : canv.skeleton_items()) {
                 auto& skel = skel_item->model();
                 bool skel_is_selected = r::all_of(skel.nodes(),
-                        [](sm::node_ref nr)->bool {
-                            auto& ni = ui::canvas::item_from_model<ui::canvas::item::node>(nr.get());
-                            return ni.is_selected();
+                        [&canv](sm::node_ref nr)->bool {
+                            return canv.item_of(nr.get())->is_selected();
                         }
                     ) && r::all_of(skel.bones(),
-                        [](sm::bone_ref br)->bool {
-                            auto& bi = ui::canvas::item_from_model<ui::canvas::item::bone>(br.get());
-                            return bi.is_selected();
+                        [&canv](sm::bone_ref br)->bool {
+                            return canv.item_of(br.get())->is_selected();
                         }
                     );
                 if (skel_is_selected) {
@@ -179,16 +182,14 @@ namespace {
             sm::visit_nodes_and_bones(
                 skel_ptr->root_node(),
                 [&](const sm::node& node)->sm::visit_result {
-                    auto& ni = ui::canvas::item_from_model<ui::canvas::item::node>(node);
                     pieces_and_sel_state.emplace_back(
-                        sm::ref(node), ni.is_selected()
+                        sm::ref(node), canv.item_of(node)->is_selected()
                     );
                     return sm::visit_result::continue_traversal;
                 },
                 [&](const sm::bone& bone)->sm::visit_result {
-                    auto& bi = ui::canvas::item_from_model<ui::canvas::item::bone>(bone);
                     pieces_and_sel_state.emplace_back(
-                        sm::ref(bone), bi.is_selected()
+                        sm::ref(bone), canv.item_of(bone)->is_selected()
                     );
                     return sm::visit_result::continue_traversal;
                 },
@@ -200,12 +201,12 @@ namespace {
     }
 
     // given a set of skeletons generate separate skeletons for each connected component
-    // of selected-ness or deselected-ness of the skeletons' nodes and bones. Since you
-    // cannot have a bone without its two nodes existing this will make duplicate
-    // nodes for connected components trees with raw bones for leaves, but this is what 
-    // we want. This is what representing arbitrary selections as skeletons entails. 
+    // of the skeletons' selected nodes and bones. Since you cannot have a bone without its
+    // two nodes existing this will make duplicate nodes for connected components trees with
+    // raw bones for leaves, but this is what we want. This is what representing arbitrary
+    // selections as skeletons entails. The unselected components are left where they are.
 
-    std::tuple<sm::world, sm::world> split_skeletons_by_selection( 
+    sm::world copy_selection(
             ui::canvas::scene& canv, const std::unordered_set<const sm::skeleton*>& skel_set) {
         auto pieces = skeleton_pieces_in_topological_order(canv, skel_set);
 
@@ -217,22 +218,20 @@ namespace {
         }
 
         skeleton_piece_set copied;
-        sm::world unselected;
         sm::world selected;
 
         for (auto [piece, is_selected] : pieces) {
-            if (copied.contains(piece)) {
+            if (!is_selected || copied.contains(piece)) {
                 continue;
             }
-            auto& dest_world = is_selected ? selected : unselected;
             std::visit(
                 overload{
                     [&](sm::const_skel_ref skel) {
                         copied.insert(skel);
                         auto new_skel = skel->copy_to(
-                            dest_world,
+                            selected,
                             mdl::unique_skeleton_name(
-                                skel->name(), dest_world.skeleton_names()
+                                skel->name(), selected.skeleton_names()
                             )
                         );
                         if (!new_skel) {
@@ -240,13 +239,44 @@ namespace {
                         }
                     },
                     [&](auto node_or_bone) {
-                        copy_connected_component(dest_world, node_or_bone, selection_set, copied);
+                        copy_connected_component(selected, node_or_bone, selection_set, copied);
                     }
                 },
                 piece
             );
         }
-        return { std::move(unselected), std::move(selected) };
+        return selected;
+    }
+
+    // the nodes and bones to delete for the current selection; a selected skeleton is
+    // deleted whole.
+
+    std::tuple<std::vector<mdl::handle>, std::vector<mdl::handle>> selected_pieces(
+            ui::canvas::scene& canv) {
+        std::vector<mdl::handle> nodes;
+        std::vector<mdl::handle> bones;
+        for (auto* itm : canv.selection()) {
+            std::visit(
+                overload{
+                    [&](sm::skel_ref skel) {
+                        for (auto node : skel->nodes()) {
+                            nodes.push_back(mdl::to_handle(node));
+                        }
+                        for (auto bone : skel->bones()) {
+                            bones.push_back(mdl::to_handle(bone));
+                        }
+                    },
+                    [&](sm::node_ref node) {
+                        nodes.push_back(mdl::to_handle(node));
+                    },
+                    [&](sm::bone_ref bone) {
+                        bones.push_back(mdl::to_handle(bone));
+                    }
+                },
+                itm->to_skeleton_piece()
+            );
+        }
+        return { std::move(nodes), std::move(bones) };
     }
 
     // returns the the set of skeletons that are either selected or contain at least one 
@@ -277,37 +307,279 @@ namespace {
         cut, copy, del
     };
 
-    json perform_op_on_selection(ui::stick_man& main_wnd, selection_operation op) {
-        auto& project = main_wnd.project();
-        auto& canv = main_wnd.canvases().active_canvas();
-        auto relavent_skels = relavent_skeleton_set(canv);
+    // the binary clipboard format: a header, a table of every distinct name, and then each
+    // skeleton as packed arrays, with names as indices into the table and bones referring to
+    // their nodes by index. It is only ever read back by this program, so values are written
+    // in native byte order.
 
-        auto [unselected, selected] = split_skeletons_by_selection(canv, relavent_skels);
+    constexpr char k_clipboard_magic[] = { 'S', 'M', 'C', '1' };
 
-        if (op == selection_operation::cut || op == selection_operation::del) {
-            auto replacees = relavent_skels | rv::transform(
-                    [](const auto* skel) {
-                        return skel->name();
-                    }
-                ) | r::to<std::vector<std::string>>();
-            auto replacements = unselected.skeletons() | r::to<std::vector<sm::skel_ref>>();
-            project.replace_skeletons(canv.tab_name(), replacees, replacements);
+    class payload_writer {
+        QByteArray buf_;
+
+    public:
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        void write(const T& val) {
+            buf_.append(reinterpret_cast<const char*>(&val), sizeof(T));
         }
 
-        if (op == selection_operation::cut || op == selection_operation::copy) {
-            return selected.to_json();
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        void write_array(const std::vector<T>& vec) {
+            write(static_cast<uint32_t>(vec.size()));
+            buf_.append(reinterpret_cast<const char*>(vec.data()), vec.size() * sizeof(T));
         }
 
-        return {};
+        void write(const std::string& str) {
+            write(static_cast<uint32_t>(str.size()));
+            buf_.append(str.data(), str.size());
+        }
+
+        QByteArray bytes() && {
+            return std::move(buf_);
+        }
+    };
+
+    class payload_reader {
+        const char* cur_;
+        const char* end_;
+
+        const char* take(size_t n) {
+            if (static_cast<size_t>(end_ - cur_) < n) {
+                throw std::runtime_error("truncated clipboard payload");
+            }
+            auto* p = cur_;
+            cur_ += n;
+            return p;
+        }
+
+    public:
+        payload_reader(const QByteArray& bytes) :
+            cur_(bytes.constData()), end_(bytes.constData() + bytes.size())
+        {}
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        T read() {
+            T val;
+            std::memcpy(&val, take(sizeof(T)), sizeof(T));
+            return val;
+        }
+
+        template<typename T> requires std::is_trivially_copyable_v<T>
+        std::vector<T> read_array() {
+            auto n = read<uint32_t>();
+            if (static_cast<size_t>(end_ - cur_) / sizeof(T) < n) {
+                throw std::runtime_error("truncated clipboard payload");
+            }
+            std::vector<T> vec(n);
+            std::memcpy(vec.data(), take(n * sizeof(T)), n * sizeof(T));
+            return vec;
+        }
+
+        std::string read_string() {
+            auto n = read<uint32_t>();
+            return std::string(take(n), n);
+        }
+    };
+
+    struct packed_constraint {
+        uint32_t bone;
+        uint32_t relative_to_parent;
+        double start_angle;
+        double span_angle;
+    };
+
+    QByteArray to_clipboard_bytes(const std::vector<sm::skeleton_snapshot>& skeletons) {
+        std::unordered_map<std::string_view, uint32_t> string_ids;
+        std::vector<std::string_view> strings;
+        auto intern = [&](const std::string& str)->uint32_t {
+            auto [iter, inserted] = string_ids.try_emplace(str, static_cast<uint32_t>(strings.size()));
+            if (inserted) {
+                strings.push_back(str);
+            }
+            return iter->second;
+        };
+        auto intern_all = [&](const std::vector<std::string>& names) {
+            return names | rv::transform(intern) | r::to<std::vector<uint32_t>>();
+        };
+
+        payload_writer body;
+        body.write(static_cast<uint32_t>(skeletons.size()));
+        for (const auto& skel : skeletons) {
+            body.write(intern(skel.name));
+            body.write(static_cast<uint32_t>(skel.root));
+            body.write_array(intern_all(skel.node_names));
+            body.write_array(skel.node_positions);
+            body.write_array(intern_all(skel.bone_names));
+
+            std::vector<uint32_t> bone_nodes;
+            bone_nodes.reserve(2 * skel.num_bones());
+            std::vector<packed_constraint> constraints;
+            for (size_t i = 0; i < skel.num_bones(); ++i) {
+                auto [u, v] = skel.bone_nodes[i];
+                bone_nodes.push_back(static_cast<uint32_t>(u));
+                bone_nodes.push_back(static_cast<uint32_t>(v));
+                if (const auto& rc = skel.bone_constraints[i]; rc) {
+                    constraints.push_back({
+                        static_cast<uint32_t>(i), rc->relative_to_parent ? 1u : 0u,
+                        rc->start_angle, rc->span_angle
+                    });
+                }
+            }
+            body.write_array(bone_nodes);
+            body.write_array(constraints);
+        }
+
+        payload_writer header;
+        header.write(k_clipboard_magic);
+        header.write(static_cast<uint32_t>(strings.size()));
+        for (auto str : strings) {
+            header.write(std::string(str));
+        }
+        return std::move(header).bytes() + std::move(body).bytes();
+    }
+
+    std::optional<std::vector<sm::skeleton_snapshot>> from_clipboard_bytes(
+            const QByteArray& bytes) {
+        try {
+            payload_reader rdr(bytes);
+            auto magic = rdr.read<std::array<char, sizeof(k_clipboard_magic)>>();
+            if (!r::equal(magic, k_clipboard_magic)) {
+                return {};
+            }
+            std::vector<std::string> strings(rdr.read<uint32_t>());
+            for (auto& str : strings) {
+                str = rdr.read_string();
+            }
+            auto names_of = [&strings](const std::vector<uint32_t>& ids) {
+                return ids | rv::transform(
+                        [&strings](uint32_t id) { return strings.at(id); }
+                    ) | r::to<std::vector<std::string>>();
+            };
+
+            std::vector<sm::skeleton_snapshot> skeletons(rdr.read<uint32_t>());
+            for (auto& skel : skeletons) {
+                skel.name = strings.at(rdr.read<uint32_t>());
+                skel.root = static_cast<int>(rdr.read<uint32_t>());
+                skel.node_names = names_of(rdr.read_array<uint32_t>());
+                skel.node_positions = rdr.read_array<sm::point>();
+                skel.bone_names = names_of(rdr.read_array<uint32_t>());
+                auto bone_nodes = rdr.read_array<uint32_t>();
+                auto constraints = rdr.read_array<packed_constraint>();
+
+                auto num_nodes = skel.num_nodes();
+                auto num_bones = skel.num_bones();
+                if (skel.node_positions.size() != num_nodes || bone_nodes.size() != 2 * num_bones ||
+                        skel.root < 0 || static_cast<size_t>(skel.root) >= num_nodes ||
+                        r::any_of(bone_nodes, [num_nodes](uint32_t i) { return i >= num_nodes; })) {
+                    return {};
+                }
+                skel.bone_nodes.reserve(num_bones);
+                for (size_t i = 0; i < num_bones; ++i) {
+                    skel.bone_nodes.emplace_back(bone_nodes[2 * i], bone_nodes[2 * i + 1]);
+                }
+                skel.bone_constraints.resize(num_bones);
+                for (const auto& rc : constraints) {
+                    skel.bone_constraints.at(rc.bone) = sm::rot_constraint{
+                        rc.relative_to_parent != 0, rc.start_angle, rc.span_angle
+                    };
+                }
+            }
+            return skeletons;
+        } catch (...) {
+            return {};
+        }
     }
 
-    QByteArray cut_or_copy_selection(ui::stick_man& main_wnd, selection_operation op) {
-        auto selection_json = perform_op_on_selection(main_wnd, op);
-        auto str = selection_json.dump(4);
+    // the json format is the one the world itself reads and writes.
+
+    QByteArray to_clipboard_json(const std::vector<sm::skeleton_snapshot>& skeletons) {
+        json world_json = {
+            {"version", 0.0},
+            {"skeletons", skeletons | rv::transform(&sm::skeleton_snapshot::to_json) | r::to<json>()}
+        };
+        auto str = world_json.dump();
         return QByteArray(str.c_str(), str.size());
     }
 
-    std::optional<sm::matrix> paste_matrix(std::optional<sm::point> target,const sm::world& world) {
+    std::optional<std::vector<sm::skeleton_snapshot>> from_clipboard_json(
+            const QByteArray& bytes) {
+        sm::world clipboard_world;
+        if (clipboard_world.from_json_str(bytes.toStdString()) != sm::result::success) {
+            return {};
+        }
+        return clipboard_world.skeletons() |
+            rv::transform(
+                [](auto skel) {
+                    return skel->snapshot();
+                }
+            ) | r::to<std::vector<sm::skeleton_snapshot>>();
+    }
+
+    // offers the binary payload up front and only renders the json one, which is much
+    // larger and slower to produce, if something actually asks for it.
+
+    class selection_mime_data : public QMimeData {
+        std::vector<sm::skeleton_snapshot> skeletons_;
+        QByteArray binary_;
+
+    public:
+        selection_mime_data(std::vector<sm::skeleton_snapshot>&& skeletons) :
+            skeletons_(std::move(skeletons)),
+            binary_(to_clipboard_bytes(skeletons_))
+        {}
+
+        QStringList formats() const override {
+            return { k_stickman_binary_mime_type, k_stickman_mime_type };
+        }
+
+        bool hasFormat(const QString& mime_type) const override {
+            return formats().contains(mime_type);
+        }
+
+    protected:
+        QVariant retrieveData(const QString& mime_type, QMetaType type) const override {
+            if (mime_type == k_stickman_binary_mime_type) {
+                return binary_;
+            }
+            if (mime_type == k_stickman_mime_type) {
+                return to_clipboard_json(skeletons_);
+            }
+            return {};
+        }
+    };
+
+    /*--------------------------------------------------------------------------------------------*/
+
+    std::vector<sm::skeleton_snapshot> perform_op_on_selection(
+            ui::stick_man& main_wnd, selection_operation op) {
+        auto& project = main_wnd.project();
+        auto& canv = main_wnd.canvases().active_canvas();
+        std::vector<sm::skeleton_snapshot> selection;
+
+        if (op == selection_operation::cut || op == selection_operation::copy) {
+            auto selected = copy_selection(canv, relavent_skeleton_set(canv));
+            selection = selected.skeletons() |
+                rv::transform(
+                    [](auto skel) {
+                        auto snapshot = skel->snapshot();
+                        snapshot.clear_ids();
+                        return snapshot;
+                    }
+                ) | r::to<std::vector<sm::skeleton_snapshot>>();
+        }
+
+        // what is left of the affected skeletons is split up in place by the project rather
+        // than rebuilt from copies.
+        if (op == selection_operation::cut || op == selection_operation::del) {
+            auto [nodes, bones] = selected_pieces(canv);
+            project.remove_pieces(canv.tab_name(), nodes, bones);
+        }
+
+        return selection;
+    }
+
+    std::optional<sm::point> paste_offset(std::optional<sm::point> target,
+            const std::vector<sm::skeleton_snapshot>& skeletons) {
         if (!target) {
             return {};
         }
@@ -316,52 +588,46 @@ namespace {
             std::numeric_limits<double>::max()
         };
 
-        auto pts = world.skeletons() |
-            rv::transform([](auto s) {return s->root_node().world_pos(); });
+        auto pts = skeletons |
+            rv::transform([](const auto& s) {return s.node_positions[s.root]; });
         for (auto pt : pts) {
             if (pt.y < lower_left.y || (pt.y == lower_left.y && pt.x < lower_left.x)) {
                 lower_left = pt;
             }
         }
-        return sm::translation_matrix(*target - lower_left);
+        return *target - lower_left;
     }
 
-    void paste_selection(ui::stick_man& main_wnd, const QByteArray& bytes, bool in_place) {
-        std::string world_json_str = std::string(bytes.data());
-        sm::world clipboard_world;
-        clipboard_world.from_json_str(world_json_str);
-
+    void paste_selection(ui::stick_man& main_wnd,
+            std::vector<sm::skeleton_snapshot>&& skeletons, bool in_place) {
         auto& canvases = main_wnd.canvases();
         auto& canv = canvases.active_canvas();
 
-        auto dest_mat = (!in_place) ? 
-            paste_matrix(canv.cursor_pos(), clipboard_world) :
-            std::optional<sm::matrix>{};
-        if (dest_mat) {
-            clipboard_world.apply( *dest_mat );
+        auto offset = (!in_place) ?
+            paste_offset(canv.cursor_pos(), skeletons) :
+            std::optional<sm::point>{};
+        if (offset) {
+            for (auto& skel : skeletons) {
+                for (auto& pos : skel.node_positions) {
+                    pos += *offset;
+                }
+            }
         }
 
         auto& project = main_wnd.project();
-        project.replace_skeletons(
-            canv.tab_name(),
-            {},
-            clipboard_world.skeletons() | r::to<std::vector<sm::skel_ref>>()
-        );
+        project.replace_skeletons(canv.tab_name(), {}, skeletons);
     }
 
     void cut_or_copy(ui::stick_man& main_wnd, bool should_cut) {
         QClipboard* clipboard = QApplication::clipboard();
-
-        QMimeData* mime_data = new QMimeData;
-        mime_data->setData(
-            k_stickman_mime_type, 
-            cut_or_copy_selection(
-                main_wnd,
-                should_cut ? selection_operation::cut : selection_operation::copy
+        clipboard->setMimeData(
+            new selection_mime_data(
+                perform_op_on_selection(
+                    main_wnd,
+                    should_cut ? selection_operation::cut : selection_operation::copy
+                )
             )
         );
-
-        clipboard->setMimeData(mime_data);
     }
 }
  
@@ -375,10 +641,16 @@ void ui::clipboard::copy(stick_man& main_wnd) {
 
 void ui::clipboard::paste(stick_man& main_wnd, bool in_place) {
     QClipboard* clipboard = QApplication::clipboard();
-    const QMimeData* mimeData = clipboard->mimeData();
-    if (mimeData->hasFormat(k_stickman_mime_type)) {
-        QByteArray bytes = mimeData->data(k_stickman_mime_type);
-        paste_selection(main_wnd, bytes, in_place);
+    const QMimeData* mime_data = clipboard->mimeData();
+    std::optional<std::vector<sm::skeleton_snapshot>> skeletons;
+    if (mime_data->hasFormat(k_stickman_binary_mime_type)) {
+        skeletons = from_clipboard_bytes(mime_data->data(k_stickman_binary_mime_type));
+    }
+    if (!skeletons && mime_data->hasFormat(k_stickman_mime_type)) {
+        skeletons = from_clipboard_json(mime_data->data(k_stickman_mime_type));
+    }
+    if (skeletons) {
+        paste_selection(main_wnd, std::move(*skeletons), in_place);
     }
 }
 
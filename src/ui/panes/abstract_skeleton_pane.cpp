@@ -34,17 +34,6 @@ void ui::pane::abstract_skeleton_pane::disconnect_canv_cont_handler() {
     disconnect(canv_content_conn_);
 }
 
-void ui::pane::abstract_skeleton_pane::connect_tree_change_handler() {
-    auto* model = static_cast<QStandardItemModel*>(skel_tree().model());
-    tree_conn_ = connect(model, &QStandardItemModel::itemChanged, this,
-        &abstract_skeleton_pane::handle_tree_change
-    );
-}
-
-void ui::pane::abstract_skeleton_pane::disconnect_tree_change_handler() {
-    disconnect(tree_conn_);
-}
-
 ui::pane::tree_view& ui::pane::abstract_skeleton_pane::skel_tree() {
     return const_cast<tree_view&>(
         static_cast<const abstract_skeleton_pane&>(*this).skel_tree()
@@ -71,7 +60,6 @@ void ui::pane::abstract_skeleton_pane::init(canvas::manager& canvases, mdl::proj
     connect_canv_cont_handler();
     connect_canv_sel_handler();
     connect_tree_sel_handler();
-    connect_tree_change_handler();
 
     init_aux(canvases, proj);
 }
@@ -11,6 +11,8 @@ namespace ui {
 
     namespace canvas {
         class manager;
+        class scene;
+        struct selection_delta;
     }
 
     namespace pane {
@@ -25,7 +27,6 @@ namespace ui {
             QLayout* layout_;
 
             QMetaObject::Connection tree_sel_conn_;
-            QMetaObject::Connection tree_conn_;
             QMetaObject::Connection canv_sel_conn_;
             QMetaObject::Connection canv_content_conn_;
 
@@ -38,16 +39,13 @@ namespace ui {
             void connect_canv_cont_handler();
             void disconnect_canv_cont_handler();
 
-            void connect_tree_change_handler();
-            void disconnect_tree_change_handler();
-
             tree_view& skel_tree();
             void populate();
 
             virtual const tree_view& skel_tree() const = 0;
             virtual QWidget* create_content(skeleton* parent) = 0;
-            virtual void handle_canv_sel_change() = 0;
-            virtual void handle_tree_change(QStandardItem* item) = 0;
+            virtual void handle_canv_sel_change(
+                canvas::scene& canv, const canvas::selection_delta& delta) = 0;
             virtual void handle_tree_selection_change(
                 const QItemSelection&, const QItemSelection&) = 0;
             virtual void sync_with_model(sm::world& model) = 0;
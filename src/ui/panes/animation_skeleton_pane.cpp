@@ -23,11 +23,8 @@ QWidget* ui::pane::animation_skeleton_pane::create_content(skeleton* parent)
     return skel_tree_ = new tree_view();
 }
 
-void ui::pane::animation_skeleton_pane::handle_canv_sel_change()
-{
-}
-
-void ui::pane::animation_skeleton_pane::handle_tree_change(QStandardItem* item)
+void ui::pane::animation_skeleton_pane::handle_canv_sel_change(
+    canvas::scene& canv, const canvas::selection_delta& delta)
 {
 }
 
@@ -17,8 +17,8 @@ namespace ui {
 
             const tree_view& skel_tree() const override;
             QWidget* create_content(skeleton* parent) override;
-            void handle_canv_sel_change() override;
-            void handle_tree_change(QStandardItem* item) override;
+            void handle_canv_sel_change(
+                canvas::scene& canv, const canvas::selection_delta& delta) override;
             void handle_tree_selection_change(
                 const QItemSelection&, const QItemSelection&) override;
             void sync_with_model(sm::world& model) override;
@@ -6,7 +6,6 @@
 #include "../canvas/skel_item.h"
 #include "../panes/skeleton_pane.h"
 #include "../panes/main_skeleton_pane.h"
-#include "../../core/sm_visit.h"
 #include <ranges>
 #include <functional>
 #include <numbers>
@@ -20,68 +19,32 @@ namespace {
     constexpr double k_default_rot_constraint_min = -std::numbers::pi / 2.0;
     constexpr double k_default_rot_constraint_span = std::numbers::pi;
 
+    // the selected bones, parents first; bulk edits only need each bone once, but the order
+    // keeps the journal's records of an edit the same from run to run.
+
+    std::vector<mdl::handle> selected_bone_handles(const ui::canvas::scene& canv) {
+        return mdl::to_handles(rv::all(canv.aggregates().bones_in_topological_order())) |
+            r::to<std::vector<mdl::handle>>();
+    }
+
     void set_rot_constraints(mdl::project& proj, ui::canvas::scene& canv,
             bool is_parent_relative, double start, double span) {
-        proj.transform(
-            mdl::to_handles(ui::canvas::to_model_ptrs(canv.selected_bones())) |
-            r::to<std::vector<mdl::handle>>(),
-            [=](sm::bone& bone) {
-                bone.set_rotation_constraint(start, span, is_parent_relative);
-            }
+        proj.edit_bones(
+            selected_bone_handles(canv),
+            mdl::constraint_edit{ sm::rot_constraint{ is_parent_relative, start, span } }
         );
     }
 
     void remove_rot_constraints(mdl::project& proj, ui::canvas::scene& canv) {
-        proj.transform(
-            mdl::to_handles(ui::canvas::to_model_ptrs(canv.selected_bones())) |
-            r::to<std::vector<mdl::handle>>(),
-            [=](sm::bone& bone) {
-                bone.remove_rotation_constraint();
-            }
-        );
-    }
-
-    std::vector<sm::bone*> topological_sort_selected_bones(ui::canvas::scene& canv) {
-        auto bone_items = canv.selected_bones();
-        std::unordered_set<sm::bone*> selected = ui::canvas::to_model_ptrs(bone_items) |
-            r::to< std::unordered_set<sm::bone*>>();
-        std::vector<sm::bone*> ordered_bones;
-        auto skeletons = canv.skeleton_items();
-
-        for (auto skel_item : skeletons) {
-            auto& skel = skel_item->model();
-            sm::visit_bones(skel.root_node(),
-                [&](auto& bone)->sm::visit_result {
-                    if (selected.contains(&bone)) {
-                        ordered_bones.push_back(&bone);
-                    }
-                    return sm::visit_result::continue_traversal;
-                }
-            );
-        }
-
-        return ordered_bones;
+        proj.edit_bones(selected_bone_handles(canv), mdl::constraint_edit{});
     }
 
     void set_selected_bone_length(mdl::project& proj, ui::canvas::scene& canv, double new_length) {
-        auto ordered = topological_sort_selected_bones(canv);
-        proj.transform(
-            mdl::to_handles(rv::all(ordered)) | r::to<std::vector<mdl::handle>>(),
-            [new_length](sm::bone_ref bone) {
-                bone->set_length(new_length);
-            }
-        );
+        proj.edit_bones(selected_bone_handles(canv), mdl::length_edit{ new_length });
     }
 
     void set_selected_bone_rotation(mdl::project& proj, ui::canvas::scene& canv, double theta) {
-        auto ordered = topological_sort_selected_bones(canv);
-        // sort bones into topological order and then set world rotation...
-        proj.transform(
-            mdl::to_handles(rv::all(ordered)) | r::to<std::vector<mdl::handle>>(),
-            [theta](sm::bone_ref bone) {
-                bone->set_world_rotation(theta);
-            }
-        );
+        proj.edit_bones(selected_bone_handles(canv), mdl::rotation_edit{ theta });
     }
 }
 
@@ -120,14 +83,12 @@ namespace ui {
                     auto span_angle = is_start_angle ? constraint_span_angle() : theta;
                     set_rot_constraints(proj, canv,
                         is_constraint_relative_to_parent(), start_angle, span_angle);
-                    canv.sync_to_model();
                 }
 
                 void set_constraint_mode(mdl::project& proj, ui::canvas::scene& canv, bool relative_to_parent) {
                     set_rot_constraints(proj, canv,
                         relative_to_parent, constraint_start_angle(), constraint_span_angle()
                     );
-                    canv.sync_to_model();
                 }
 
                 void showEvent(QShowEvent* event) override
@@ -198,10 +159,10 @@ namespace ui {
                         return;
                     }
                     sm::bone& bone = bones.front()->model();
-                    auto& node_itm = ui::canvas::item_from_model<ui::canvas::item::node>(
+                    auto* node_itm = canv.item_of(
                         (parent_node) ? bone.parent_node() : bone.child_node()
                     );
-                    canv.set_selection(&node_itm, true);
+                    canv.set_selection(node_itm, true);
                     };
             }
 
@@ -265,7 +226,6 @@ void ui::pane::props::bones::add_or_delete_constraint(mdl::project& proj, ui::ca
         remove_rot_constraints(proj, canv);
         constraint_box_->hide();
     }
-    get_current_canv_().sync_to_model();
 }
 
 ui::pane::props::bones::bones(const current_canvas_fn& fn, selection_properties* parent) :
@@ -360,19 +320,14 @@ void ui::pane::props::bones::populate(mdl::project& proj) {
 }
 
 bool ui::pane::props::bones::is_multi(const ui::canvas::scene& canv) {
-    return canv.selected_bones().size() > 1;
+    return canv.aggregates().bone_count() > 1;
 }
 
 void ui::pane::props::bones::set_selection_common(const ui::canvas::scene& canv) {
-    const auto& sel = canv.selection();
-    auto bones = ui::canvas::to_model_ptrs(ui::as_range_view_of_type<ui::canvas::item::bone>(sel));
-    auto length = get_unique_val(bones |
-        rv::transform([](sm::bone* b) {return b->scaled_length(); }));
-    length_->num_edit()->set_value(length);
-
-    auto world_rot = get_unique_val(bones |
-        rv::transform([](sm::bone* b) {return b->world_rotation(); }));
-    rotation_->set_value(0, world_rot.transform(ui::radians_to_degrees));
+    const auto& aggregates = canv.aggregates();
+    length_->num_edit()->set_value(aggregates.bone_length().common());
+    rotation_->set_value(0,
+        aggregates.bone_rotation().common().transform(ui::radians_to_degrees));
 }
 
 void ui::pane::props::bones::set_selection_multi(const ui::canvas::scene& canv) {
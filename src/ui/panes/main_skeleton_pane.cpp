@@ -29,6 +29,8 @@ namespace rv = std::ranges::views;
 
 namespace {
 
+	template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
+
 	template <typename T>
 	struct item_for_model;
 
@@ -48,38 +50,6 @@ namespace {
 	};
 
 	constexpr int k_treeview_max_hgt = 300;
-	const int k_is_bone_role = Qt::UserRole + 1;
-	const int k_model_role = Qt::UserRole + 2;
-
-	bool is_bone_treeitem(QStandardItem* qsi) {
-		return qsi->data(k_is_bone_role).value<bool>();
-	}
-
-	void set_treeitem_data(QStandardItem* qsi, sm::skeleton& skel) {
-		qsi->setData(QVariant::fromValue(false), k_is_bone_role);
-		qsi->setData(QVariant::fromValue(&skel), k_model_role);
-	}
-
-	void set_treeitem_data(QStandardItem* qsi, sm::bone& bone) {
-		qsi->setData(QVariant::fromValue(true), k_is_bone_role);
-		qsi->setData(QVariant::fromValue(&bone), k_model_role);
-	}
-
-	template<typename T>
-	T* get_treeitem_data(QStandardItem* qsi) {
-		return qsi->data(k_model_role).value<T*>();
-	}
-
-	mdl::skel_piece get_treeitem_var(QStandardItem* qsi) {
-		if (is_bone_treeitem(qsi)) {
-			auto* bone = get_treeitem_data<sm::bone>(qsi);
-			return { sm::ref(*bone) };
-		}
-		else {
-			auto* skeleton = get_treeitem_data<sm::skeleton>(qsi);
-			return { sm::ref(*skeleton) };
-		}
-	}
 
 	struct constraint_dragging_info {
 		QPointF axis;
@@ -89,74 +59,6 @@ namespace {
 		double radius;
 	};
 
-	QStandardItem* make_treeitem(sm::bone& bone) {
-		auto* itm = new QStandardItem(bone.name().c_str());
-		auto& bi = ui::canvas::item_from_model<ui::canvas::item::bone>(bone);
-		set_treeitem_data(itm, bone);
-		bi.set_treeview_item(itm);
-		return itm;
-	}
-
-	QStandardItem* make_treeitem(sm::skeleton& skel) {
-
-		auto* itm = new QStandardItem(skel.name().c_str());
-		ui::canvas::item::skeleton* canv_item = nullptr;
-		canv_item = &ui::canvas::item_from_model<ui::canvas::item::skeleton>(skel);
-		set_treeitem_data(itm, skel);
-		canv_item->set_treeview_item(itm);
-
-		return itm;
-	}
-
-	void insert_skeleton(QStandardItemModel* tree, sm::skel_ref skel) {
-
-		// traverse the skeleton graph and repopulate the treeview during the traversal 
-		// by building a hash table mapping bones to their tree items.
-
-		QStandardItem* root = tree->invisibleRootItem();
-		QStandardItem* skel_item = make_treeitem(skel.get());
-		root->appendRow(skel_item);
-
-		std::unordered_map<sm::bone*, QStandardItem*> bone_to_tree_item;
-		auto visit = [&](sm::bone& b)->sm::visit_result {
-			auto parent = b.parent_bone();
-			QStandardItem* bone_row = make_treeitem(b);
-			QStandardItem* parent_item =
-				(!parent) ? skel_item : bone_to_tree_item.at(&parent->get());
-			parent_item->appendRow(bone_row);
-			bone_to_tree_item[&b] = bone_row;
-			return sm::visit_result::continue_traversal;
-			};
-
-		sm::visit_bones(skel->root_node(), visit);
-	}
-
-	bool is_same_bone_selection(const std::vector<ui::canvas::item::bone*>& canv_sel,
-		const std::vector<QStandardItem*>& tree_sel) {
-		if (canv_sel.size() != tree_sel.size()) {
-			return false;
-		}
-		auto canv_set = canv_sel | rv::transform(
-			[](auto* bi)->QStandardItem* {
-				return bi->treeview_item();
-			}
-		) | r::to<std::unordered_set<QStandardItem*>>();
-
-		auto tree_set = tree_sel | r::to<std::unordered_set<QStandardItem*>>();
-		for (auto* i : canv_set) {
-			if (!tree_set.contains(i)) {
-				return false;
-			}
-		}
-		for (auto* i : tree_set) {
-			if (!canv_set.contains(i)) {
-				return false;
-			}
-		}
-
-		return true;
-	}
-
 	// if the selection is all in one canvas return as is; otherwise, remove all
 	// items that are not on the active canvas.
 
@@ -180,18 +82,44 @@ namespace {
 			) | r::to< std::vector<ui::canvas::item::base*>>();
 	}
 
-	void expand_item(QStandardItem* item, QTreeView* treeView) {
-		if (!item || !treeView) {
+	void expand_item(const QModelIndex& index, QTreeView* treeView) {
+		if (!index.isValid() || !treeView) {
 			return;
 		}
 
-		QModelIndex index = item->index();
-		while (index.isValid()) {
-			treeView->setExpanded(index, true);
-			index = index.parent();
+		QModelIndex ancestor = index;
+		while (ancestor.isValid()) {
+			treeView->setExpanded(ancestor, true);
+			ancestor = ancestor.parent();
 		}
 
-		treeView->scrollTo(item->index(), QAbstractItemView::PositionAtCenter);
+		treeView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+	}
+
+	// nodes have no rows in the tree.
+
+	QModelIndex tree_index_of(const ui::pane::skeleton_tree_model& model,
+			ui::canvas::item::base* canv_itm) {
+		return std::visit(
+			overload{
+				[](sm::node_ref)->QModelIndex { return {}; },
+				[&model](auto ref)->QModelIndex { return model.index_of(ref.get()); }
+			},
+			canv_itm->to_skeleton_piece()
+		);
+	}
+
+	template<typename R>
+	QItemSelection to_tree_selection(const ui::pane::skeleton_tree_model& model,
+			const R& canv_items) {
+		QItemSelection selection;
+		for (auto* canv_itm : canv_items) {
+			auto index = tree_index_of(model, canv_itm);
+			if (index.isValid()) {
+				selection.select(index, index);
+			}
+		}
+		return selection;
 	}
 }
 
@@ -212,31 +140,21 @@ void ui::pane::main_skeleton_pane::expand_selected_items() {
 	}
 }
 
+// the tree model follows the project's changes itself, so all a canvas refresh means here
+// is that the tree's selection has to follow the canvas's again.
+
 void ui::pane::main_skeleton_pane::sync_with_model(sm::world& model)
 {
-	disconnect_tree_sel_handler();
-
-	// clear the treeview and repopulate it.
-	QStandardItemModel* tree_model = static_cast<QStandardItemModel*>(skeleton_tree_->model());
-	tree_model->clear();
-
-	for (const auto& skel : model.skeletons()) {
-		insert_skeleton(tree_model, skel);
-	}
+	sync_tree_selection();
+}
 
-	skeleton_tree_->clearSelection();
+void ui::pane::main_skeleton_pane::sync_tree_selection() {
+	disconnect_tree_sel_handler();
 
-	//sync the new treeview selection state with the selected bones in the canvas.
-	auto selected_tree_items = canvas().selection() | rv::filter(
-		[](auto* aci)->bool {
-			return aci->is_selected() && dynamic_cast<canvas::item::has_treeview_item*>(aci);
-		}
-	) | rv::transform(
-		[](auto* aci)->QStandardItem* {
-			return  dynamic_cast<canvas::item::has_treeview_item*>(aci)->treeview_item();
-		}
-	) | r::to<std::vector<QStandardItem*>>();
-	select_items(selected_tree_items, true);
+	skeleton_tree_->selectionModel()->select(
+		to_tree_selection(*tree_model_, canvas().selection()),
+		QItemSelectionModel::ClearAndSelect
+	);
 	expand_selected_items();
 
 	connect_tree_sel_handler();
@@ -250,32 +168,36 @@ void ui::pane::main_skeleton_pane::handle_tree_selection_change(
 
 	auto& curr_canv = canvas();
 	std::vector<canvas::item::base*> sel_canv_items;
-	auto selection = selected_items();
-	QStandardItem* selected_skel = nullptr;
+	auto* selection_model = skeleton_tree_->selectionModel();
+	auto selection = selection_model->selectedIndexes();
+	QModelIndex selected_skel;
 
-	for (auto* qsi : selection) {
-		if (!is_bone_treeitem(qsi)) {
-			selected_skel = qsi;
+	for (const auto& index : selection) {
+		if (tree_model_->skeleton_at(index)) {
+			selected_skel = index;
 			break;
 		}
 	}
 
-	if (selected_skel) {
-		skeleton_tree_->selectionModel()->clearSelection();
-		select_item(selected_skel, true);
-		sel_canv_items.push_back(
-			&canvas::item_from_model<canvas::item::skeleton>(
-				*get_treeitem_data<sm::skeleton>(selected_skel)
-			)
-		);
+	if (selected_skel.isValid()) {
+		selection_model->select(selected_skel, QItemSelectionModel::ClearAndSelect);
+		expand_item(selected_skel, skeleton_tree_);
+		auto& skel = *tree_model_->skeleton_at(selected_skel);
+		if (auto* canv = canvases_->canvas_of(skel); canv) {
+			sel_canv_items.push_back(canv->item_of(skel));
+		}
 	}
 	else {
-		for (auto* sel : selection) {
-			sm::bone* bone_ptr = get_treeitem_data<sm::bone>(sel);
-			sel_canv_items.push_back(&canvas::item_from_model<canvas::item::bone>(*bone_ptr));
+		for (const auto& index : selection) {
+			sm::bone* bone_ptr = tree_model_->bone_at(index);
+			auto* canv = bone_ptr ? canvases_->canvas_of(bone_ptr->owner()) : nullptr;
+			if (canv) {
+				sel_canv_items.push_back(canv->item_of(*bone_ptr));
+			}
 		}
-		normalize_selection_per_active_canvas(sel_canv_items, curr_canv);
+		sel_canv_items = normalize_selection_per_active_canvas(sel_canv_items, curr_canv);
 	}
+	std::erase(sel_canv_items, nullptr);
 
 	if (!sel_canv_items.empty()) {
 		auto& sel_canv = *sel_canv_items.front()->canvas();
@@ -289,121 +211,33 @@ void ui::pane::main_skeleton_pane::handle_tree_selection_change(
 	connect_tree_sel_handler();
 }
 
-void ui::pane::main_skeleton_pane::traverse_tree_items(const std::function<void(QStandardItem*)>& callback_visitor) {
-	auto& model = *(static_cast<QStandardItemModel*>(skeleton_tree_->model()));
-
-	auto visit_item = [&](this auto&& self, QStandardItem* itm)->void {
-		callback_visitor(itm);
-		if (itm->hasChildren()) {
-			for (int subrow = 0; subrow < itm->rowCount(); ++subrow) {
-				QStandardItem* subItem = itm->child(subrow);
-				self(subItem);
-			}
-		}
-		};
-
-	for (int row = 0; row < model.rowCount(); ++row) {
-		QStandardItem* item = model.item(row);
-		visit_item(item);
-	}
-}
+// the tree's selection is updated by the canvas selection's delta, as one selection
+// change each for what was removed and what was added, rather than rebuilt item by item.
 
-void ui::pane::main_skeleton_pane::handle_rename(mdl::skel_piece piece, const std::string& new_name) {
-	if (std::holds_alternative<sm::node_ref>(piece)) {
-		return;
-	}
-	traverse_tree_items(
-		[&](QStandardItem* itm)->void {
-			auto itm_piece = get_treeitem_var(itm);
-			if (mdl::identical_pieces(piece, itm_piece)) {
-				auto curr_name = itm->text().toStdString();
-				if (curr_name != new_name) {
-					itm->setText(new_name.c_str());
-				}
-			}
-		}
-	);
-}
-
-void ui::pane::main_skeleton_pane::select_item(QStandardItem* item, bool select = true) {
-
-	expand_item(item, skeleton_tree_);
-
-	QStandardItemModel* model = qobject_cast<QStandardItemModel*>(skeleton_tree_->model());
-	if (!model) {
-		return;
-	}
-
-	QModelIndex index = model->indexFromItem(item);
-	if (!index.isValid()) {
-		return;
-	}
+void ui::pane::main_skeleton_pane::handle_canv_sel_change(
+		canvas::scene& canv, const canvas::selection_delta& delta) {
 
-	QItemSelectionModel* selectionModel = skeleton_tree_->selectionModel();
-	if (!selectionModel) {
-		return;
-	}
+	disconnect_tree_sel_handler();
 
-	QItemSelection selection(index, index);
-	selectionModel->select(
-		selection,
-		(select) ? QItemSelectionModel::Select : QItemSelectionModel::Deselect
+	auto* selection_model = skeleton_tree_->selectionModel();
+	selection_model->select(
+		to_tree_selection(*tree_model_, delta.removed), QItemSelectionModel::Deselect
 	);
 
-}
-
-
-void ui::pane::main_skeleton_pane::select_items(const std::vector<QStandardItem*>& items, bool emit_signal) {
-	if (!emit_signal) {
-		disconnect_tree_sel_handler();
-	}
-	skeleton_tree_->selectionModel()->clearSelection();
-	for (auto* itm : items) {
-		select_item(itm);
-	}
-	if (!emit_signal) {
-		connect_tree_sel_handler();
-	}
-}
-
-void ui::pane::main_skeleton_pane::handle_canv_sel_change() {
-
-	disconnect_tree_sel_handler();
-
-	skeleton_tree_->clearSelection();
-	for (canvas::item::base* canv_itm : canvas().selection()) {
-		auto* treeitem_holder = dynamic_cast<canvas::item::has_treeview_item*>(canv_itm);
-		if (treeitem_holder) {
-			select_item(treeitem_holder->treeview_item(), true);
+	auto added = to_tree_selection(*tree_model_, delta.added);
+	for (const auto& range : added) {
+		auto parent = range.parent();
+		while (parent.isValid()) {
+			skeleton_tree_->setExpanded(parent, true);
+			parent = parent.parent();
 		}
 	}
-
-	connect_tree_sel_handler();
-}
-
-void ui::pane::main_skeleton_pane::handle_tree_change(QStandardItem* item) {
-	auto piece = get_treeitem_var(item);
-	auto old_name = std::visit([](auto p) {return p->name(); }, piece);
-	auto result = project_->rename(piece, item->text().toStdString());
-	if (!result) {
-		item->setText(old_name.c_str());
-	}
-}
-
-std::vector<QStandardItem*> ui::pane::main_skeleton_pane::selected_items() const {
-	std::vector<QStandardItem*> selection;
-	QItemSelectionModel* sel_model = skeleton_tree_->selectionModel();
-	QModelIndexList selectedIndexes = sel_model->selectedIndexes();
-	auto* model = static_cast<QStandardItemModel*>(skeleton_tree_->model());
-
-	for (const QModelIndex& index : selectedIndexes) {
-		QStandardItem* item = model->itemFromIndex(index);
-		if (item) {
-			selection.push_back(item);
-		}
+	selection_model->select(added, QItemSelectionModel::Select);
+	if (!added.empty()) {
+		expand_item(added.front().topLeft(), skeleton_tree_);
 	}
 
-	return selection;
+	connect_tree_sel_handler();
 }
 
 ui::canvas::scene& ui::pane::main_skeleton_pane::canvas() {
@@ -420,6 +254,7 @@ QWidget* ui::pane::main_skeleton_pane::create_content(skeleton* parent) {
 	splitter->addWidget(
 		skeleton_tree_ = new tree_view()
 	);
+	skeleton_tree_->setModel(tree_model_ = new skeleton_tree_model(skeleton_tree_));
 	splitter->addWidget(
 		sel_properties_ = new selection_properties(
 			[this]()->ui::canvas::scene& {
@@ -433,6 +268,8 @@ QWidget* ui::pane::main_skeleton_pane::create_content(skeleton* parent) {
 
 ui::pane::main_skeleton_pane::main_skeleton_pane(ui::pane::skeleton* parent, ui::stick_man* mw) :
 	abstract_skeleton_pane(parent),
+	skeleton_tree_(nullptr),
+	tree_model_(nullptr),
 	main_wnd_(mw) {
 	
 }
@@ -443,7 +280,9 @@ ui::pane::selection_properties& ui::pane::main_skeleton_pane::sel_properties() {
 
 void ui::pane::main_skeleton_pane::init_aux(canvas::manager& canvases, mdl::project& proj) {
 	sel_properties_->init(canvases, proj);
-	connect(project_, &mdl::project::name_changed, this, &main_skeleton_pane::handle_rename);
+	tree_model_->init(proj);
+	connect(tree_model_, &QAbstractItemModel::modelReset,
+		this, &main_skeleton_pane::sync_tree_selection);
 }
 
 bool ui::pane::main_skeleton_pane::validate_props_name_change(const std::string& new_name) {
@@ -7,6 +7,7 @@
 #include "../../core/sm_types.h"
 #include "properties.h"
 #include "tree_view.h"
+#include "skeleton_tree_model.h"
 #include <functional>
 
 /*------------------------------------------------------------------------------------------------*/
@@ -27,21 +28,18 @@ namespace ui {
             friend class skeleton;
 
             tree_view* skeleton_tree_;
+            skeleton_tree_model* tree_model_;
             selection_properties* sel_properties_;
             ui::stick_man* main_wnd_;
 
             void expand_selected_items();
-            void handle_rename(mdl::skel_piece piece, const std::string& new_name);
-            void traverse_tree_items(const std::function<void(QStandardItem*)>& visitor);
-            std::vector<QStandardItem*> selected_items() const;
+            void sync_tree_selection();
             canvas::scene& canvas();
-            void select_item(QStandardItem* item, bool select);
-            void select_items(const std::vector<QStandardItem*>& items, bool emit_signal = true);
 
             const tree_view& skel_tree() const override;
             QWidget* create_content(skeleton* parent) override;
-            void handle_canv_sel_change() override;
-            void handle_tree_change(QStandardItem* item) override;
+            void handle_canv_sel_change(
+                canvas::scene& canv, const canvas::selection_delta& delta) override;
             void handle_tree_selection_change( 
                 const QItemSelection&, const QItemSelection&) override;
             void sync_with_model(sm::world& model) override;
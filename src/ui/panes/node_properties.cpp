@@ -128,7 +128,6 @@ void ui::pane::props::nodes::populate(mdl::project& proj) {
                     }
                 );
             }
-            canv.sync_to_model();
         }
     );
 
@@ -140,15 +139,9 @@ void ui::pane::props::nodes::populate(mdl::project& proj) {
 }
 
 void ui::pane::props::nodes::set_selection_common(const ui::canvas::scene& canv) {
-    const auto& sel = canv.selection();
-    auto nodes = ui::canvas::to_model_ptrs(ui::as_range_view_of_type<ui::canvas::item::node>(sel));
-    auto x_pos = ui::get_unique_val(nodes |
-        rv::transform([](sm::node* n) {return n->world_x(); }));
-    auto y_pos = ui::get_unique_val(nodes |
-        rv::transform([](sm::node* n) {return n->world_y(); }));
-
-    positions_->set_value(0, x_pos);
-    positions_->set_value(1, y_pos);
+    const auto& aggregates = canv.aggregates();
+    positions_->set_value(0, aggregates.node_x().common());
+    positions_->set_value(1, aggregates.node_y().common());
 }
 
 void ui::pane::props::nodes::set_selection_single(const ui::canvas::scene& canv) {
@@ -164,7 +157,7 @@ void ui::pane::props::nodes::set_selection_multi(const ui::canvas::scene& canv)
 }
 
 bool ui::pane::props::nodes::is_multi(const ui::canvas::scene& canv) {
-    return canv.selected_nodes().size() > 1;
+    return canv.aggregates().node_count() > 1;
 }
 
 void ui::pane::props::nodes::lose_selection() {
@@ -25,8 +25,11 @@ namespace rv = std::ranges::views;
 
 namespace {
 
-	ui::selection_type type_of_selection(const ui::canvas::selection_set& sel) {
+	// the canvas's selection aggregates already count the selected nodes and bones, so
+	// the selection itself is only looked at when it is a lone skeleton.
 
+	ui::selection_type type_of_selection(const ui::canvas::scene& canv) {
+		const auto& sel = canv.selection();
 		if (sel.empty()) {
 			return ui::selection_type::none;
 		}
@@ -35,14 +38,10 @@ namespace {
 			return ui::selection_type::skeleton;
 		}
 
-		bool has_node = false;
-		bool has_bone = false;
-		for (auto itm_ptr : sel) {
-			has_node = dynamic_cast<ui::canvas::item::node*>(itm_ptr) || has_node;
-			has_bone = dynamic_cast<ui::canvas::item::bone*>(itm_ptr) || has_bone;
-			if (has_node && has_bone) {
-				return ui::selection_type::mixed;
-			}
+		bool has_node = canv.aggregates().node_count() > 0;
+		bool has_bone = canv.aggregates().bone_count() > 0;
+		if (has_node && has_bone) {
+			return ui::selection_type::mixed;
 		}
 		return has_node ? ui::selection_type::node : ui::selection_type::bone;
 	}
@@ -87,7 +86,7 @@ void ui::pane::selection_properties::set(const ui::canvas::scene& canv) {
 	auto* old_props = current_props();
 
     QScrollArea* scroller = nullptr;
-    QWidget* widg = props_.at(type_of_selection(canv.selection()));
+    QWidget* widg = props_.at(type_of_selection(canv));
     while (scroller == nullptr) {
         scroller = dynamic_cast<QScrollArea*>(widg);
         widg = widg->parentWidget();
@@ -99,11 +98,6 @@ void ui::pane::selection_properties::set(const ui::canvas::scene& canv) {
 
 	old_props->lose_selection();
 	current_props()->set_selection(canv);
-
-	auto bone_items = ui::as_range_view_of_type<ui::canvas::item::bone>(canv.selection());
-	for (ui::canvas::item::bone* bi : bone_items) {
-		auto* tvi = bi->treeview_item();
-	}
 }
 
 void ui::pane::selection_properties::handle_selection_changed(canvas::scene& canv) {
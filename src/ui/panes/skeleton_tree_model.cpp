@@ -0,0 +1,328 @@
+#include "skeleton_tree_model.h"
+#include "../../core/sm_skeleton.h"
+#include "../../core/sm_bone.h"
+#include <ranges>
+#include <algorithm>
+#include <variant>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
+
+    // an index's internal id packs the id of the piece it stands for, with the top bit telling
+    // bones from skeletons. Generations never get anywhere near that bit, and an index whose
+    // piece has since been deleted simply fails to resolve.
+
+    static_assert(sizeof(quintptr) >= sizeof(uint64_t));
+    constexpr quintptr k_bone_flag = quintptr{ 1 } << 63;
+
+    quintptr to_internal_id(sm::piece_id id, bool is_bone) {
+        return (static_cast<quintptr>(id.generation) << 32) | id.index |
+            (is_bone ? k_bone_flag : 0);
+    }
+
+    bool is_bone_id(quintptr internal_id) {
+        return (internal_id & k_bone_flag) != 0;
+    }
+
+    sm::piece_id to_piece_id(quintptr internal_id) {
+        return {
+            static_cast<uint32_t>(internal_id & 0xFFFFFFFF),
+            static_cast<uint32_t>((internal_id & ~k_bone_flag) >> 32)
+        };
+    }
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+ui::pane::skeleton_tree_model::skeleton_tree_model(QObject* parent) :
+        QAbstractItemModel(parent),
+        project_(nullptr),
+        is_inserting_bone_(false) {
+}
+
+void ui::pane::skeleton_tree_model::init(mdl::project& proj) {
+    project_ = &proj;
+    connect(project_, &mdl::project::pre_new_bone_added,
+        this, &skeleton_tree_model::handle_pre_new_bone_added);
+    connect(project_, &mdl::project::new_bone_added,
+        this, &skeleton_tree_model::handle_new_bone_added);
+    connect(project_, &mdl::project::new_skeleton_added,
+        this, &skeleton_tree_model::handle_new_skeleton_added);
+    connect(project_, &mdl::project::name_changed,
+        this, &skeleton_tree_model::handle_name_changed);
+    connect(project_, &mdl::project::skeletons_changed,
+        this, &skeleton_tree_model::handle_skeletons_changed);
+    connect(project_, &mdl::project::new_project_opened,
+        this, &skeleton_tree_model::reset);
+    reset();
+}
+
+void ui::pane::skeleton_tree_model::reset() {
+    beginResetModel();
+    skeletons_ = world().skeletons() |
+        rv::transform(
+            [](auto skel)->sm::piece_id {
+                return skel->id();
+            }
+        ) | r::to<std::vector<sm::piece_id>>();
+    index_skeleton_rows();
+    endResetModel();
+}
+
+sm::world& ui::pane::skeleton_tree_model::world() const {
+    return project_->world();
+}
+
+sm::skeleton* ui::pane::skeleton_tree_model::skeleton_from_row(int row) const {
+    if (row < 0 || row >= static_cast<int>(skeletons_.size())) {
+        return nullptr;
+    }
+    return world().from_id<sm::skeleton>(skeletons_[row]);
+}
+
+int ui::pane::skeleton_tree_model::row_of(sm::piece_id skel_id) const {
+    auto iter = skeleton_rows_.find(skel_id.index);
+    if (iter == skeleton_rows_.end() || skeletons_[iter->second] != skel_id) {
+        return -1;
+    }
+    return iter->second;
+}
+
+int ui::pane::skeleton_tree_model::row_of(const sm::skeleton& skel) const {
+    return row_of(skel.id());
+}
+
+int ui::pane::skeleton_tree_model::row_of(const sm::bone& bone) const {
+    auto siblings = bone.parent_node().child_bones();
+    auto iter = r::find_if(siblings,
+        [&bone](sm::const_bone_ref sib) {
+            return &sib.get() == &bone;
+        }
+    );
+    return static_cast<int>(iter - siblings.begin());
+}
+
+// rows before the given one keep their places, so only those from it on are reindexed.
+
+void ui::pane::skeleton_tree_model::index_skeleton_rows(int from) {
+    if (from == 0) {
+        skeleton_rows_.clear();
+    }
+    for (int row = from; row < static_cast<int>(skeletons_.size()); ++row) {
+        skeleton_rows_[skeletons_[row].index] = row;
+    }
+}
+
+void ui::pane::skeleton_tree_model::remove_skeleton_row(int row) {
+    beginRemoveRows({}, row, row);
+    skeleton_rows_.erase(skeletons_[row].index);
+    skeletons_.erase(skeletons_.begin() + row);
+    index_skeleton_rows(row);
+    endRemoveRows();
+}
+
+void ui::pane::skeleton_tree_model::insert_skeleton_row(int row, sm::piece_id skel_id) {
+    beginInsertRows({}, row, row);
+    skeletons_.insert(skeletons_.begin() + row, skel_id);
+    index_skeleton_rows(row);
+    endInsertRows();
+}
+
+// the merged skeleton keeps u's skeleton, so v's goes away before the bone is created. The
+// bone will be u's last child bone, so its row, with v's bones below it, is announced here
+// and finished once the bone exists.
+
+void ui::pane::skeleton_tree_model::handle_pre_new_bone_added(sm::node& u, sm::node& v) {
+    auto row = row_of(v.owner());
+    if (row >= 0) {
+        remove_skeleton_row(row);
+    }
+
+    auto parent_bone = u.parent_bone();
+    auto parent = (parent_bone) ? index_of(parent_bone->get()) : index_of(u.owner());
+    if (!parent.isValid()) {
+        return;
+    }
+    auto bone_row = static_cast<int>(u.child_bones().size());
+    beginInsertRows(parent, bone_row, bone_row);
+    is_inserting_bone_ = true;
+}
+
+void ui::pane::skeleton_tree_model::handle_new_bone_added(sm::bone& bone) {
+    if (is_inserting_bone_) {
+        is_inserting_bone_ = false;
+        endInsertRows();
+    }
+}
+
+void ui::pane::skeleton_tree_model::handle_new_skeleton_added(
+        const std::string& canvas, sm::skel_ref skel) {
+    if (row_of(skel.get()) >= 0) {
+        return;
+    }
+    auto row = static_cast<int>(skeletons_.size());
+    beginInsertRows({}, row, row);
+    skeletons_.push_back(skel->id());
+    skeleton_rows_[skel->id().index] = row;
+    endInsertRows();
+}
+
+// deleted skeletons lose their rows and new ones are appended. A restructured skeleton is
+// removed and inserted again in place, which drops whatever rows the view had below it.
+
+void ui::pane::skeleton_tree_model::handle_skeletons_changed(const std::string& canvas,
+        const mdl::skeleton_changes& changes) {
+    for (auto skel_id : changes.removed) {
+        if (auto row = row_of(skel_id); row >= 0) {
+            remove_skeleton_row(row);
+        }
+    }
+    for (auto skel_id : changes.changed) {
+        auto row = row_of(skel_id);
+        if (row < 0) {
+            continue;
+        }
+        remove_skeleton_row(row);
+        if (world().from_id<sm::skeleton>(skel_id)) {
+            insert_skeleton_row(row, skel_id);
+        }
+    }
+    for (auto skel_id : changes.added) {
+        if (row_of(skel_id) < 0 && world().from_id<sm::skeleton>(skel_id)) {
+            insert_skeleton_row(static_cast<int>(skeletons_.size()), skel_id);
+        }
+    }
+}
+
+void ui::pane::skeleton_tree_model::handle_name_changed(
+        mdl::skel_piece piece, const std::string& new_name) {
+    auto index = std::visit(
+        overload{
+            [](sm::node_ref)->QModelIndex { return {}; },
+            [this](auto ref)->QModelIndex { return index_of(ref.get()); }
+        },
+        piece
+    );
+    if (index.isValid()) {
+        emit dataChanged(index, index, { Qt::DisplayRole, Qt::EditRole });
+    }
+}
+
+QModelIndex ui::pane::skeleton_tree_model::index_of(const sm::skeleton& skel) const {
+    auto row = row_of(skel);
+    return (row >= 0) ? createIndex(row, 0, to_internal_id(skel.id(), false)) : QModelIndex();
+}
+
+QModelIndex ui::pane::skeleton_tree_model::index_of(const sm::bone& bone) const {
+    if (row_of(bone.owner()) < 0) {
+        return {};
+    }
+    return createIndex(row_of(bone), 0, to_internal_id(bone.id(), true));
+}
+
+sm::skeleton* ui::pane::skeleton_tree_model::skeleton_at(const QModelIndex& index) const {
+    if (!index.isValid() || is_bone_id(index.internalId())) {
+        return nullptr;
+    }
+    return world().from_id<sm::skeleton>(to_piece_id(index.internalId()));
+}
+
+sm::bone* ui::pane::skeleton_tree_model::bone_at(const QModelIndex& index) const {
+    if (!index.isValid() || !is_bone_id(index.internalId())) {
+        return nullptr;
+    }
+    return world().from_id<sm::bone>(to_piece_id(index.internalId()));
+}
+
+QModelIndex ui::pane::skeleton_tree_model::index(
+        int row, int column, const QModelIndex& parent) const {
+    if (row < 0 || column != 0) {
+        return {};
+    }
+    if (!parent.isValid()) {
+        auto* skel = skeleton_from_row(row);
+        return (skel) ? createIndex(row, 0, to_internal_id(skel->id(), false)) : QModelIndex();
+    }
+    std::vector<sm::bone_ref> children;
+    if (auto* bone = bone_at(parent); bone) {
+        children = bone->child_bones();
+    } else if (auto* skel = skeleton_at(parent); skel) {
+        children = skel->root_node().child_bones();
+    }
+    if (row >= static_cast<int>(children.size())) {
+        return {};
+    }
+    return createIndex(row, 0, to_internal_id(children[row]->id(), true));
+}
+
+QModelIndex ui::pane::skeleton_tree_model::parent(const QModelIndex& index) const {
+    auto* bone = bone_at(index);
+    if (!bone) {
+        return {};
+    }
+    auto parent_bone = bone->parent_bone();
+    return (parent_bone) ? index_of(parent_bone->get()) : index_of(bone->owner());
+}
+
+int ui::pane::skeleton_tree_model::rowCount(const QModelIndex& parent) const {
+    if (!parent.isValid()) {
+        return static_cast<int>(skeletons_.size());
+    }
+    if (parent.column() != 0) {
+        return 0;
+    }
+    if (auto* bone = bone_at(parent); bone) {
+        return static_cast<int>(bone->child_bones().size());
+    }
+    if (auto* skel = skeleton_at(parent); skel) {
+        return static_cast<int>(skel->root_node().child_bones().size());
+    }
+    return 0;
+}
+
+int ui::pane::skeleton_tree_model::columnCount(const QModelIndex& parent) const {
+    return 1;
+}
+
+QVariant ui::pane::skeleton_tree_model::data(const QModelIndex& index, int role) const {
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return {};
+    }
+    if (auto* bone = bone_at(index); bone) {
+        return QString::fromStdString(bone->name());
+    }
+    if (auto* skel = skeleton_at(index); skel) {
+        return QString::fromStdString(skel->name());
+    }
+    return {};
+}
+
+// renaming through the project emits name_changed, which is what updates the view.
+
+bool ui::pane::skeleton_tree_model::setData(
+        const QModelIndex& index, const QVariant& value, int role) {
+    if (role != Qt::EditRole) {
+        return false;
+    }
+    auto new_name = value.toString().toStdString();
+    if (auto* bone = bone_at(index); bone) {
+        return project_->rename(sm::ref(*bone), new_name);
+    }
+    if (auto* skel = skeleton_at(index); skel) {
+        return project_->rename(sm::ref(*skel), new_name);
+    }
+    return false;
+}
+
+Qt::ItemFlags ui::pane::skeleton_tree_model::flags(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include "../../core/sm_types.h"
+#include "../../core/sm_slots.h"
+#include "../../model/project.h"
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace ui {
+
+    namespace pane {
+
+        // the skeleton pane's tree of skeletons and their bones, exposed straight from the
+        // project's world. Nothing is built ahead of time: an index carries the id of the
+        // piece it stands for and rows are found by asking the world, so the tree view only
+        // ever touches the rows it shows. The model follows the project's change
+        // notifications with row insertions, removals, and data changes, and only resets when
+        // a project is opened. A skeleton whose bones were removed or restored is removed and
+        // inserted again as a whole.
+
+        class skeleton_tree_model : public QAbstractItemModel {
+
+            Q_OBJECT
+
+            mdl::project* project_;
+            std::vector<sm::piece_id> skeletons_;
+            std::unordered_map<uint32_t, int> skeleton_rows_;
+            bool is_inserting_bone_;
+
+            sm::world& world() const;
+            sm::skeleton* skeleton_from_row(int row) const;
+            int row_of(sm::piece_id skel_id) const;
+            int row_of(const sm::skeleton& skel) const;
+            int row_of(const sm::bone& bone) const;
+            void index_skeleton_rows(int from = 0);
+            void remove_skeleton_row(int row);
+            void insert_skeleton_row(int row, sm::piece_id skel_id);
+
+            void handle_pre_new_bone_added(sm::node& u, sm::node& v);
+            void handle_new_bone_added(sm::bone& bone);
+            void handle_new_skeleton_added(const std::string& canvas, sm::skel_ref skel);
+            void handle_name_changed(mdl::skel_piece piece, const std::string& new_name);
+            void handle_skeletons_changed(const std::string& canvas,
+                const mdl::skeleton_changes& changes);
+
+        public:
+
+            skeleton_tree_model(QObject* parent = nullptr);
+            void init(mdl::project& proj);
+            void reset();
+
+            QModelIndex index_of(const sm::skeleton& skel) const;
+            QModelIndex index_of(const sm::bone& bone) const;
+            sm::skeleton* skeleton_at(const QModelIndex& index) const;
+            sm::bone* bone_at(const QModelIndex& index) const;
+
+            QModelIndex index(int row, int column,
+                const QModelIndex& parent = QModelIndex()) const override;
+            QModelIndex parent(const QModelIndex& index) const override;
+            int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+            int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+            QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+            bool setData(const QModelIndex& index, const QVariant& value,
+                int role = Qt::EditRole) override;
+            Qt::ItemFlags flags(const QModelIndex& index) const override;
+        };
+
+    }
+}
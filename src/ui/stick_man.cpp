@@ -30,6 +30,14 @@ namespace rv = std::ranges::views;
 
 namespace {
 
+    constexpr int k_autosave_interval_msecs = 30000;
+
+    std::string autosave_directory() {
+        auto dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+        QDir().mkpath(dir);
+        return dir.toStdString();
+    }
+
     void to_do(const std::string& msg) {
         QMessageBox msgBox;
         msgBox.setWindowTitle("TODO");
@@ -57,7 +65,8 @@ ui::stick_man::stick_man(QWidget* parent) :
 		tool_pal_(new pane::tools(this)),
 		anim_pane_(new pane::animation(this)),
 		tool_pane_(new pane::tool_settings(this)),
-		skel_pane_(new pane::skeleton(this)) {
+		skel_pane_(new pane::skeleton(this)),
+        autosaver_(project_, autosave_directory(), k_autosave_interval_msecs) {
     setDarkTitleBar(winId());
 
     setDockNestingEnabled(true);
@@ -72,6 +81,43 @@ ui::stick_man::stick_man(QWidget* parent) :
 	skel_pane_->init(*canvases_, project_);
 	tool_mgr_.init(*canvases_, project_);
     tool_pane_->init(tool_mgr_);
+    connect(canvases_, &canvas::manager::playback_progress, this,
+        [this](canvas::scene& canv, uint64_t ticks, uint64_t dropped, uint64_t late) {
+            statusBar()->showMessage(
+                QString::fromStdString(canv.tab_name()) + ": " +
+                QString::number(ticks) + " frames played, " +
+                QString::number(dropped) + " dropped, " +
+                QString::number(late) + " late"
+            );
+        }
+    );
+
+    if (autosaver_.has_recovery_data()) {
+        offer_recovery();
+    }
+    autosaver_.start();
+    connect(qApp, &QCoreApplication::aboutToQuit, 
+        [this]() {
+            autosaver_.discard();
+        }
+    );
+}
+
+void ui::stick_man::offer_recovery() {
+    auto response = QMessageBox::question(
+        this, "Recover", 
+        "stick man did not shut down cleanly. Do you want to recover your unsaved work?",
+        QMessageBox::Yes | QMessageBox::No
+    );
+    if (response != QMessageBox::Yes) {
+        autosaver_.discard();
+        return;
+    }
+    if (!autosaver_.recover()) {
+        QMessageBox::warning(this, "Recover",
+            "Your unsaved work could not be recovered. The autosave data has been kept in " +
+            QString::fromStdString(autosaver_.unrecovered_path()) + ".");
+    }
 }
 
 void ui::stick_man::open()
@@ -303,6 +349,18 @@ void ui::stick_man::insert_view_menu() {
             zoom_tool->do_zoom(scale);
         });
     }
+
+    // draws each skeleton in a single paint call; much faster on canvases with many bones.
+    QAction* batched_action = new QAction(tr("Batched skeleton rendering"), this);
+    batched_action->setCheckable(true);
+    view_menu->addAction(batched_action);
+    connect(batched_action, &QAction::toggled, this, 
+        [this](bool checked) {
+            canvases().set_render_mode(
+                checked ? canvas::render_mode::batched : canvas::render_mode::items
+            );
+        }
+    );
 }
 
 void ui::stick_man::insert_project_menu() {
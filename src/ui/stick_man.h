@@ -4,6 +4,7 @@
 #include "canvas/scene.h"
 #include "tools/tool_manager.h"
 #include "../model/project.h"
+#include "../model/autosave.h"
 
 /*------------------------------------------------------------------------------------------------*/
 
@@ -51,6 +52,7 @@ namespace ui {
 		void showEvent(QShowEvent* event) override;
 		void resizeEvent(QResizeEvent* event) override;
         void update_undo_and_redo(bool can_redo, bool can_undo);
+        void offer_recovery();
 
         tool::manager tool_mgr_;
         pane::tools* tool_pal_;
@@ -59,6 +61,7 @@ namespace ui {
 		pane::skeleton * skel_pane_;
         canvas::manager* canvases_;
         mdl::project project_;
+        mdl::autosaver autosaver_;
 		bool was_shown_;
 		bool has_fully_layed_out_widgets_;
         QAction* undo_action_;
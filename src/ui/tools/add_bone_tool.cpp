@@ -3,6 +3,16 @@
 
 /*------------------------------------------------------------------------------------------------*/
 
+namespace {
+
+    // how far, in screen pixels, from a node a bone's endpoint can be dropped and still
+    // attach to it.
+
+    constexpr auto k_snap_distance = 2.0 * ui::canvas::k_node_radius;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
 void ui::tool::add_bone::init_rubber_band(canvas::scene& c) {
     if (!rubber_band_) {
         c.addItem(rubber_band_ = new QGraphicsLineItem());
@@ -39,8 +49,9 @@ void ui::tool::add_bone::mouseMoveEvent(canvas::scene& c, QGraphicsSceneMouseEve
 void ui::tool::add_bone::mouseReleaseEvent(canvas::scene& canv, QGraphicsSceneMouseEvent* event) {
     rubber_band_->hide();
     auto pt = event->scenePos();
-    auto parent_node = canv.top_node(origin_);
-    auto child_node = canv.top_node(event->scenePos());
+    auto snap_distance = k_snap_distance / canv.scale();
+    auto parent_node = canv.nearest_node(origin_, snap_distance);
+    auto child_node = canv.nearest_node(event->scenePos(), snap_distance);
 
     if (!parent_node || !child_node || parent_node == child_node) {
         return;
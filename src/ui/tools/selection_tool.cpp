@@ -63,6 +63,17 @@ namespace {
             ) | r::to<std::vector>();
     }
 
+    // a drag only moves the skeletons being dragged so only their items need to be synced.
+    void sync_skeletons_to_model(ui::canvas::scene& canv, const std::vector<sm::skel_ref>& skels) {
+        std::vector<sm::node*> nodes;
+        for (auto skel : skels) {
+            for (auto node : skel->nodes()) {
+                nodes.push_back(node.ptr());
+            }
+        }
+        canv.sync_to_model(nodes, {});
+    }
+
     sm::maybe_bone_ref find_bone_from_u_to_v(sm::node_ref u, sm::node_ref v) {
         auto adj = u->adjacent_bones();
         auto i = r::find_if(
@@ -85,19 +96,19 @@ namespace {
         return -1;
     }
 
-    std::unordered_set<sm::node*> all_pinned_nodes(sm::node& start) {
-        using namespace ui::canvas;
+    std::unordered_set<sm::node*> all_pinned_nodes(
+            const ui::canvas::scene& canv, sm::node& start) {
         std::unordered_set<sm::node*> pinned;
         sm::visit_nodes_and_bones(
             start,
-            [&pinned](sm::node& n)->sm::visit_result {
-                if (item_from_model<item::node>(n).is_pinned()) {
+            [&](sm::node& n)->sm::visit_result {
+                if (canv.item_of(n)->is_pinned()) {
                     pinned.insert(&n);
                 }
                 return sm::visit_result::continue_traversal;
             },
-            [&pinned](sm::bone& b)->sm::visit_result {
-                if (item_from_model<item::bone>(b).is_selected()) {
+            [&](sm::bone& b)->sm::visit_result {
+                if (canv.item_of(b)->is_selected()) {
                     pinned.insert(&b.parent_node());
                     pinned.insert(&b.child_node());
                 }
@@ -107,7 +118,7 @@ namespace {
         return pinned;
     }
 
-    bool has_pinned_nodes(mdl::skel_piece piece) {
+    bool has_pinned_nodes(const ui::canvas::scene& canv, mdl::skel_piece piece) {
         sm::node_ref start = std::visit(
             overload{
                 [](sm::node_ref node)->sm::node_ref {return node; },
@@ -119,7 +130,7 @@ namespace {
         bool found = false;
         sm::visit_nodes( start.get(), 
             [&](sm::node& node)->sm::visit_result {
-                if (ui::canvas::item_from_model<ui::canvas::item::node>(node).is_pinned()) {
+                if (canv.item_of(node)->is_pinned()) {
                     found = true;
                     return sm::visit_result::terminate_traversal;
                 }
@@ -130,8 +141,9 @@ namespace {
         return found;
     }
 
-    std::tuple<sm::maybe_node_ref, int> find_closest_pinned_node(sm::node_ref start) {
-        auto pinned_nodes = all_pinned_nodes(start.get());
+    std::tuple<sm::maybe_node_ref, int> find_closest_pinned_node(
+            const ui::canvas::scene& canv, sm::node_ref start) {
+        auto pinned_nodes = all_pinned_nodes(canv, start.get());
         std::unordered_map<sm::node*, int> visited;
         std::unordered_set<sm::node*> candidates;
         sm::visit_nodes_and_bones(
@@ -169,11 +181,12 @@ namespace {
     }
 
     using node_pair = std::tuple<sm::node_ref, sm::node_ref>;
-    std::optional<node_pair> rot_info_for_rotate_on_pin(const mdl::skel_piece& model) {
+    std::optional<node_pair> rot_info_for_rotate_on_pin(
+            const ui::canvas::scene& canv, const mdl::skel_piece& model) {
         return std::visit(
             overload{
-                [](sm::node_ref node)->std::optional<node_pair> {
-                    auto [closest, dist] = find_closest_pinned_node(node);
+                [&canv](sm::node_ref node)->std::optional<node_pair> {
+                    auto [closest, dist] = find_closest_pinned_node(canv, node);
                     if (!closest) {
                         return {};
                     }
@@ -182,19 +195,15 @@ namespace {
                         node
                     }};
                 },
-                [](sm::bone_ref bone)->std::optional<node_pair> {
-                    using namespace ui::canvas;
-
+                [&canv](sm::bone_ref bone)->std::optional<node_pair> {
                     auto& u = bone->parent_node();
                     auto& v = bone->child_node();
-                    auto& item_u = item_from_model<item::node>(u);
-                    auto& item_v = item_from_model<item::node>(v);
 
-                    if (item_u.is_pinned() && item_v.is_pinned()) {
+                    if (canv.item_of(u)->is_pinned() && canv.item_of(v)->is_pinned()) {
                         return { {u, v} };
                     }
-                    auto [closest_to_u, u_dist] = find_closest_pinned_node(u);
-                    auto [closest_to_v, v_dist] = find_closest_pinned_node(v);
+                    auto [closest_to_u, u_dist] = find_closest_pinned_node(canv, u);
+                    auto [closest_to_v, v_dist] = find_closest_pinned_node(canv, v);
                     if (!closest_to_u && !closest_to_v) {
                         return {};
                     }
@@ -641,7 +650,7 @@ std::optional<ui::tool::rotation_state> ui::tool::select::create_rotation_state(
 
     auto model = item->to_skeleton_piece();
 
-    if (!settings.rotate_on_pinned_ || !has_pinned_nodes(model)) {
+    if (!settings.rotate_on_pinned_ || !has_pinned_nodes(canv, model)) {
         auto parent_bone = std::visit(
             overload{
                 [](sm::node_ref node)->sm::maybe_bone_ref {
@@ -667,7 +676,7 @@ std::optional<ui::tool::rotation_state> ui::tool::select::create_rotation_state(
             settings.rotate_mode_
         );
     } else {
-        auto nodes = rot_info_for_rotate_on_pin(model);
+        auto nodes = rot_info_for_rotate_on_pin(canv, model);
         if (!nodes) {
             return {};
         }
@@ -768,7 +777,7 @@ void ui::tool::select::handle_rotation(canvas::scene& c, QPointF pt, rotation_st
             do_ragdoll_rotate(theta, ri);
             break;
     }
-    c.sync_to_model();
+    sync_skeletons_to_model(c, { ri.bone().owner() });
 }
 
 void ui::tool::select::handle_translation(canvas::scene& c, QPointF pt, translation_state& state) {
@@ -797,12 +806,12 @@ void ui::tool::select::handle_translation(canvas::scene& c, QPointF pt, translat
                     skel, 
                     delta, 
                     state.moving,
-                    all_pinned_nodes(skel->root_node())
+                    all_pinned_nodes(c, skel->root_node())
                 );
             }
             break;
     }
-    c.sync_to_model();
+    sync_skeletons_to_model(c, active_skeletons);
 }
 
 void ui::tool::select::handle_click(
@@ -878,10 +887,8 @@ void ui::tool::select::handle_select_drag(canvas::scene& canv, QRectF rect, bool
 
 	auto maybe_skeleton = as_skeleton(just_nodes_and_bones(clicked_items));
 	if (maybe_skeleton) {
-		ui::canvas::item::skeleton* skel_item = nullptr;
-		if (maybe_skeleton->get().get_user_data().has_value()) {
-			skel_item = &(canvas::item_from_model<canvas::item::skeleton>(maybe_skeleton->get()));
-		} else {
+		auto* skel_item = canv.item_of(maybe_skeleton->get());
+		if (!skel_item) {
 			skel_item = canv.insert_item(maybe_skeleton->get());
 		}
 		canv.set_selection(skel_item, true);
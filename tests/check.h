@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+#include <source_location>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace test {
+
+    inline int failures = 0;
+
+    // reports a failed check with where it was made; a test's exit code is the number of
+    // checks that failed.
+
+    inline bool check(bool condition, std::string_view what,
+            std::source_location loc = std::source_location::current()) {
+        if (!condition) {
+            std::fprintf(stderr, "%s:%u: check failed: %.*s\n", loc.file_name(),
+                static_cast<unsigned>(loc.line()), static_cast<int>(what.size()), what.data());
+            ++failures;
+        }
+        return condition;
+    }
+
+    inline int result() {
+        if (failures == 0) {
+            std::printf("all checks passed\n");
+        }
+        return failures;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/sm_skeleton.h"
+#include "core/sm_bone.h"
+#include <random>
+#include <vector>
+
+/*------------------------------------------------------------------------------------------------*/
+
+// random skeletons shared by the tests and the benchmarks.
+
+namespace test {
+
+    // a random tree of bones about ten units long rooted at the given point, each bone hung
+    // from a node already in the tree. Returns the new bones in the order created.
+
+    inline std::vector<sm::bone*> random_tree(sm::world& world, sm::point root_pt,
+            int bone_count, std::mt19937& rng) {
+        auto& root = world.create_skeleton(root_pt);
+        std::vector<sm::node*> nodes{ &root.root_node() };
+        std::vector<sm::bone*> bones;
+        for (int i = 0; i < bone_count; ++i) {
+            auto* parent = nodes[rng() % nodes.size()];
+            auto& tip = world.create_skeleton(
+                parent->world_x() + 10.0,
+                parent->world_y() + static_cast<int>(rng() % 11) - 5
+            );
+            auto bone = world.create_bone({}, *parent, tip.root_node());
+            bones.push_back(&bone->get());
+            nodes.push_back(&bone->get().child_node());
+        }
+        return bones;
+    }
+
+    // a world holding a single random tree rooted at the origin.
+
+    struct rig {
+        sm::world world;
+        std::vector<sm::bone*> bones;
+        sm::skeleton* skel = nullptr;
+
+        rig(int bone_count, std::mt19937& rng) :
+                bones(random_tree(world, { 0.0, 0.0 }, bone_count, rng)),
+                skel(&bones.front()->owner()) {
+        }
+    };
+}
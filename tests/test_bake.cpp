@@ -0,0 +1,124 @@
+#include "check.h"
+#include "rig.h"
+#include "core/sm_skeleton.h"
+#include "core/sm_bone.h"
+#include "core/sm_bake.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_duration = 600;
+
+    // float rounding of stored values and of the decoder's arithmetic, on coordinates of a
+    // few hundred units.
+    constexpr double k_slack = 1.0e-3;
+
+    // the skeleton drifting for the whole timeline while random bones swing about their
+    // parent nodes, which changes angles but never bone lengths. Every event lasts at least
+    // a tick, so that poses between ticks are interpolated by both representations rather
+    // than jumping at a tick in one and between two ticks in the other.
+
+    sm::animation random_animation(const test::rig& r, std::mt19937& rng) {
+        sm::animation anim("bake");
+        anim.insert(0, sm::translation{ r.skel->root_node().name(), { 120.0, -40.0 },
+            k_duration });
+        for (int t = 0; t < k_duration; t += 3) {
+            const auto& bone = *r.bones[rng() % r.bones.size()];
+            auto theta = (static_cast<int>(rng() % 200) - 100) / 100.0;
+            anim.insert(t, sm::rotation{ bone.parent_node().name(), bone.name(), theta,
+                1 + static_cast<int>(rng() % 60) });
+        }
+        return anim;
+    }
+
+    // how far each node of a baked pose may be from the compiled one. The root may be off
+    // by the distance tolerance on each axis. Below it every angle channel adds the angle
+    // tolerance to the error in the direction of each bone, which the bone's length turns
+    // into a distance, and every length channel adds the distance tolerance.
+
+    std::vector<double> error_bounds(const sm::compiled_animation& anim,
+            const sm::bake_options& opts) {
+        auto parents = anim.node_parents();
+        auto rest = anim.rest_pose();
+        std::vector<double> angle_error(parents.size(), 0.0);
+        std::vector<double> bounds(parents.size(), std::sqrt(2.0) * opts.distance_tolerance);
+        for (size_t i = 1; i < parents.size(); ++i) {
+            auto parent = parents[i];
+            auto length = std::hypot(rest[i].x - rest[parent].x, rest[i].y - rest[parent].y);
+            angle_error[i] = angle_error[parent] + opts.angle_tolerance;
+            bounds[i] = bounds[parent] + opts.distance_tolerance + length * angle_error[i];
+        }
+        for (auto& bound : bounds) {
+            bound += k_slack;
+        }
+        return bounds;
+    }
+
+    // the largest amount by which any node of a decoded pose strays past its bound, or
+    // zero, over the given times.
+
+    double worst_excess(const sm::compiled_animation& anim, const sm::baked_animation& baked,
+            const std::vector<double>& bounds, const std::vector<double>& times) {
+        sm::baked_animation::decoder decoder(baked);
+        std::vector<sm::point> expected;
+        std::vector<sm::point> decoded;
+        double excess = 0.0;
+        for (auto t : times) {
+            anim.evaluate(t, expected);
+            decoder.evaluate(t, decoded);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                auto dist = std::hypot(expected[i].x - decoded[i].x,
+                    expected[i].y - decoded[i].y);
+                excess = std::max(excess, dist - bounds[i]);
+            }
+        }
+        return excess;
+    }
+
+    // bakes with and without quantization, then decodes every tick and every half tick,
+    // first in order and then shuffled so that the decoder seeks.
+
+    void test_error_bounds() {
+        std::mt19937 rng(50);
+        test::rig r(60, rng);
+        auto anim = random_animation(r, rng);
+        auto compiled = sm::compiled_animation::compile(anim, *r.skel);
+        if (!test::check(compiled.has_value(), "error bounds: the animation compiles")) {
+            return;
+        }
+
+        std::vector<double> times(2 * k_duration + 1);
+        std::iota(times.begin(), times.end(), 0.0);
+        for (auto& t : times) {
+            t /= 2.0;
+        }
+        auto shuffled = times;
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+        for (bool quantize : { true, false }) {
+            sm::bake_options opts{ .quantize = quantize, .seek_interval = 64 };
+            auto baked = sm::baked_animation::bake(*compiled, opts);
+            auto bounds = error_bounds(*compiled, opts);
+            auto what = std::string(quantize ? "quantized" : "floats");
+
+            test::check(baked.key_count() < baked.channels().size() * (k_duration + 1) / 4,
+                what + ": baking drops most samples");
+            test::check(worst_excess(*compiled, baked, bounds, times) <= 0.0,
+                what + ": poses played in order are within the tolerances");
+            test::check(worst_excess(*compiled, baked, bounds, shuffled) <= 0.0,
+                what + ": poses seeked to are within the tolerances");
+        }
+    }
+}
+
+int main() {
+    test_error_bounds();
+    return test::result();
+}
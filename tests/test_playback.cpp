@@ -0,0 +1,148 @@
+#include "check.h"
+#include "rig.h"
+#include "core/sm_skeleton.h"
+#include "core/sm_bone.h"
+#include "core/sm_playback.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_duration = 1000;
+    constexpr int k_interval = 100;
+    constexpr int k_events_per_tick = 3;
+    constexpr int k_max_short_duration = 20;
+
+    // checkpointing so coarse that every pose is replayed from the rest pose.
+    const sm::checkpoint_options k_no_checkpoints{
+        std::numeric_limits<int>::max(), std::numeric_limits<size_t>::max()
+    };
+
+    double max_distance(const std::vector<sm::point>& lhs, const std::vector<sm::point>& rhs) {
+        double dist = 0.0;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            dist = std::max(dist, std::hypot(lhs[i].x - rhs[i].x, lhs[i].y - rhs[i].y));
+        }
+        return dist;
+    }
+
+    sm::rotation short_rotation(const sm::bone& bone, bool about_child, std::mt19937& rng) {
+        const auto& axis = (about_child) ? bone.child_node() : bone.parent_node();
+        return { axis.name(), bone.name(), 0.01, static_cast<int>(rng() % k_max_short_duration) };
+    }
+
+    // evaluates every few ticks, and between ticks, with and without checkpoints.
+
+    double max_checkpoint_error(const sm::animation& anim, const sm::skeleton& skel) {
+        auto checkpointed = sm::compiled_animation::compile(anim, skel, { k_interval });
+        auto replayed = sm::compiled_animation::compile(anim, skel, k_no_checkpoints);
+        double error = 0.0;
+        for (double t = -5.0; t < k_duration + 50; t += 9.75) {
+            error = std::max(error, max_distance(checkpointed->evaluate(t), replayed->evaluate(t)));
+        }
+        return error;
+    }
+
+    // a translation of the whole skeleton and a rotation of one branch run the length of the
+    // timeline while short rotations about parent nodes come and go. The short rotations
+    // commute with both long events, so the long events must not hold back what a seek
+    // replays.
+
+    void test_long_events() {
+        std::mt19937 rng(7);
+        test::rig r(60, rng);
+        const auto& root_bone = r.skel->root_node().child_bones().front().get();
+
+        sm::animation anim("long events");
+        anim.insert(0, sm::translation{ r.skel->root_node().name(), { 50.0, -20.0 }, k_duration });
+        anim.insert(0, sm::rotation{ root_bone.parent_node().name(), root_bone.name(), 1.0,
+            k_duration });
+        for (int t = 0; t < k_duration; ++t) {
+            for (int i = 0; i < k_events_per_tick; ++i) {
+                anim.insert(t, short_rotation(*r.bones[rng() % r.bones.size()], false, rng));
+            }
+        }
+
+        test::check(max_checkpoint_error(anim, *r.skel) < 1.0e-9,
+            "long events: checkpointed poses match a full replay");
+
+        auto compiled = sm::compiled_animation::compile(anim, *r.skel, { k_interval });
+        size_t most_replayed = 0;
+        for (double t = 0.0; t <= k_duration; t += 1.5) {
+            most_replayed = std::max(most_replayed, compiled->tracks_replayed(t));
+        }
+        size_t bound = k_events_per_tick * (k_interval + k_max_short_duration) + 2;
+        test::check(most_replayed <= bound,
+            "long events: a seek replays at most an interval's worth of tracks");
+        test::check(compiled->tracks_replayed(k_duration - 1) < compiled->tracks().size() / 5,
+            "long events: a seek near the end does not replay the timeline");
+    }
+
+    // rotations about child nodes, translations of branches, and long events all mixed,
+    // where many tracks do not commute; checkpoints must still give the replayed pose.
+
+    void test_mixed_events() {
+        std::mt19937 rng(11);
+        test::rig r(50, rng);
+
+        sm::animation anim("mixed events");
+        for (int t = 0; t < k_duration; t += 2) {
+            const auto& bone = *r.bones[rng() % r.bones.size()];
+            switch (rng() % 4) {
+                case 0:
+                    anim.insert(t, sm::translation{ bone.child_node().name(), { 0.5, 0.25 },
+                        static_cast<int>(rng() % 300) });
+                    break;
+                case 1:
+                    anim.insert(t, short_rotation(bone, true, rng));
+                    break;
+                default:
+                    anim.insert(t, sm::rotation{ bone.parent_node().name(), bone.name(), 0.02,
+                        static_cast<int>(rng() % 400) });
+                    break;
+            }
+        }
+
+        test::check(max_checkpoint_error(anim, *r.skel) < 1.0e-9,
+            "mixed events: checkpointed poses match a full replay");
+    }
+
+    // updating after an edit keeps the earlier checkpoints, which must still agree with a
+    // fresh compile of the edited animation.
+
+    void test_update() {
+        std::mt19937 rng(13);
+        test::rig r(40, rng);
+
+        sm::animation anim("edited");
+        anim.insert(0, sm::translation{ r.skel->root_node().name(), { 10.0, 10.0 }, k_duration });
+        for (int t = 0; t < k_duration; t += 3) {
+            anim.insert(t, short_rotation(*r.bones[rng() % r.bones.size()], rng() % 2, rng));
+        }
+        auto compiled = sm::compiled_animation::compile(anim, *r.skel, { k_interval });
+
+        const auto& bone = *r.bones.front();
+        anim.insert(503, sm::rotation{ bone.parent_node().name(), bone.name(), 1.0, 500 });
+        test::check(compiled->update(anim, *r.skel, 503) == sm::result::success,
+            "update: succeeds on the same skeleton");
+
+        auto fresh = sm::compiled_animation::compile(anim, *r.skel, { k_interval });
+        double error = 0.0;
+        for (double t = 0.0; t < k_duration; t += 4.5) {
+            error = std::max(error, max_distance(compiled->evaluate(t), fresh->evaluate(t)));
+        }
+        test::check(error < 1.0e-9, "update: poses match a fresh compile");
+    }
+}
+
+int main() {
+    test_long_events();
+    test_mixed_events();
+    test_update();
+    return test::result();
+}
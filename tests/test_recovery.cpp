@@ -0,0 +1,215 @@
+#include "check.h"
+#include "core/sm_skeleton.h"
+#include "core/sm_bone.h"
+#include "model/project.h"
+#include "model/journal.h"
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr auto k_tab = "tab-0";
+
+    // the project as sorted lines of text, so that two projects compare equal when they have
+    // the same tabs, skeletons, names, topology, and positions.
+
+    std::vector<std::string> describe(const mdl::project& proj) {
+        std::vector<std::string> lines;
+        for (const auto& tab : proj.tabs()) {
+            for (const auto& skel_name : proj.skel_names_on_tab(tab)) {
+                lines.push_back("tab " + tab + " " + skel_name);
+            }
+        }
+        for (auto skel : proj.world().skeletons()) {
+            auto snap = skel->snapshot();
+            auto prefix = snap.name + ": ";
+            lines.push_back(prefix + "root " + snap.node_names[snap.root]);
+            for (size_t i = 0; i < snap.num_nodes(); ++i) {
+                lines.push_back(prefix + "node " + snap.node_names[i] + " " +
+                    std::to_string(snap.node_positions[i].x) + " " +
+                    std::to_string(snap.node_positions[i].y));
+            }
+            for (size_t i = 0; i < snap.num_bones(); ++i) {
+                auto [u, v] = snap.bone_nodes[i];
+                lines.push_back(prefix + "bone " + snap.bone_names[i] + " " +
+                    snap.node_names[u] + " " + snap.node_names[v]);
+            }
+        }
+        std::ranges::sort(lines);
+        return lines;
+    }
+
+    sm::node& node_at(mdl::project& proj, sm::point pt) {
+        for (auto skel : proj.world().skeletons()) {
+            for (auto node : skel->nodes()) {
+                if (node->world_x() == pt.x && node->world_y() == pt.y) {
+                    return node.get();
+                }
+            }
+        }
+        throw std::runtime_error("no node at point");
+    }
+
+    mdl::handle handle_at(mdl::project& proj, sm::point pt) {
+        return mdl::to_handle(sm::ref(node_at(proj, pt)));
+    }
+
+    mdl::handle bone_between(mdl::project& proj, sm::point u, sm::point v) {
+        auto& parent = node_at(proj, u);
+        for (auto bone : parent.child_bones()) {
+            const auto& child = bone->child_node();
+            if (child.world_x() == v.x && child.world_y() == v.y) {
+                return mdl::to_handle(bone);
+            }
+        }
+        throw std::runtime_error("no bone between points");
+    }
+
+    std::vector<mdl::journal::entry> read_journal(const fs::path& dir) {
+        std::vector<mdl::journal::entry> entries;
+        for (const auto& segment : mdl::journal::segment_paths(dir.string())) {
+            auto segment_entries = mdl::journal::read_segment(segment);
+            std::ranges::move(segment_entries, std::back_inserter(entries));
+        }
+        return entries;
+    }
+
+    fs::path fresh_directory(const std::string& name) {
+        auto dir = fs::temp_directory_path() / name;
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        return dir;
+    }
+
+    // edits a project with a journal attached, snapshotting it partway through as the
+    // autosaver would, then recovers a second project from the snapshot and what the journal
+    // recorded after it. The edits include merges that rename clashing pieces, an undone
+    // merge, a rename, a move, a removal that splits a skeleton, and a paste and a deletion
+    // of whole skeletons that are undone and redone.
+
+    void test_replay() {
+        auto dir = fresh_directory("stick_man_test_replay");
+        mdl::project live;
+        std::string snapshot_json;
+        {
+            mdl::journal::writer journal(dir.string(), live.revision() + 1);
+            live.set_journal(&journal);
+
+            live.add_new_tab(k_tab);
+            for (double x : { 0.0, 10.0, 20.0, 30.0, 40.0 }) {
+                live.add_new_skeleton_root(k_tab, { x, 0.0 });
+            }
+            live.add_bone(k_tab, handle_at(live, { 0, 0 }), handle_at(live, { 10, 0 }));
+            snapshot_json = live.snapshot().to_json();
+
+            live.add_bone(k_tab, handle_at(live, { 10, 0 }), handle_at(live, { 20, 0 }));
+            live.add_bone(k_tab, handle_at(live, { 0, 0 }), handle_at(live, { 30, 0 }));
+            live.rename(sm::ref(node_at(live, { 30, 0 })), "hand");
+            live.transform({ handle_at(live, { 20, 0 }) },
+                [](sm::node& node) {
+                    node.set_world_pos({ 25.0, 5.0 });
+                }
+            );
+            live.undo();
+            live.redo();
+            live.add_bone(k_tab, handle_at(live, { 30, 0 }), handle_at(live, { 40, 0 }));
+            live.undo();
+            live.add_new_skeleton_root(k_tab, { 50.0, 0.0 });
+            live.add_bone(k_tab, handle_at(live, { 25, 5 }), handle_at(live, { 50, 0 }));
+            live.remove_pieces(k_tab, {}, { bone_between(live, { 0, 0 }, { 10, 0 }) });
+
+            auto pasted = node_at(live, { 40, 0 }).owner().snapshot();
+            pasted.node_positions.front() = { 60.0, 0.0 };
+            live.replace_skeletons(k_tab, {}, std::vector<sm::skeleton_snapshot>{ pasted });
+            live.replace_skeletons(k_tab, { node_at(live, { 40, 0 }).owner().name() },
+                std::vector<sm::skeleton_snapshot>{});
+            live.undo();
+            live.undo();
+            live.redo();
+            live.redo();
+            live.undo();
+
+            live.set_journal(nullptr);
+        }
+
+        mdl::project recovered;
+        test::check(recovered.recover(snapshot_json, read_journal(dir)),
+            "replay: the journal applies to the snapshot");
+        test::check(describe(recovered) == describe(live),
+            "replay: the recovered project matches the project before the crash");
+
+        fs::remove_all(dir);
+    }
+
+    // a snapshot that does not parse or a journal entry that does not apply leaves the
+    // project as it was.
+
+    void test_failed_recovery() {
+        mdl::project proj;
+        proj.add_new_tab(k_tab);
+        proj.add_new_skeleton_root(k_tab, { 0.0, 0.0 });
+        proj.add_new_skeleton_root(k_tab, { 10.0, 0.0 });
+        proj.add_bone(k_tab, handle_at(proj, { 0, 0 }), handle_at(proj, { 10, 0 }));
+        auto before = describe(proj);
+
+        test::check(!proj.recover("{ not json", {}),
+            "failed recovery: a bad snapshot is reported");
+        test::check(describe(proj) == before,
+            "failed recovery: a bad snapshot leaves the project untouched");
+
+        std::vector<mdl::journal::entry> entries{
+            { 1, mdl::journal::add_tab{ "other" } },
+            { 2, mdl::journal::rename{ mdl::journal::piece_type::node, { "missing", "root" },
+                "hand" } }
+        };
+        test::check(!proj.recover({}, entries),
+            "failed recovery: a bad journal entry is reported");
+        test::check(describe(proj) == before,
+            "failed recovery: a bad journal entry leaves the project untouched");
+        test::check(proj.can_undo(),
+            "failed recovery: the undo history is kept");
+    }
+
+    // the history's footprint is kept as a running total as commands are done, undone and
+    // redone, and the budget is applied whichever way the history moves.
+
+    void test_undo_budget() {
+        mdl::project proj;
+        proj.add_new_tab(k_tab);
+        for (double x : { 0.0, 10.0, 20.0, 30.0 }) {
+            proj.add_new_skeleton_root(k_tab, { x, 0.0 });
+        }
+        proj.add_bone(k_tab, handle_at(proj, { 0, 0 }), handle_at(proj, { 10, 0 }));
+        proj.add_bone(k_tab, handle_at(proj, { 10, 0 }), handle_at(proj, { 20, 0 }));
+        auto usage = proj.undo_memory_usage();
+        proj.undo();
+        proj.undo();
+        proj.redo();
+        proj.redo();
+        test::check(proj.undo_memory_usage() == usage,
+            "undo budget: undoing and redoing leaves the footprint as it was");
+
+        proj.undo();
+        proj.set_undo_memory_budget(1);
+        proj.redo();
+        proj.undo();
+        test::check(!proj.can_undo() && proj.can_redo(),
+            "undo budget: history past the budget is dropped on redo");
+        test::check(proj.undo_memory_usage() > 0,
+            "undo budget: the redo stack still counts against the budget");
+    }
+}
+
+int main() {
+    test_replay();
+    test_failed_recovery();
+    test_undo_budget();
+    return test::result();
+}
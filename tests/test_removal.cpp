@@ -0,0 +1,184 @@
+#include "check.h"
+#include "rig.h"
+#include "core/sm_skeleton.h"
+#include "core/sm_bone.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <ranges>
+#include <algorithm>
+
+namespace r = std::ranges;
+namespace rv = std::ranges::views;
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    constexpr int k_trials = 200;
+    constexpr int k_max_bones = 40;
+
+    std::string to_string(sm::piece_id id) {
+        return std::to_string(id.index) + ":" + std::to_string(id.generation);
+    }
+
+    // a skeleton's ids, names and topology as sorted lines, so that two skeletons compare
+    // equal regardless of the order their tables hold their pieces in.
+
+    std::vector<std::string> describe(const sm::skeleton& skel) {
+        std::vector<std::string> lines{
+            "skeleton " + to_string(skel.id()) + " " + skel.name() + " root " +
+                to_string(skel.root_node().id())
+        };
+        for (auto node : skel.nodes()) {
+            lines.push_back("node " + to_string(node->id()) + " " + node->name() + " " +
+                std::to_string(std::lround(node->world_x())) + " " +
+                std::to_string(std::lround(node->world_y())));
+        }
+        for (auto bone : skel.bones()) {
+            lines.push_back("bone " + to_string(bone->id()) + " " + bone->name() + " " +
+                to_string(bone->parent_node().id()) + " " + to_string(bone->child_node().id()));
+        }
+        r::sort(lines);
+        return lines;
+    }
+
+    std::vector<std::string> describe(const sm::world& world) {
+        std::vector<std::string> lines;
+        for (auto skel : world.skeletons()) {
+            r::copy(describe(skel.get()), std::back_inserter(lines));
+        }
+        r::sort(lines);
+        return lines;
+    }
+
+    // picks each node and each bone of the skeleton with the given probability.
+
+    std::tuple<std::vector<sm::node_ref>, std::vector<sm::bone_ref>> random_pieces(
+            sm::skeleton& skel, double probability, std::mt19937& rng) {
+        std::bernoulli_distribution pick(probability);
+        auto nodes = skel.nodes() | r::to<std::vector<sm::node_ref>>();
+        auto bones = skel.bones() | r::to<std::vector<sm::bone_ref>>();
+        std::erase_if(nodes, [&](auto) { return !pick(rng); });
+        std::erase_if(bones, [&](auto) { return !pick(rng); });
+        return { nodes, bones };
+    }
+
+    // removes the pieces, checks that they are gone, restores them and checks that the world is back the way it was. Removing them a second time from the
+    // restored world, as a redo would, must split the skeleton up under the same ids.
+
+    void check_round_trip(test::rig& r, const std::vector<sm::node_ref>& nodes,
+            const std::vector<sm::bone_ref>& bones) {
+        auto before = describe(r.world);
+        auto node_ids = nodes | rv::transform([](auto n) { return n->id(); }) |
+            r::to<std::vector>();
+        auto bone_ids = bones | rv::transform([](auto b) { return b->id(); }) |
+            r::to<std::vector>();
+
+        // a removed node stays on as an endpoint of any bone of it that survives.
+        auto is_removed = [&](auto b) { return r::find(bone_ids, b->id()) != bone_ids.end(); };
+        auto dead_node_ids = nodes |
+            rv::filter(
+                [&](auto n) {
+                    auto parent = n->parent_bone();
+                    return (!parent || is_removed(*parent)) &&
+                        r::all_of(n->child_bones(), is_removed);
+                }
+            ) |
+            rv::transform([](auto n) { return n->id(); }) |
+            r::to<std::vector>();
+
+        auto removal = r.world.remove_pieces(*r.skel, nodes, bones);
+        if (!test::check(removal.has_value(), "remove_pieces succeeds")) {
+            return;
+        }
+        test::check(
+            r::none_of(dead_node_ids, [&](auto id) { return r.world.from_id<sm::node>(id); }) &&
+            r::none_of(bone_ids, [&](auto id) { return r.world.from_id<sm::bone>(id); }),
+            "removed pieces are gone"
+        );
+        auto result = r.world.restore(*removal);
+        test::check(result == sm::result::success, "restore succeeds");
+        r.skel = r.world.from_id<sm::skeleton>(removal->skeleton);
+        if (!test::check(r.skel != nullptr, "restored skeleton keeps its id")) {
+            return;
+        }
+        test::check(describe(r.world) == before, "restore puts the world back");
+
+        // redo.
+        auto nodes_again = node_ids |
+            rv::transform([&](auto id) { return sm::ref(*r.world.from_id<sm::node>(id)); }) |
+            r::to<std::vector<sm::node_ref>>();
+        auto bones_again = bone_ids |
+            rv::transform([&](auto id) { return sm::ref(*r.world.from_id<sm::bone>(id)); }) |
+            r::to<std::vector<sm::bone_ref>>();
+        auto redone = r.world.remove_pieces(*r.skel, nodes_again, bones_again, &*removal);
+        if (!test::check(redone.has_value(), "remove_pieces succeeds again")) {
+            return;
+        }
+        test::check(redone->splits == removal->splits, "redo splits under the same ids");
+        test::check(
+            r::equal(redone->copies, removal->copies,
+                [](const auto& lhs, const auto& rhs) {
+                    return lhs.copy == rhs.copy && lhs.original == rhs.original;
+                }
+            ),
+            "redo copies nodes under the same ids"
+        );
+        test::check(r.world.restore(*redone) == sm::result::success, "restore succeeds again");
+        r.skel = r.world.from_id<sm::skeleton>(removal->skeleton);
+        test::check(describe(r.world) == before, "second restore puts the world back");
+    }
+
+    void test_random_removals() {
+        std::mt19937 rng(42);
+        for (int trial = 0; trial < k_trials; ++trial) {
+            test::rig r(1 + static_cast<int>(rng() % k_max_bones), rng);
+            auto probability = std::uniform_real_distribution<double>(0.05, 0.5)(rng);
+            auto [nodes, bones] = random_pieces(*r.skel, probability, rng);
+            check_round_trip(r, nodes, bones);
+        }
+    }
+
+    // removing a node in the middle of a branching rig leaves every child bone hanging from
+    // a copy of it, and removing the root splits the skeleton into one piece per child bone.
+
+    void test_branch_points() {
+        std::mt19937 rng(7);
+        for (int trial = 0; trial < k_trials / 10; ++trial) {
+            test::rig r(k_max_bones, rng);
+            auto branch = r::max(r.skel->nodes(), {},
+                [](auto n) { return n->child_bones().size(); });
+            check_round_trip(r, { branch }, {});
+            check_round_trip(r, { sm::ref(r.skel->root_node()) }, {});
+        }
+    }
+
+    void test_whole_skeleton() {
+        std::mt19937 rng(3);
+        test::rig r(k_max_bones, rng);
+        auto nodes = r.skel->nodes() | r::to<std::vector<sm::node_ref>>();
+        auto bones = r.skel->bones() | r::to<std::vector<sm::bone_ref>>();
+        auto before = describe(r.world);
+        auto removal = r.world.remove_pieces(*r.skel, nodes, bones);
+        if (!test::check(removal.has_value(), "removing everything succeeds")) {
+            return;
+        }
+        test::check(removal->skeleton_removed && r::empty(r.world.skeletons()),
+            "removing everything removes the skeleton");
+        test::check(r.world.restore(*removal) == sm::result::success,
+            "a removed skeleton is restored");
+        test::check(describe(r.world) == before, "a removed skeleton comes back as it was");
+    }
+
+}
+
+/*------------------------------------------------------------------------------------------------*/
+
+int main() {
+    test_random_removals();
+    test_branch_points();
+    test_whole_skeleton();
+    return test::result();
+}
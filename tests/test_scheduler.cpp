@@ -0,0 +1,159 @@
+#include "check.h"
+#include "core/sm_skeleton.h"
+#include "core/sm_bone.h"
+#include "core/sm_scheduler.h"
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <numbers>
+
+/*------------------------------------------------------------------------------------------------*/
+
+namespace {
+
+    // 32 ticks a second keeps the tick times exact in binary floating point.
+    constexpr double k_frames_per_second = 32.0;
+    constexpr double k_period = 1.0 / k_frames_per_second;
+    constexpr int k_duration = 100;
+    constexpr uint64_t k_tick_count = k_duration + 1;
+
+    // a clock in which waiting takes no real time: a wait just moves the time to its
+    // deadline, plus a stall of some number of periods if one is scheduled for that wait.
+
+    class fake_clock {
+        std::mutex mutex_;
+        double now_ = 0.0;
+        int waits_ = 0;
+        std::vector<std::pair<int, double>> stalls_;
+
+    public:
+
+        fake_clock(std::vector<std::pair<int, double>> stalls = {}) :
+                stalls_(std::move(stalls)) {
+        }
+
+        sm::playback_clock clock() {
+            return {
+                [this]() {
+                    std::lock_guard lock(mutex_);
+                    return now_;
+                },
+                [this](double t, std::stop_token) {
+                    std::lock_guard lock(mutex_);
+                    now_ = std::max(now_, t);
+                    ++waits_;
+                    for (auto [wait, periods] : stalls_) {
+                        if (wait == waits_) {
+                            now_ += periods * k_period;
+                        }
+                    }
+                }
+            };
+        }
+    };
+
+    std::shared_ptr<const sm::compiled_animation> quarter_turn(sm::world& world) {
+        auto& parent = world.create_skeleton(0, 0);
+        auto& child = world.create_skeleton(10, 0);
+        auto bone = world.create_bone({}, parent.root_node(), child.root_node());
+        auto& skel = bone->get().owner();
+
+        sm::animation anim("quarter turn");
+        anim.insert(0,
+            sm::rotation{
+                bone->get().parent_node().name(), bone->get().name(),
+                std::numbers::pi / 2.0, k_duration
+            }
+        );
+        return std::make_shared<const sm::compiled_animation>(
+            *sm::compiled_animation::compile(anim, skel)
+        );
+    }
+
+    // plays the animation to the end while taking poses on this thread, returning the
+    // ticks of the poses taken.
+
+    std::vector<uint64_t> play_to_end(sm::playback_scheduler& scheduler) {
+        std::vector<uint64_t> taken;
+        scheduler.start();
+        while (true) {
+            auto is_playing = scheduler.is_playing();
+            if (auto* frame = scheduler.take_latest(); frame) {
+                taken.push_back(frame->tick);
+            } else if (!is_playing) {
+                break;
+            }
+        }
+        return taken;
+    }
+
+    bool strictly_increasing(const std::vector<uint64_t>& ticks) {
+        return std::ranges::adjacent_find(ticks, std::greater_equal<>{}) == ticks.end();
+    }
+
+    void test_on_time() {
+        sm::world world;
+        fake_clock clock;
+        sm::playback_scheduler scheduler(
+            quarter_turn(world), { k_frames_per_second, false }, clock.clock()
+        );
+        auto taken = play_to_end(scheduler);
+
+        test::check(scheduler.ticks_played() == k_tick_count, "on time: every tick played");
+        test::check(scheduler.dropped_frames() == 0, "on time: no dropped frames");
+        test::check(scheduler.late_frames() == 0, "on time: no late frames");
+        test::check(strictly_increasing(taken), "on time: each tick taken at most once");
+        test::check(!taken.empty() && taken.back() == k_duration, "on time: last pose taken");
+        test::check(scheduler.take_latest() == nullptr, "on time: nothing left to take");
+    }
+
+    // waking 2.5 periods late leaves the tick two after the one waited for as the one due,
+    // so each stall drops two ticks without making the tick it plays late.
+
+    void test_stalled() {
+        sm::world world;
+        fake_clock clock({ {10, 2.5}, {20, 2.5}, {30, 2.5} });
+        sm::playback_scheduler scheduler(
+            quarter_turn(world), { k_frames_per_second, false }, clock.clock()
+        );
+        auto taken = play_to_end(scheduler);
+
+        test::check(scheduler.dropped_frames() == 6, "stalled: two ticks dropped per stall");
+        test::check(scheduler.ticks_played() == k_tick_count - 6, "stalled: the rest played");
+        test::check(scheduler.late_frames() == 0, "stalled: no late frames");
+        test::check(strictly_increasing(taken), "stalled: each tick taken at most once");
+    }
+
+    // poses taken after playback are the last one published, once.
+
+    void test_take_latest() {
+        sm::world world;
+        fake_clock clock;
+        sm::playback_scheduler scheduler(
+            quarter_turn(world), { k_frames_per_second, false }, clock.clock()
+        );
+        test::check(scheduler.take_latest() == nullptr, "nothing to take before playing");
+        scheduler.start();
+        while (scheduler.is_playing()) {
+            std::this_thread::yield();
+        }
+
+        auto* frame = scheduler.take_latest();
+        test::check(frame && frame->tick == k_duration, "last tick taken");
+        test::check(frame && frame->time == k_duration, "last pose is at the end");
+        test::check(frame && std::abs(frame->positions[1].y - 10.0) < 1.0e-9,
+            "last pose is the full quarter turn");
+        test::check(scheduler.take_latest() == nullptr, "the last tick is taken only once");
+    }
+}
+
+int main() {
+    test_on_time();
+    test_stalled();
+    test_take_latest();
+    return test::result();
+}